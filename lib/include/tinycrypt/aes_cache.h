@@ -0,0 +1,193 @@
+/* aes_cache.h - TinyCrypt interface to an AES-128 key schedule cache */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to an AES-128 key schedule cache.
+ *
+ *  Overview:  Applications rotating through many AES-128 keys (for example,
+ *             one key per session) otherwise expand the same keys over and
+ *             over with tc_aes128_set_encrypt_key. The key schedule cache
+ *             maps a key to its expanded encryption key schedule, so that
+ *             expansion is skipped for keys already present in the cache.
+ *
+ *             The cache never allocates memory: the application provides an
+ *             array of entries, which fixes the memory budget of the cache.
+ *             The entries are grouped in sets of TC_AES_CACHE_WAYS entries,
+ *             and a key can only be cached in the set selected by a keyed
+ *             hash (SipHash-2-4) of the key, so a lookup compares at most
+ *             TC_AES_CACHE_WAYS keys whatever the size of the cache. When a
+ *             set is full, one of its entries is replaced using the CLOCK
+ *             (second chance) policy, which approximates LRU while keeping
+ *             cache hits cheap: a hit only sets the reference flag of its
+ *             entry and never reorders the set.
+ *
+ *  Security:  Each entry holds a copy of its key and key schedule. Replaced,
+ *             evicted and erased entries are zeroized. Key comparison is done
+ *             in constant time per entry. The hash key, provided by the
+ *             application, must be secret and random (e.g. taken from a
+ *             CSPRNG): otherwise an adversary choosing the cached keys could
+ *             map them all to the same set and defeat the cache.
+ *
+ *             The cache is not synchronized and has no concurrent read
+ *             path. Every call, including a lookup that hits, modifies the
+ *             cache (a hit sets the reference flag and a miss moves the
+ *             clock hand of its set), and a miss zeroizes the replaced entry
+ *             in place with _set_secure before expanding the new key into
+ *             it. Applications sharing a cache between threads must
+ *             therefore serialize every call to the cache, hits included,
+ *             and must keep using a returned key schedule only while holding
+ *             that same serialization: a lookup in another thread may wipe
+ *             it. To encrypt outside the lock, copy the schedule into a
+ *             per-thread struct tc_aes_key_sched_struct while holding it.
+ *
+ *  Requires:  AES-128
+ *
+ *  Usage:     1) call tc_aes_cache_init to configure the cache with an array
+ *             of struct tc_aes_cache_entry_struct and a secret hash key.
+ *
+ *             2) call tc_aes_cache_lookup to get the encryption key schedule of
+ *             a key; the key is expanded and inserted on a miss.
+ *
+ *             3) call tc_aes_cache_evict to drop a key which is no longer in
+ *             use, and tc_aes_cache_erase to destroy all the cached keys.
+ */
+
+#ifndef __TC_AES_CACHE_H__
+#define __TC_AES_CACHE_H__
+
+#include <tinycrypt/aes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* number of entries per set */
+#define TC_AES_CACHE_WAYS 4
+/* size of the key of the hash selecting the set of an AES key */
+#define TC_AES_CACHE_HASH_KEY_SIZE 16
+
+/* struct tc_aes_cache_entry_struct holds one cached key schedule */
+struct tc_aes_cache_entry_struct {
+/* expanded encryption key schedule */
+	struct tc_aes_key_sched_struct sched;
+/* the key the schedule was expanded from */
+	uint8_t key[TC_AES_KEY_SIZE];
+/* nonzero if the entry holds a key */
+	uint8_t valid;
+/* nonzero if the entry was used since the clock hand last passed it */
+	uint8_t referenced;
+/* clock hand of the set, only used in the first entry of each set */
+	uint8_t hand;
+};
+
+/* struct tc_aes_cache_struct represents the state of a key schedule cache */
+typedef struct tc_aes_cache_struct {
+/* entries provided by the application */
+	struct tc_aes_cache_entry_struct *entries;
+/* number of entries */
+	unsigned int num_entries;
+/* number of entries per set */
+	unsigned int ways;
+/* number of sets */
+	unsigned int num_sets;
+/* SipHash-2-4 key selecting the set of an AES key */
+	uint64_t hash_key[2];
+} *TCAesCache_t;
+
+/**
+ *  @brief Key schedule cache initialization procedure
+ *  Configures cache to use the num_entries entries in entries, initially empty,
+ *  and to select the set of a key with a hash keyed by hash_key
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                cache == NULL or
+ *                entries == NULL or
+ *                hash_key == NULL or
+ *                num_entries == 0 or
+ *                num_entries > TC_AES_CACHE_WAYS and num_entries is not a
+ *                multiple of TC_AES_CACHE_WAYS
+ *  @note A cache of fewer than TC_AES_CACHE_WAYS entries is a single set.
+ *  @param cache IN/OUT -- the cache to initialize
+ *  @param entries IN -- array of num_entries cache entries
+ *  @param num_entries IN -- number of entries in the array
+ *  @param hash_key IN -- secret random key of TC_AES_CACHE_HASH_KEY_SIZE bytes
+ */
+int tc_aes_cache_init(TCAesCache_t cache,
+		      struct tc_aes_cache_entry_struct *entries,
+		      unsigned int num_entries, const uint8_t *hash_key);
+
+/**
+ *  @brief Key schedule cache lookup procedure
+ *  Finds the encryption key schedule of key in the set of cache selected by
+ *  the hash of key; on a miss, expands key into the entry of that set chosen by
+ *  the CLOCK policy
+ *  @return returns the encryption key schedule of key
+ *          returns NULL if:
+ *                cache == NULL or
+ *                key == NULL
+ *  @note The returned key schedule is owned by the cache: it remains valid
+ *        until the entry is replaced by a later lookup, evicted or erased.
+ *        Calls sharing a cache must be serialized, hits included (see
+ *        Security above).
+ *  @param cache IN/OUT -- the cache
+ *  @param key IN -- the AES-128 key
+ */
+TCAesKeySched_t tc_aes_cache_lookup(TCAesCache_t cache, const uint8_t *key);
+
+/**
+ *  @brief Key schedule cache eviction procedure
+ *  Removes key from cache, if present, zeroizing its entry
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                cache == NULL or
+ *                key == NULL
+ *  @param cache IN/OUT -- the cache
+ *  @param key IN -- the AES-128 key to remove
+ */
+int tc_aes_cache_evict(TCAesCache_t cache, const uint8_t *key);
+
+/**
+ *  @brief Key schedule cache erase procedure
+ *  Zeroizes all the entries of cache; the cache keeps its hash key and remains
+ *  usable
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if cache == NULL
+ *  @param cache IN/OUT -- the cache to erase
+ */
+int tc_aes_cache_erase(TCAesCache_t cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_AES_CACHE_H__ */
@@ -0,0 +1,154 @@
+/* cbc_hmac.h - TinyCrypt interface to a stitched AES-CBC + HMAC-SHA256 implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a stitched AES-CBC + HMAC-SHA256 implementation.
+ *
+ *  Overview:  Encrypt-then-MAC composition of AES-128 CBC mode and
+ *             HMAC-SHA256, as used by protocols that CBC encrypt a message
+ *             and then MAC the IV and ciphertext. Instead of running
+ *             tc_cbc_mode_encrypt and tc_hmac_update one after the other over
+ *             the whole message, tc_cbc_hmac_seal feeds each group of
+ *             ciphertext blocks into HMAC as soon as it is produced, while it
+ *             is still in cache, so the message is read and written once.
+ *
+ *             The sealed message is laid out as
+ *
+ *                   iv || ciphertext || tag
+ *
+ *             where tag = HMAC-SHA256(mac key, iv || ciphertext) is 32 bytes
+ *             long. This is exactly the output of tc_cbc_mode_encrypt
+ *             followed by the HMAC of that output.
+ *
+ *  Security:  The encryption and MAC keys must be independent. The same
+ *             requirements on the IV as for CBC mode apply (see cbc_mode.h).
+ *             tc_cbc_hmac_open verifies the tag, in constant time, before
+ *             decrypting anything, so that no plaintext of a forged message is
+ *             ever released and CBC padding oracles cannot arise.
+ *
+ *  Requires:  AES-128, AES-CBC mode, SHA-256 and HMAC-SHA256
+ *
+ *  Usage:     1) call tc_aes128_set_encrypt_key (to seal) or
+ *             tc_aes128_set_decrypt_key (to open) to set the encryption key,
+ *             and tc_hmac_set_key to set the MAC key.
+ *
+ *             2) call tc_cbc_hmac_seal to encrypt and authenticate data.
+ *
+ *             3) call tc_cbc_hmac_open to verify and decrypt data.
+ *
+ *             The HMAC state passed to these procedures is only read, so a
+ *             keyed state can be used for any number of messages.
+ */
+
+#ifndef __TC_CBC_HMAC_H__
+#define __TC_CBC_HMAC_H__
+
+#include <tinycrypt/aes.h>
+#include <tinycrypt/hmac.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* size of the tag appended to the ciphertext, in bytes */
+#define TC_CBC_HMAC_TAG_SIZE TC_SHA256_DIGEST_SIZE
+
+/* bytes added to the plaintext by tc_cbc_hmac_seal: IV and tag */
+#define TC_CBC_HMAC_OVERHEAD (TC_AES_BLOCK_SIZE + TC_CBC_HMAC_TAG_SIZE)
+
+/**
+ *  @brief CBC encryption and HMAC generation procedure
+ *  CBC encrypts inlen bytes of in and appends the HMAC of the IV and
+ *  ciphertext, in a single pass over the data
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                iv == NULL or
+ *                sched == NULL or
+ *                mac == NULL or
+ *                inlen == 0 or
+ *                (inlen % TC_AES_BLOCK_SIZE) != 0 or
+ *                outlen != inlen + TC_CBC_HMAC_OVERHEAD
+ *  @note Assumes: - sched has been configured by tc_aes128_set_encrypt_key
+ *              - mac has been configured by tc_hmac_set_key
+ *              - iv contains a 16 byte random string
+ *              - out and in do not overlap
+ *  @param out OUT -- buffer to receive iv || ciphertext || tag
+ *  @param outlen IN -- length of out in bytes
+ *  @param in IN -- plaintext to encrypt
+ *  @param inlen IN -- length of plaintext in bytes
+ *  @param iv IN -- the IV for this message
+ *  @param sched IN -- AES key schedule for this encrypt
+ *  @param mac IN -- keyed HMAC state; it is not modified
+ */
+int tc_cbc_hmac_seal(uint8_t *out, size_t outlen, const uint8_t *in,
+		     size_t inlen, const uint8_t *iv,
+		     const TCAesKeySched_t sched, const TCHmacState_t mac);
+
+/**
+ *  @brief HMAC verification and CBC decryption procedure
+ *  Verifies the tag of a message sealed by tc_cbc_hmac_seal and, only if it
+ *  matches, decrypts the ciphertext into out
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                sched == NULL or
+ *                mac == NULL or
+ *                outlen == 0 or
+ *                (outlen % TC_AES_BLOCK_SIZE) != 0 or
+ *                inlen != outlen + TC_CBC_HMAC_OVERHEAD or
+ *                the tag does not match
+ *  @note Assumes: - sched has been configured by tc_aes128_set_decrypt_key
+ *              - mac has been configured by tc_hmac_set_key
+ *              - out and in do not overlap
+ *  @note out is left untouched if the tag does not match.
+ *  @param out OUT -- buffer to receive the plaintext
+ *  @param outlen IN -- length of out in bytes
+ *  @param in IN -- iv || ciphertext || tag
+ *  @param inlen IN -- length of in in bytes
+ *  @param sched IN -- AES key schedule for this decrypt
+ *  @param mac IN -- keyed HMAC state; it is not modified
+ */
+int tc_cbc_hmac_open(uint8_t *out, size_t outlen, const uint8_t *in,
+		     size_t inlen, const TCAesKeySched_t sched,
+		     const TCHmacState_t mac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_CBC_HMAC_H__ */
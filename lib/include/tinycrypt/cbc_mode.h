@@ -69,12 +69,27 @@
  *
  *            2) call tc_cbc_mode_decrypt to decrypt data.
  *
+ *            To keep the IV apart from the data, to encrypt or decrypt in
+ *            place, or to process a long message in consecutive chunks, use
+ *            the stateful interface instead:
+ *
+ *            1) call tc_cbc_mode_init to set the IV and key schedule of a
+ *            struct tc_cbc_mode_struct.
+ *
+ *            2) call tc_cbc_mode_encrypt_update (or _decrypt_update) on each
+ *            chunk, in order; the chaining value is carried in the context
+ *            from one call to the next.
+ *
+ *            3) call tc_cbc_mode_erase to destroy the context.
  */
 
 #ifndef __TC_CBC_MODE_H__
 #define __TC_CBC_MODE_H__
 
 #include <tinycrypt/aes.h>
+#include <tinycrypt/iovec.h>
+
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -111,6 +126,23 @@ int tc_cbc_mode_encrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			unsigned int inlen, const uint8_t *iv,
 			const TCAesKeySched_t sched);
 
+/**
+ *  @brief CBC encryption procedure for large buffers
+ *  Same as tc_cbc_mode_encrypt, with size_t lengths
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) in the cases listed for
+ *          tc_cbc_mode_encrypt
+ *  @param out IN/OUT -- buffer to receive the ciphertext
+ *  @param outlen IN -- length of ciphertext buffer in bytes
+ *  @param in IN -- plaintext to encrypt
+ *  @param inlen IN -- length of plaintext buffer in bytes
+ *  @param iv IN -- the IV for the this encrypt/decrypt
+ *  @param sched IN --  AES key schedule for this encrypt
+ */
+int tc_cbc_mode_encrypt_large(uint8_t *out, size_t outlen, const uint8_t *in,
+			      size_t inlen, const uint8_t *iv,
+			      const TCAesKeySched_t sched);
+
 /**
  * @brief CBC decryption procedure
  * CBC decrypts inlen bytes of the in buffer into the out buffer
@@ -144,6 +176,148 @@ int tc_cbc_mode_decrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			unsigned int inlen, const uint8_t *iv,
 			const TCAesKeySched_t sched);
 
+/**
+ * @brief CBC decryption procedure for large buffers
+ * Same as tc_cbc_mode_decrypt, with size_t lengths
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) in the cases listed for
+ *         tc_cbc_mode_decrypt
+ * @param out IN/OUT -- buffer to receive decrypted data
+ * @param outlen IN -- length of plaintext buffer in bytes
+ * @param in IN -- ciphertext to decrypt, including IV
+ * @param inlen IN -- length of ciphertext buffer in bytes
+ * @param iv IN -- the IV for the this encrypt/decrypt
+ * @param sched IN --  AES key schedule for this decrypt
+ */
+int tc_cbc_mode_decrypt_large(uint8_t *out, size_t outlen, const uint8_t *in,
+			      size_t inlen, const uint8_t *iv,
+			      const TCAesKeySched_t sched);
+
+/**
+ *  @brief CBC scatter-gather encryption procedure
+ *  CBC encrypts the iovcnt segments of iov, in order, into the out buffer
+ *  using the encryption key schedule provided, prepends iv to out
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                iv == NULL or
+ *                sched == NULL or
+ *                iov is invalid (see tc_iovec_length) or
+ *                the total length of the segments is 0 or
+ *                not a multiple of TC_AES_BLOCK_SIZE or
+ *                outlen != total length + TC_AES_BLOCK_SIZE
+ *  @note Assumes the same as tc_cbc_mode_encrypt; segments need not be
+ *        multiples of TC_AES_BLOCK_SIZE
+ *  @param out IN/OUT -- buffer to receive the ciphertext
+ *  @param outlen IN -- length of ciphertext buffer in bytes
+ *  @param iov IN -- segments of plaintext to encrypt
+ *  @param iovcnt IN -- number of segments
+ *  @param iv IN -- the IV for the this encrypt
+ *  @param sched IN --  AES key schedule for this encrypt
+ */
+int tc_cbc_mode_encrypt_v(uint8_t *out, size_t outlen,
+			  const struct tc_iovec *iov, unsigned int iovcnt,
+			  const uint8_t *iv, const TCAesKeySched_t sched);
+
+/**
+ *  @brief CBC scatter-gather decryption procedure
+ *  CBC decrypts the iovcnt segments of iov, in order, into the out buffer;
+ *  unlike tc_cbc_mode_decrypt, the iv need not precede the ciphertext
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                iv == NULL or
+ *                sched == NULL or
+ *                iov is invalid (see tc_iovec_length) or
+ *                outlen == 0 or
+ *                (outlen % TC_AES_BLOCK_SIZE) != 0 or
+ *                outlen != total length of the segments
+ *  @note Assumes:- sched was configured by aes_set_decrypt_key
+ *              - out does not overlap the segments
+ *              - segments need not be multiples of TC_AES_BLOCK_SIZE; a
+ *                block that straddles segments is gathered in a 16 byte
+ *                buffer
+ *  @param out IN/OUT -- buffer to receive decrypted data
+ *  @param outlen IN -- length of plaintext buffer in bytes
+ *  @param iov IN -- segments of ciphertext to decrypt, without the IV
+ *  @param iovcnt IN -- number of segments
+ *  @param iv IN -- the IV used to encrypt
+ *  @param sched IN --  AES key schedule for this decrypt
+ */
+int tc_cbc_mode_decrypt_v(uint8_t *out, size_t outlen,
+			  const struct tc_iovec *iov, unsigned int iovcnt,
+			  const uint8_t *iv, const TCAesKeySched_t sched);
+
+/* struct tc_cbc_mode_struct represents the state of a CBC computation */
+typedef struct tc_cbc_mode_struct {
+/* chaining value: the IV, then the last ciphertext block processed */
+	uint8_t iv[TC_AES_BLOCK_SIZE];
+/* AES key schedule */
+	TCAesKeySched_t sched;
+} *TCCbcMode_t;
+
+/**
+ *  @brief CBC context initialization procedure
+ *  Configures c to encrypt or decrypt a message starting with iv
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                c == NULL or
+ *                iv == NULL or
+ *                sched == NULL
+ *  @note Assumes sched was configured by aes_set_encrypt_key (to encrypt)
+ *        or aes_set_decrypt_key (to decrypt) and remains valid while c is
+ *        in use
+ *  @param c OUT -- the CBC context to initialize
+ *  @param iv IN -- the IV of the message
+ *  @param sched IN -- AES key schedule
+ */
+int tc_cbc_mode_init(TCCbcMode_t c, const uint8_t *iv,
+		     const TCAesKeySched_t sched);
+
+/**
+ *  @brief CBC stateful encryption procedure
+ *  CBC encrypts len bytes of in into out, continuing the chain of the
+ *  previous call; the IV is not written to out
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                c == NULL or
+ *                (len > 0 and (out == NULL or in == NULL)) or
+ *                (len % TC_AES_BLOCK_SIZE) != 0
+ *  @note out may be the same buffer as in
+ *  @param c IN/OUT -- the CBC context
+ *  @param out OUT -- buffer to receive len bytes of ciphertext
+ *  @param in IN -- plaintext to encrypt
+ *  @param len IN -- length of in in bytes
+ */
+int tc_cbc_mode_encrypt_update(TCCbcMode_t c, uint8_t *out, const uint8_t *in,
+			       size_t len);
+
+/**
+ *  @brief CBC stateful decryption procedure
+ *  CBC decrypts len bytes of in into out, continuing the chain of the
+ *  previous call; in holds ciphertext only, without the IV
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                c == NULL or
+ *                (len > 0 and (out == NULL or in == NULL)) or
+ *                (len % TC_AES_BLOCK_SIZE) != 0
+ *  @note out may be the same buffer as in
+ *  @param c IN/OUT -- the CBC context
+ *  @param out OUT -- buffer to receive len bytes of plaintext
+ *  @param in IN -- ciphertext to decrypt
+ *  @param len IN -- length of in in bytes
+ */
+int tc_cbc_mode_decrypt_update(TCCbcMode_t c, uint8_t *out, const uint8_t *in,
+			       size_t len);
+
+/**
+ *  @brief Erases the CBC context
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if c == NULL
+ *  @param c IN/OUT -- the CBC context to erase
+ */
+int tc_cbc_mode_erase(TCCbcMode_t c);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,309 @@
+/* chacha20_poly1305.h - TinyCrypt interface to a ChaCha20-Poly1305 implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a ChaCha20-Poly1305 AEAD implementation.
+ *
+ *  Overview:  ChaCha20-Poly1305 is an authenticated encryption with
+ *             associated data (AEAD) construction defined in RFC 8439. It
+ *             combines the ChaCha20 stream cipher with the Poly1305 one-time
+ *             authenticator. Unlike the AES based modes, it is built only
+ *             from 32-bit additions, rotations and XORs, so it is fast in
+ *             portable C on hosts without AES hardware and its running time
+ *             does not depend on secret data (no table lookups).
+ *
+ *             TinyCrypt ChaCha20-Poly1305 implementation accepts:
+ *
+ *             1) Both non-empty payload and associated data (it encrypts and
+ *             authenticates the payload and also authenticates the associated
+ *             data);
+ *             2) Non-empty payload and empty associated data;
+ *             3) Non-empty associated data and empty payload (it degenerates
+ *             to an authentication mode on the associated data).
+ *
+ *  Security:  The key is 256 bits long, the nonce 96 bits long and the tag
+ *             128 bits long. Using the same nonce for two different messages
+ *             encrypted with the same key destroys the security of the
+ *             construction: it leaks the XOR of the plaintexts and allows tag
+ *             forgeries. A message counter is a good choice of nonce.
+ *
+ *             The 32-bit block counter limits a single message to
+ *             (2^32 - 1) * 64 bytes of payload.
+ *
+ *  Requires:  --
+ *
+ *  Usage:     1) call tc_chacha20_poly1305_config to set the key and nonce.
+ *
+ *             2) call tc_chacha20_poly1305_seal to encrypt data and generate
+ *             the tag, or tc_chacha20_poly1305_open to verify the tag and
+ *             decrypt data.
+ *
+ *             For messages which are not available in a single buffer, the
+ *             streaming interface processes the associated data and the
+ *             payload in as many segments as needed:
+ *
+ *             1) call tc_chacha20_poly1305_stream_init with a configured
+ *             context;
+ *             2) call tc_chacha20_poly1305_stream_aad for each segment of
+ *             associated data;
+ *             3) call tc_chacha20_poly1305_stream_encrypt (or _decrypt) for
+ *             each segment of payload;
+ *             4) call tc_chacha20_poly1305_stream_final to output the tag
+ *             (or tc_chacha20_poly1305_stream_verify to check it).
+ *
+ *             Once done with a key, use tc_chacha20_poly1305_erase to destroy
+ *             the context.
+ */
+
+#ifndef __TC_CHACHA20_POLY1305_H__
+#define __TC_CHACHA20_POLY1305_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TC_CHACHA20_KEY_SIZE 32
+#define TC_CHACHA20_BLOCK_SIZE 64
+#define TC_CHACHA20_POLY1305_NONCE_SIZE 12
+#define TC_CHACHA20_POLY1305_TAG_SIZE 16
+
+/* max payload size in bytes: (2^32 - 1) ChaCha20 blocks */
+#define TC_CHACHA20_POLY1305_MAX_BYTES \
+	((uint64_t) 0xffffffff * TC_CHACHA20_BLOCK_SIZE)
+
+/* struct tc_chacha20_poly1305_struct holds the key and nonce of a message */
+typedef struct tc_chacha20_poly1305_struct {
+/* key, as little-endian words */
+	uint32_t key[TC_CHACHA20_KEY_SIZE / 4];
+/* nonce, as little-endian words */
+	uint32_t nonce[TC_CHACHA20_POLY1305_NONCE_SIZE / 4];
+} *TCChaChaPolyMode_t;
+
+/* struct tc_chacha20_poly1305_stream_struct represents the state of an
+ * incremental ChaCha20-Poly1305 computation */
+typedef struct tc_chacha20_poly1305_stream_struct {
+/* ChaCha20 input block: constants, key, block counter and nonce */
+	uint32_t input[16];
+/* keystream of the current ChaCha20 block */
+	uint8_t keystream[TC_CHACHA20_BLOCK_SIZE];
+/* next unused keystream byte */
+	unsigned int keystream_offset;
+/* Poly1305 key r (clamped) in radix 2^26 */
+	uint32_t r[5];
+/* Poly1305 accumulator in radix 2^26 */
+	uint32_t h[5];
+/* Poly1305 key s */
+	uint32_t pad[4];
+/* where to put bytes that didn't fill a Poly1305 block */
+	uint8_t leftover[16];
+/* next available leftover location */
+	unsigned int leftover_offset;
+/* associated data length in bytes */
+	uint64_t alen;
+/* payload length in bytes */
+	uint64_t plen;
+/* set once the first payload segment was processed */
+	unsigned int aad_done;
+} *TCChaChaPolyStream_t;
+
+/**
+ * @brief ChaCha20-Poly1305 configuration procedure
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                c == NULL or
+ *                key == NULL or
+ *                nonce == NULL or
+ *                nlen != TC_CHACHA20_POLY1305_NONCE_SIZE
+ * @note The key and nonce are copied into c; to encrypt the next message,
+ *       call this procedure again with a new nonce.
+ * @param c OUT -- ChaCha20-Poly1305 context
+ * @param key IN -- 32 byte key
+ * @param nonce IN -- nonce
+ * @param nlen IN -- nonce length in bytes
+ */
+int tc_chacha20_poly1305_config(TCChaChaPolyMode_t c, const uint8_t *key,
+				const uint8_t *nonce, unsigned int nlen);
+
+/**
+ * @brief Erases a ChaCha20-Poly1305 context
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if: c == NULL
+ * @param c IN/OUT -- the context to erase
+ */
+int tc_chacha20_poly1305_erase(TCChaChaPolyMode_t c);
+
+/**
+ * @brief ChaCha20-Poly1305 encryption and tag generation procedure
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                c == NULL or
+ *                ((plen > 0) and (payload == NULL)) or
+ *                ((alen > 0) and (associated_data == NULL)) or
+ *                (olen < plen + TC_CHACHA20_POLY1305_TAG_SIZE)
+ *
+ * @param out OUT -- ciphertext followed by the 16 byte tag
+ * @param olen IN -- output length in bytes
+ * @param associated_data IN -- associated data
+ * @param alen IN -- associated data length in bytes
+ * @param payload IN -- payload
+ * @param plen IN -- payload length in bytes
+ * @param c IN -- ChaCha20-Poly1305 context
+ *
+ * @note: out may be the same buffer as payload.
+ */
+int tc_chacha20_poly1305_seal(uint8_t *out, unsigned int olen,
+			      const uint8_t *associated_data,
+			      unsigned int alen, const uint8_t *payload,
+			      unsigned int plen, TCChaChaPolyMode_t c);
+
+/**
+ * @brief ChaCha20-Poly1305 tag verification and decryption procedure
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                c == NULL or
+ *                payload == NULL or
+ *                ((alen > 0) and (associated_data == NULL)) or
+ *                (plen < TC_CHACHA20_POLY1305_TAG_SIZE) or
+ *                (olen < plen - TC_CHACHA20_POLY1305_TAG_SIZE) or
+ *                the tag does not match
+ *
+ * @param out OUT -- decrypted data
+ * @param olen IN -- output length in bytes
+ * @param associated_data IN -- associated data
+ * @param alen IN -- associated data length in bytes
+ * @param payload IN -- ciphertext followed by the 16 byte tag
+ * @param plen IN -- payload length in bytes, tag included
+ * @param c IN -- ChaCha20-Poly1305 context
+ *
+ * @note: The tag is verified before anything is decrypted; if it does not
+ *        match, out is zeroed.
+ */
+int tc_chacha20_poly1305_open(uint8_t *out, unsigned int olen,
+			      const uint8_t *associated_data,
+			      unsigned int alen, const uint8_t *payload,
+			      unsigned int plen, TCChaChaPolyMode_t c);
+
+/**
+ * @brief Starts an incremental ChaCha20-Poly1305 computation
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if: s == NULL or c == NULL
+ * @param s OUT -- the stream state to initialize
+ * @param c IN -- ChaCha20-Poly1305 context
+ */
+int tc_chacha20_poly1305_stream_init(TCChaChaPolyStream_t s,
+				     const TCChaChaPolyMode_t c);
+
+/**
+ * @brief Mixes the next segment of associated data into the tag
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((alen > 0) and (associated_data == NULL)) or
+ *                payload was already processed with s
+ * @param s IN/OUT -- the stream state
+ * @param associated_data IN -- associated data segment
+ * @param alen IN -- segment length in bytes
+ */
+int tc_chacha20_poly1305_stream_aad(TCChaChaPolyStream_t s,
+				    const uint8_t *associated_data,
+				    size_t alen);
+
+/**
+ * @brief Encrypts the next segment of payload
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((len > 0) and ((out == NULL) or (in == NULL))) or
+ *                the total payload would exceed
+ *                TC_CHACHA20_POLY1305_MAX_BYTES
+ * @note Segments may have any length; out may be the same buffer as in.
+ * @param s IN/OUT -- the stream state
+ * @param out OUT -- ciphertext segment
+ * @param in IN -- plaintext segment
+ * @param len IN -- segment length in bytes
+ */
+int tc_chacha20_poly1305_stream_encrypt(TCChaChaPolyStream_t s, uint8_t *out,
+					const uint8_t *in, size_t len);
+
+/**
+ * @brief Decrypts the next segment of payload
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((len > 0) and ((out == NULL) or (in == NULL))) or
+ *                the total payload would exceed
+ *                TC_CHACHA20_POLY1305_MAX_BYTES
+ * @note The plaintext is released before the tag is checked; it must not be
+ *       used unless tc_chacha20_poly1305_stream_verify succeeds.
+ * @param s IN/OUT -- the stream state
+ * @param out OUT -- plaintext segment
+ * @param in IN -- ciphertext segment
+ * @param len IN -- segment length in bytes
+ */
+int tc_chacha20_poly1305_stream_decrypt(TCChaChaPolyStream_t s, uint8_t *out,
+					const uint8_t *in, size_t len);
+
+/**
+ * @brief Generates the tag of an incremental computation
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if: tag == NULL or s == NULL
+ * @note s is erased before exiting.
+ * @param tag OUT -- 16 byte tag
+ * @param s IN/OUT -- the stream state
+ */
+int tc_chacha20_poly1305_stream_final(uint8_t *tag, TCChaChaPolyStream_t s);
+
+/**
+ * @brief Verifies the tag of an incremental computation
+ * @return returns TC_CRYPTO_SUCCESS (1) if the tag matches
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                tag == NULL or
+ *                s == NULL or
+ *                the tag does not match
+ * @note The comparison runs in constant time; s is erased before exiting.
+ * @param tag IN -- 16 byte tag received with the message
+ * @param s IN/OUT -- the stream state
+ */
+int tc_chacha20_poly1305_stream_verify(const uint8_t *tag,
+				       TCChaChaPolyStream_t s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_CHACHA20_POLY1305_H__ */
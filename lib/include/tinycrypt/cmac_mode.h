@@ -85,8 +85,13 @@
  *           (3) Once all of the data for a message has been mixed, use
  *               tc_cmac_final to compute the CMAC tag value.
  *
- *           Steps (1)-(3) can be repeated as many times as you want to CMAC
- *           multiple messages. A practical limit is 2^48 1K messages before you
+ *           Since tc_cmac_final erases the state, the subkeys have to be
+ *           derived again with tc_cmac_setup before computing another tag.
+ *           To CMAC many messages under the same key, use instead
+ *           tc_cmac_final_reinit in step (3): it outputs the tag and leaves
+ *           the state ready for the next message, keeping the key schedule
+ *           and subkeys, so that steps (2)-(3) can be repeated as many times
+ *           as you want. A practical limit is 2^48 1K messages before you
  *           have to change the key.
  *
  *           Once you are done computing CMAC with a key, it is a good idea to
@@ -98,6 +103,7 @@
 #define __TC_CMAC_MODE_H__
 
 #include <tinycrypt/aes.h>
+#include <tinycrypt/iovec.h>
 
 #include <stddef.h>
 
@@ -175,6 +181,23 @@ int tc_cmac_init(TCCmacState_t s);
  */
 int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t dlen);
 
+/**
+ * @brief Incrementally computes CMAC over the next data segments
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully updating the CMAC state
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              s == NULL or
+ *              iov is invalid (see tc_iovec_length) or
+ *              no call to tc_cmac_update is left before re-keying
+ * @note The whole call counts as one call to tc_cmac_update, whatever the
+ *       number of segments; a call with no data is not counted.
+ *
+ * @param s IN/OUT -- the CMAC state
+ * @param iov IN -- the next data segments to MAC, in order
+ * @param iovcnt IN -- the number of segments
+ */
+int tc_cmac_update_v(TCCmacState_t s, const struct tc_iovec *iov,
+		     unsigned int iovcnt);
+
 /**
  * @brief Generates the tag from the CMAC state
  * @return returns TC_CRYPTO_SUCCESS (1) after successfully generating the tag
@@ -187,6 +210,22 @@ int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t dlen);
  */
 int tc_cmac_final(uint8_t *tag, TCCmacState_t s);
 
+/**
+ * @brief Generates the tag from the CMAC state and re-initializes the state
+ *        for the next CMAC computation under the same key
+ * @return returns TC_CRYPTO_SUCCESS (1) after successfully generating the tag
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *              tag == NULL or
+ *              s == NULL
+ * @note Unlike tc_cmac_final, the key schedule and the subkeys K1 and K2 are
+ *       kept, and only the chaining value and leftover buffer are reset as
+ *       done by tc_cmac_init. Call tc_cmac_erase once done with the key.
+ *
+ * @param tag OUT -- the CMAC tag
+ * @param s IN/OUT -- CMAC state
+ */
+int tc_cmac_final_reinit(uint8_t *tag, TCCmacState_t s);
+
 #ifdef __cplusplus
 }
 #endif
@@ -62,6 +62,31 @@
  *
  *  Usage:     1) call tc_ctr_mode to process the data to encrypt/decrypt.
  *
+ *             Alternatively, to process a stream of data delivered in chunks
+ *             of arbitrary sizes:
+ *
+ *             1) call tc_ctr_stream_init to set the counter and key schedule.
+ *
+ *             2) call tc_ctr_stream_xor to encrypt/decrypt the next chunk;
+ *             keystream bytes left unused by a partial block are consumed by
+ *             the next call, so the output does not depend on how the data is
+ *             split into chunks. A stream processes at most TC_CTR_MAX_BYTES
+ *             in total, after which the counter would wrap.
+ *
+ *             3) call tc_ctr_stream_erase to destroy the stream state.
+ *
+ *             CTR blocks are independent, so a large buffer can be split
+ *             into block-aligned chunks processed concurrently (e.g. by the
+ *             application's worker threads): the chunk starting at block i
+ *             is processed by tc_ctr_mode with a copy of the initial counter
+ *             advanced by i blocks using tc_ctr_advance. The result is
+ *             identical to a single tc_ctr_mode call over the whole buffer,
+ *             and the final counter is the initial one advanced by the total
+ *             number of blocks. libtinycrypt.a itself does not create
+ *             threads; tc_ctr_mode_parallel (ctr_parallel.h, built into the
+ *             libtinycrypt_threads.a add-on) does this split on a reused
+ *             worker pool.
+ *
  */
 
 #ifndef __TC_CTR_MODE_H__
@@ -69,11 +94,20 @@
 
 #include <tinycrypt/aes.h>
 #include <tinycrypt/constants.h>
+#include <tinycrypt/iovec.h>
+
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * max bytes processed by a single call: the 32-bit block counter must not
+ * come back to its initial value, or the keystream would repeat
+ */
+#define TC_CTR_MAX_BYTES (((uint64_t) 1 << 32) * TC_AES_BLOCK_SIZE)
+
 /**
  *  @brief CTR mode encryption/decryption procedure.
  *  CTR mode encrypts (or decrypts) inlen bytes from in buffer into out buffer
@@ -85,7 +119,8 @@ extern "C" {
  *                sched == NULL or
  *                inlen == 0 or
  *                outlen == 0 or
- *                inlen != outlen
+ *                inlen != outlen or
+ *                inlen > TC_CTR_MAX_BYTES
  *  @note Assumes:- The current value in ctr has NOT been used with sched
  *              - out points to inlen bytes
  *              - in points to inlen bytes
@@ -101,6 +136,123 @@ extern "C" {
 int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 		unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched);
 
+/**
+ *  @brief CTR mode encryption/decryption procedure for large buffers.
+ *  Same as tc_ctr_mode, with size_t lengths, so that a single call can
+ *  process up to TC_CTR_MAX_BYTES on hosts with a 64-bit size_t
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) in the cases listed for tc_ctr_mode
+ * @param out OUT -- produced ciphertext (plaintext)
+ * @param outlen IN -- length of ciphertext buffer in bytes
+ * @param in IN -- data to encrypt (or decrypt)
+ * @param inlen IN -- length of input data in bytes
+ * @param ctr IN/OUT -- the current counter value
+ * @param sched IN -- an initialized AES key schedule
+ */
+int tc_ctr_mode_large(uint8_t *out, size_t outlen, const uint8_t *in,
+		      size_t inlen, uint8_t *ctr, const TCAesKeySched_t sched);
+
+/**
+ *  @brief CTR counter advance procedure
+ *  Adds blocks to the counter value in ctr, the same way tc_ctr_mode
+ *  increments it once per processed block
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if ctr == NULL
+ *  @note Only the last 4 bytes of ctr are incremented, and they wrap modulo
+ *        2^32 exactly as in tc_ctr_mode
+ *  @param ctr IN/OUT -- the counter value to advance
+ *  @param blocks IN -- number of blocks to advance the counter by
+ */
+int tc_ctr_advance(uint8_t *ctr, unsigned int blocks);
+
+/* struct tc_ctr_stream_struct represents the state of a CTR stream */
+typedef struct tc_ctr_stream_struct {
+/* counter value of the next keystream block */
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+/* current keystream block */
+	uint8_t keystream[TC_AES_BLOCK_SIZE];
+/* next unused keystream location */
+	unsigned int keystream_offset;
+/* bytes processed since tc_ctr_stream_init (at most TC_CTR_MAX_BYTES) */
+	uint64_t bytes;
+/* AES key schedule */
+	TCAesKeySched_t sched;
+} *TCCtrStream_t;
+
+/**
+ *  @brief CTR stream initialization procedure
+ *  Configures s to start producing keystream from counter ctr
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ctr == NULL or
+ *                sched == NULL
+ *  @note Assumes:- The value in ctr has NOT been used with sched
+ *              - sched was initialized by aes_set_encrypt_key and remains
+ *                valid while s is in use
+ *  @param s IN/OUT -- the stream state to initialize
+ *  @param ctr IN -- the initial counter value
+ *  @param sched IN -- an initialized AES key schedule
+ */
+int tc_ctr_stream_init(TCCtrStream_t s, const uint8_t *ctr,
+		       const TCAesKeySched_t sched);
+
+/**
+ *  @brief CTR stream encryption/decryption procedure
+ *  Encrypts (or decrypts) len bytes from in buffer into out buffer, starting
+ *  with the keystream bytes left over by the previous call
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                out == NULL or
+ *                in == NULL when len > 0 or
+ *                the stream would exceed TC_CTR_MAX_BYTES in total
+ *  @note Assumes s has been initialized by tc_ctr_stream_init; out and in
+ *        may point to the same buffer. A call that would exceed the limit
+ *        produces no output and leaves s unchanged: the 32-bit block
+ *        counter would otherwise wrap and repeat the keystream.
+ *  @param s IN/OUT -- the stream state
+ *  @param out OUT -- produced ciphertext (plaintext)
+ *  @param in IN -- data to encrypt (or decrypt)
+ *  @param len IN -- length of input data in bytes
+ */
+int tc_ctr_stream_xor(TCCtrStream_t s, uint8_t *out, const uint8_t *in,
+		      size_t len);
+
+/**
+ *  @brief Erases the CTR stream state
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if s == NULL
+ *  @param s IN/OUT -- the stream state to erase
+ */
+int tc_ctr_stream_erase(TCCtrStream_t s);
+
+/**
+ *  @brief CTR mode scatter-gather encryption/decryption procedure.
+ *  CTR mode encrypts (or decrypts) the iovcnt segments of iov, in order, into
+ *  the contiguous out buffer
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                ctr == NULL or
+ *                sched == NULL or
+ *                iov is invalid (see tc_iovec_length) or
+ *                outlen == 0 or
+ *                outlen != total length of the segments or
+ *                outlen > TC_CTR_MAX_BYTES
+ *  @note Assumes the same as tc_ctr_mode; ctr is updated exactly as
+ *        tc_ctr_mode would update it for the concatenated input
+ * @param out OUT -- produced ciphertext (plaintext)
+ * @param outlen IN -- length of ciphertext buffer in bytes
+ * @param iov IN -- segments of data to encrypt (or decrypt)
+ * @param iovcnt IN -- number of segments
+ * @param ctr IN/OUT -- the current counter value
+ * @param sched IN -- an initialized AES key schedule
+ */
+int tc_ctr_mode_v(uint8_t *out, size_t outlen,
+		  const struct tc_iovec *iov, unsigned int iovcnt,
+		  uint8_t *ctr, const TCAesKeySched_t sched);
+
 #ifdef __cplusplus
 }
 #endif
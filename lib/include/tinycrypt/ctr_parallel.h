@@ -0,0 +1,103 @@
+/* ctr_parallel.h - TinyCrypt interface to multi-threaded CTR mode */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a multi-threaded CTR mode.
+ *
+ *  Overview:  CTR blocks are independent, so tc_ctr_mode_parallel splits a
+ *             large buffer into block-aligned chunks and processes them with
+ *             tc_ctr_mode_large on the reusable worker pool of
+ *             thread_pool.h, each chunk starting from the initial counter
+ *             advanced to its first block (see tc_ctr_advance). The output
+ *             and the final counter are byte-identical to a single
+ *             tc_ctr_mode_large call over the whole buffer. Chunks are at
+ *             least TC_CTR_PARALLEL_MIN_CHUNK bytes long, so small buffers
+ *             are processed by the calling thread alone.
+ *
+ *  Security:  The same as CTR mode (see ctr_mode.h).
+ *
+ *  Requires:  AES-128, CTR mode and the worker pool (POSIX threads). Built
+ *             into the libtinycrypt_threads.a add-on (link with -pthread).
+ *
+ *  Usage:     call tc_ctr_mode_parallel instead of tc_ctr_mode_large, with
+ *             the number of threads (e.g. the number of cores) to use.
+ */
+
+#ifndef __TC_CTR_PARALLEL_H__
+#define __TC_CTR_PARALLEL_H__
+
+#include <tinycrypt/ctr_mode.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* smallest chunk processed by one thread (a multiple of the block size) */
+#ifndef TC_CTR_PARALLEL_MIN_CHUNK
+#define TC_CTR_PARALLEL_MIN_CHUNK (64 * 1024)
+#endif
+
+/**
+ *  @brief Multi-threaded CTR mode encryption/decryption procedure
+ *  Encrypts (or decrypts) len bytes from in buffer into out buffer on up to
+ *  nthreads threads
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                ctr == NULL or
+ *                sched == NULL or
+ *                len == 0 or
+ *                len > TC_CTR_MAX_BYTES or
+ *                nthreads == 0
+ *  @note Assumes the same as tc_ctr_mode; out and in may point to the same
+ *        buffer. ctr is updated exactly as tc_ctr_mode_large would update
+ *        it, and is left unchanged on failure.
+ *  @param out OUT -- produced ciphertext (plaintext)
+ *  @param in IN -- data to encrypt (or decrypt)
+ *  @param len IN -- length of the data in bytes
+ *  @param ctr IN/OUT -- the current counter value
+ *  @param sched IN -- an initialized AES key schedule
+ *  @param nthreads IN -- maximum number of threads, the caller included
+ */
+int tc_ctr_mode_parallel(uint8_t *out, const uint8_t *in, size_t len,
+			 uint8_t *ctr, const TCAesKeySched_t sched,
+			 unsigned int nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_CTR_PARALLEL_H__ */
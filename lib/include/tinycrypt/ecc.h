@@ -205,6 +205,31 @@ uECC_Curve uECC_secp256r1(void);
 int uECC_generate_random_int(uECC_word_t *random, const uECC_word_t *top,
 			     wordcount_t num_words);
 
+/* uECC_RNG_Function_ex type
+ * Same as uECC_RNG_Function, called with the context pointer given to the
+ * *_ex procedures (uECC_make_key_ex, uECC_shared_secret_ex, uECC_sign_ex and
+ * uECC_generate_random_int_ex) as first argument. The context lets each
+ * thread use its own PRNG instance (e.g. a TCCtrPrng_t or a TCHmacPrng_t)
+ * without sharing the RNG set with uECC_set_rng().
+ */
+typedef int(*uECC_RNG_Function_ex)(void *ctx, uint8_t *dest,
+				   unsigned int size);
+
+/*
+ * @brief Generates a random integer in the range 0 < random < top, drawing
+ * the random bytes from rng.
+ * @param random OUT -- random integer in the range 0 < random < top
+ * @param top IN -- upper limit
+ * @param num_words IN -- number of words
+ * @param rng IN -- function generating random bytes
+ * @param rng_ctx IN -- context passed to rng
+ * @return returns 1 on success
+ *         returns 0 if rng == NULL or rng failed
+ */
+int uECC_generate_random_int_ex(uECC_word_t *random, const uECC_word_t *top,
+				wordcount_t num_words, uECC_RNG_Function_ex rng,
+				void *rng_ctx);
+
 
 /* uECC_RNG_Function type
  * The RNG function should fill 'size' random bytes into 'dest'. It should
@@ -242,6 +267,14 @@ void uECC_set_rng(uECC_RNG_Function rng_function);
  */
 uECC_RNG_Function uECC_get_rng(void);
 
+/*
+ * @brief uECC_RNG_Function_ex calling the function set with uECC_set_rng();
+ * the procedures using that function are built on their *_ex variants with
+ * this one.
+ * @param ctx IN -- unused
+ */
+int uECC_global_rng(void *ctx, uint8_t *dest, unsigned int size);
+
 /*
  * @brief computes the size of a private key for the curve in bytes.
  * @param curve IN -- elliptic curve
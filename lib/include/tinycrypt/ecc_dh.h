@@ -93,6 +93,21 @@ extern "C" {
  */
 int uECC_make_key(uint8_t *p_public_key, uint8_t *p_private_key, uECC_Curve curve);
 
+/**
+ * @brief Create a public/private key pair, drawing the random bytes from rng
+ * instead of the RNG set with uECC_set_rng().
+ * @return returns TC_CRYPTO_SUCCESS (1) if the key pair was generated successfully
+ *         returns TC_CRYPTO_FAIL (0) if rng == NULL or error while generating
+ *         key pair
+ *
+ * @param p_public_key OUT -- as in uECC_make_key()
+ * @param p_private_key OUT -- as in uECC_make_key()
+ * @param rng IN -- cryptographically-secure function generating random bytes
+ * @param rng_ctx IN -- context passed to rng (e.g. a per-thread PRNG state)
+ */
+int uECC_make_key_ex(uint8_t *p_public_key, uint8_t *p_private_key,
+		     uECC_Curve curve, uECC_RNG_Function_ex rng, void *rng_ctx);
+
 #ifdef ENABLE_TESTS
 
 /**
@@ -124,6 +139,21 @@ int uECC_make_key_with_d(uint8_t *p_public_key, uint8_t *p_private_key,
 int uECC_shared_secret(const uint8_t *p_public_key, const uint8_t *p_private_key,
 		       uint8_t *p_secret, uECC_Curve curve);
 
+/**
+ * @brief Compute a shared secret as uECC_shared_secret() does, drawing the
+ * random initial Z value (side-channel countermeasure) from rng instead of the
+ * RNG set with uECC_set_rng(); with rng == NULL, no random Z is used.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the shared secret was computed successfully
+ *         returns TC_CRYPTO_FAIL (0) otherwise
+ *
+ * @param rng IN -- function generating random bytes, or NULL
+ * @param rng_ctx IN -- context passed to rng
+ */
+int uECC_shared_secret_ex(const uint8_t *p_public_key,
+			  const uint8_t *p_private_key, uint8_t *p_secret,
+			  uECC_Curve curve, uECC_RNG_Function_ex rng,
+			  void *rng_ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -70,6 +70,8 @@
  *          recommended) and pass it in to ecdsa_sign function along with your
  *          private key and a random number. You must use a new non-predictable
  *          random number to generate each new signature.
+ *          uECC_sign_deterministic derives this number from the private key
+ *          and the hash instead (RFC 6979).
  *          - To verify a signature: Compute the hash of the signed data using
  *          the same hash as the signer and pass it to this function along with
  *          the signer's public key and the signature values (r and s).
@@ -105,6 +107,35 @@ extern "C" {
 int uECC_sign(const uint8_t *p_private_key, const uint8_t *p_message_hash,
 	      unsigned p_hash_size, uint8_t *p_signature, uECC_Curve curve);
 
+/**
+ * @brief Generate an ECDSA signature as uECC_sign() does, drawing k and the
+ * blinding value from rng instead of the RNG set with uECC_set_rng().
+ * @return returns TC_CRYPTO_SUCCESS (1) if the signature generated successfully
+ *         returns TC_CRYPTO_FAIL (0) if rng == NULL or an error occurred.
+ *
+ * @param rng IN -- cryptographically-secure function generating random bytes
+ * @param rng_ctx IN -- context passed to rng (e.g. a per-thread PRNG state)
+ */
+int uECC_sign_ex(const uint8_t *p_private_key, const uint8_t *p_message_hash,
+		 unsigned p_hash_size, uint8_t *p_signature, uECC_Curve curve,
+		 uECC_RNG_Function_ex rng, void *rng_ctx);
+
+/**
+ * @brief Generate an ECDSA signature as uECC_sign() does, deriving k from the
+ * private key and the message hash as specified in RFC 6979.
+ * @return returns TC_CRYPTO_SUCCESS (1) if the signature generated successfully
+ *         returns TC_CRYPTO_FAIL (0) if an error occurred.
+ *
+ * @note k comes from an HMAC-DRBG (see tc_hmac_prng_instantiate) seeded with
+ * p_private_key and the reduced p_message_hash, so the same key and hash
+ * always give the same signature and no RNG is needed. The value blinding the
+ * inversion of k is drawn from the same DRBG.
+ */
+int uECC_sign_deterministic(const uint8_t *p_private_key,
+			    const uint8_t *p_message_hash,
+			    unsigned p_hash_size, uint8_t *p_signature,
+			    uECC_Curve curve);
+
 #ifdef ENABLE_TESTS
 /*
  * THIS FUNCTION SHOULD BE CALLED FOR TEST PURPOSES ONLY.
@@ -58,6 +58,8 @@
 #ifndef __UECC_PLATFORM_SPECIFIC_H_
 #define __UECC_PLATFORM_SPECIFIC_H_
 
+#include <stdint.h>
+
 /*
  * The RNG function should fill 'size' random bytes into 'dest'. It should
  * return 1 if 'dest' was filled with random data, or 0 if the random data could
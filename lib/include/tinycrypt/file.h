@@ -0,0 +1,151 @@
+/* file.h - TinyCrypt interface to file hashing and encryption helpers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to the file helpers.
+ *
+ *  Overview:  Helpers that feed the contents of a file descriptor through
+ *             SHA-256, HMAC-SHA256 or AES-CTR, so that applications do not
+ *             have to write their own read loops. Regular files are mapped
+ *             into memory in windows of TC_FILE_MAP_SIZE bytes, advised for
+ *             sequential access, and hashed or encrypted straight from the
+ *             page cache. Regular files that cannot be mapped, or that
+ *             report a size of zero (e.g. in /proc or /sys), are read through
+ *             a buffer of TC_FILE_BUFFER_SIZE bytes. Other descriptors
+ *             (pipes, sockets, terminals) are read by a short-lived reader
+ *             thread into two such buffers in turn, so that waiting for input
+ *             overlaps with hashing or encryption.
+ *
+ *  Security:  These helpers add no security properties of their own; see the
+ *             headers of the underlying primitives. A regular file must not
+ *             be truncated while it is being processed: accessing a mapped
+ *             page past the new end of file raises SIGBUS.
+ *
+ *  Requires:  A POSIX system (mmap, pread and POSIX threads), SHA-256,
+ *             HMAC-SHA256 and AES-CTR mode. Built into the
+ *             libtinycrypt_threads.a add-on (link with -pthread).
+ *
+ *  Usage:     1) initialize the primitive as usual (tc_sha256_init,
+ *             tc_hmac_init or tc_ctr_stream_init).
+ *
+ *             2) call tc_sha256_file, tc_hmac_file or tc_ctr_file to process
+ *             the contents of a descriptor; like the update functions, they
+ *             can be mixed with other update calls and called many times.
+ *
+ *             3) finish as usual (tc_sha256_final, tc_hmac_final or
+ *             tc_ctr_stream_erase).
+ *
+ *             Each helper optionally returns the number of bytes processed,
+ *             which the application can divide by its own elapsed time to
+ *             report throughput. The helpers do not read clocks.
+ */
+
+#ifndef __TC_FILE_H__
+#define __TC_FILE_H__
+
+#include <tinycrypt/sha256.h>
+#include <tinycrypt/hmac.h>
+#include <tinycrypt/ctr_mode.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bytes of a regular file mapped at a time (a multiple of the page size) */
+#define TC_FILE_MAP_SIZE ((size_t) 8 << 20)
+/* bytes read at a time from descriptors that cannot be mapped */
+#define TC_FILE_BUFFER_SIZE 4096
+
+/**
+ *  @brief SHA-256 file update procedure
+ *  Mixes the contents of fd into the hash state
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                fd < 0 or
+ *                reading fd fails
+ *  @note A regular file is processed whole, from offset 0 to its current
+ *        size, regardless of the file offset of fd, which is left unchanged.
+ *        Any other descriptor is read from its current position until end of
+ *        file.
+ *  @param s IN/OUT -- the SHA-256 state, initialized by tc_sha256_init
+ *  @param fd IN -- the file descriptor to hash
+ *  @param nbytes OUT -- if not NULL, receives the number of bytes hashed
+ */
+int tc_sha256_file(TCSha256State_t s, int fd, uint64_t *nbytes);
+
+/**
+ *  @brief HMAC file update procedure
+ *  Mixes the contents of fd into the HMAC state
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                ctx == NULL or
+ *                fd < 0 or
+ *                reading fd fails
+ *  @note fd is processed as in tc_sha256_file
+ *  @param ctx IN/OUT -- the HMAC state, initialized by tc_hmac_init
+ *  @param fd IN -- the file descriptor to authenticate
+ *  @param nbytes OUT -- if not NULL, receives the number of bytes processed
+ */
+int tc_hmac_file(TCHmacState_t ctx, int fd, uint64_t *nbytes);
+
+/**
+ *  @brief CTR file encryption/decryption procedure
+ *  Encrypts (or decrypts) the contents of in_fd and writes the result to
+ *  out_fd
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                in_fd < 0 or
+ *                out_fd < 0 or
+ *                reading in_fd or writing out_fd fails or
+ *                s would process more than TC_CTR_MAX_BYTES (64 GiB) in
+ *                total (see tc_ctr_stream_xor)
+ *  @note in_fd is processed as in tc_sha256_file; the output is written at
+ *        the current position of out_fd. On failure, part of the output may
+ *        already have been written. Larger inputs must be split across
+ *        streams with distinct counters or keys.
+ *  @param s IN/OUT -- the CTR stream, initialized by tc_ctr_stream_init
+ *  @param in_fd IN -- the file descriptor to encrypt (or decrypt)
+ *  @param out_fd IN -- the file descriptor receiving the result
+ *  @param nbytes OUT -- if not NULL, receives the number of bytes processed
+ */
+int tc_ctr_file(TCCtrStream_t s, int in_fd, int out_fd, uint64_t *nbytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_FILE_H__ */
@@ -0,0 +1,165 @@
+/* hkdf.h - TinyCrypt interface to an HKDF-SHA256 implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to an HKDF-SHA256 implementation.
+ *
+ *  Overview:  HKDF (RFC 5869) derives keys from input keying material that
+ *             is not uniformly random, such as an ECDH shared secret. The
+ *             extract step concentrates its entropy into a pseudo-random key
+ *             PRK = HMAC(salt, IKM); the expand step stretches PRK into
+ *             output keying material T(1) || T(2) || ..., where
+ *             T(i) = HMAC(PRK, T(i-1) || info || i). TinyCrypt hard codes
+ *             HMAC-SHA256.
+ *
+ *             The expand step hashes the PRK key blocks once and reuses the
+ *             resulting HMAC midstates (see hmac.h) for every output block.
+ *             To derive several keys from one PRK with different info
+ *             strings, set the midstates once and call
+ *             tc_hkdf_expand_midstates for each key.
+ *
+ *  Security:  HKDF is not a password hash: use PBKDF2 (pbkdf2.h) for low
+ *             entropy inputs. Bind each derived key to its purpose with a
+ *             distinct info string. The salt is optional but recommended.
+ *
+ *  Requires:  SHA-256 and HMAC-SHA256
+ *
+ *  Usage:     1) call tc_hkdf to extract and expand in one step; or
+ *
+ *             2) call tc_hkdf_extract once, then tc_hkdf_expand for each key;
+ *             or tc_hmac_set_midstates with the PRK, then
+ *             tc_hkdf_expand_midstates for each key, and
+ *             tc_hmac_midstates_erase and erase the PRK when done.
+ */
+
+#ifndef __TC_HKDF_H__
+#define __TC_HKDF_H__
+
+#include <tinycrypt/hmac.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* max output of the expand step: 255 blocks */
+#define TC_HKDF_MAX_OKM_SIZE (255 * TC_SHA256_DIGEST_SIZE)
+
+/**
+ *  @brief HKDF extract procedure
+ *  Computes the pseudo-random key PRK = HMAC(salt, ikm)
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                prk == NULL or
+ *                salt == NULL when saltlen > 0 or
+ *                ikm == NULL when ikmlen > 0
+ *  @note An empty salt stands for TC_SHA256_DIGEST_SIZE zero bytes
+ *  @param prk OUT -- the TC_SHA256_DIGEST_SIZE bytes pseudo-random key
+ *  @param salt IN -- the optional salt
+ *  @param saltlen IN -- length of the salt in bytes
+ *  @param ikm IN -- the input keying material
+ *  @param ikmlen IN -- length of the input keying material in bytes
+ */
+int tc_hkdf_extract(uint8_t *prk, const uint8_t *salt, unsigned int saltlen,
+		    const uint8_t *ikm, size_t ikmlen);
+
+/**
+ *  @brief HKDF expand procedure
+ *  Derives okmlen bytes of output keying material from prk and info
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                okm == NULL or
+ *                okmlen == 0 or
+ *                okmlen > TC_HKDF_MAX_OKM_SIZE or
+ *                prk == NULL or
+ *                prklen < TC_SHA256_DIGEST_SIZE or
+ *                info == NULL when infolen > 0
+ *  @param okm OUT -- the output keying material
+ *  @param okmlen IN -- length of okm in bytes
+ *  @param prk IN -- the pseudo-random key
+ *  @param prklen IN -- length of the pseudo-random key in bytes
+ *  @param info IN -- the optional context and application specific string
+ *  @param infolen IN -- length of info in bytes
+ */
+int tc_hkdf_expand(uint8_t *okm, size_t okmlen,
+		   const uint8_t *prk, unsigned int prklen,
+		   const uint8_t *info, size_t infolen);
+
+/**
+ *  @brief HKDF expand procedure from PRK midstates
+ *  Same as tc_hkdf_expand, with the PRK given as HMAC midstates set by
+ *  tc_hmac_set_midstates, which are left unchanged
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                okm == NULL or
+ *                okmlen == 0 or
+ *                okmlen > TC_HKDF_MAX_OKM_SIZE or
+ *                prk == NULL or
+ *                info == NULL when infolen > 0
+ *  @param okm OUT -- the output keying material
+ *  @param okmlen IN -- length of okm in bytes
+ *  @param prk IN -- the PRK midstates
+ *  @param info IN -- the optional context and application specific string
+ *  @param infolen IN -- length of info in bytes
+ */
+int tc_hkdf_expand_midstates(uint8_t *okm, size_t okmlen,
+			     const struct tc_hmac_midstates_struct *prk,
+			     const uint8_t *info, size_t infolen);
+
+/**
+ *  @brief HKDF procedure
+ *  Extracts a PRK from salt and ikm and expands it into okmlen bytes
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) on the conditions of tc_hkdf_extract
+ *          and tc_hkdf_expand
+ *  @param okm OUT -- the output keying material
+ *  @param okmlen IN -- length of okm in bytes
+ *  @param salt IN -- the optional salt
+ *  @param saltlen IN -- length of the salt in bytes
+ *  @param ikm IN -- the input keying material
+ *  @param ikmlen IN -- length of the input keying material in bytes
+ *  @param info IN -- the optional context and application specific string
+ *  @param infolen IN -- length of info in bytes
+ */
+int tc_hkdf(uint8_t *okm, size_t okmlen,
+	    const uint8_t *salt, unsigned int saltlen,
+	    const uint8_t *ikm, size_t ikmlen,
+	    const uint8_t *info, size_t infolen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_HKDF_H__ */
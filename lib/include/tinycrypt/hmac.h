@@ -58,6 +58,12 @@
  *              all of the segments of the input; the order is important.
  *
  *              4) call tc_hmac_final to out put the tag.
+ *
+ *              To compute many tags under the same key (e.g. in key
+ *              derivation functions), call tc_hmac_set_midstates once to hash
+ *              the key blocks, then tc_hmac_midstates_v for each message;
+ *              this saves the two compressions of the key blocks per tag.
+ *              Call tc_hmac_midstates_erase once done with the key.
  */
 
 #ifndef __TC_HMAC_H__
@@ -114,6 +120,34 @@ int tc_hmac_init(TCHmacState_t ctx);
 int tc_hmac_update(TCHmacState_t ctx, const void *data,
 		   unsigned int data_length);
 
+/**
+ *  @brief HMAC update procedure for large inputs
+ *  Same as tc_hmac_update, with a size_t length as in tc_sha256_update
+ *  @return returns TC_CRYPTO_SUCCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if: ctx == NULL or key == NULL
+ *  @note Assumes state has been initialized by tc_hmac_init
+ *  @param ctx IN/OUT -- state of HMAC computation so far
+ *  @param data IN -- data to incorporate into state
+ *  @param data_length IN -- size of data in bytes
+ */
+int tc_hmac_update_large(TCHmacState_t ctx, const void *data,
+			 size_t data_length);
+
+/**
+ *  @brief HMAC scatter-gather update procedure
+ *  Mixes the iovcnt segments of iov into state, in order
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                ctx == NULL or
+ *                iov is invalid (see tc_iovec_length)
+ *  @note Assumes state has been initialized by tc_hmac_init
+ *  @param ctx IN/OUT -- state of HMAC computation so far
+ *  @param iov IN -- segments of data to incorporate into state
+ *  @param iovcnt IN -- number of segments
+ */
+int tc_hmac_update_v(TCHmacState_t ctx, const struct tc_iovec *iov,
+		     unsigned int iovcnt);
+
 /**
  *  @brief HMAC final procedure
  *  Writes the HMAC tag into the tag buffer
@@ -132,6 +166,56 @@ int tc_hmac_update(TCHmacState_t ctx, const void *data,
  */
 int tc_hmac_final(uint8_t *tag, unsigned int taglen, TCHmacState_t ctx);
 
+/* struct tc_hmac_midstates_struct holds an HMAC key as SHA-256 midstates */
+typedef struct tc_hmac_midstates_struct {
+/* SHA-256 state after hashing the inner key block (key ^ ipad) */
+	struct tc_sha256_state_struct inner;
+/* SHA-256 state after hashing the outer key block (key ^ opad) */
+	struct tc_sha256_state_struct outer;
+} *TCHmacMidstates_t;
+
+/**
+ *  @brief HMAC midstates set key procedure
+ *  Hashes the inner and outer key blocks of key into m
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                m == NULL or
+ *                key == NULL when key_size > 0
+ *  @note Unlike tc_hmac_set_key, an empty key is accepted: HMAC pads keys
+ *        with zeros, so it is the same key as a single zero byte
+ *  @param m OUT -- the midstates
+ *  @param key IN -- the HMAC key
+ *  @param key_size IN -- the HMAC key size
+ */
+int tc_hmac_set_midstates(TCHmacMidstates_t m, const uint8_t *key,
+			  unsigned int key_size);
+
+/**
+ *  @brief HMAC midstates tag procedure
+ *  Computes the HMAC tag of the concatenation of the iovcnt segments of iov
+ *  under the key held by m, leaving m unchanged
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                tag == NULL or
+ *                m == NULL or
+ *                iov is invalid (see tc_iovec_length)
+ *  @note tag may point into one of the segments
+ *  @param tag OUT -- the TC_SHA256_DIGEST_SIZE bytes tag
+ *  @param m IN -- midstates set by tc_hmac_set_midstates
+ *  @param iov IN -- segments of the message
+ *  @param iovcnt IN -- number of segments
+ */
+int tc_hmac_midstates_v(uint8_t *tag, const struct tc_hmac_midstates_struct *m,
+			const struct tc_iovec *iov, unsigned int iovcnt);
+
+/**
+ *  @brief Erases the HMAC midstates
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if m == NULL
+ *  @param m IN/OUT -- the midstates to erase
+ */
+int tc_hmac_midstates_erase(TCHmacMidstates_t m);
+
 #ifdef __cplusplus
 }
 #endif
@@ -78,8 +78,8 @@ extern "C" {
 #define TC_HMAC_PRNG_RESEED_REQ -1
 
 struct tc_hmac_prng_struct {
-	/* the HMAC instance for this PRNG */
-	struct tc_hmac_state_struct h;
+	/* the HMAC midstates of the PRNG key */
+	struct tc_hmac_midstates_struct h;
 	/* the PRNG key */
 	uint8_t key[TC_SHA256_DIGEST_SIZE];
 	/* PRNG state */
@@ -140,6 +140,33 @@ int tc_hmac_prng_reseed(TCHmacPrng_t prng, const uint8_t *seed,
 			unsigned int seedlen, const uint8_t *additional_input,
 			unsigned int additionallen);
 
+/**
+ *  @brief HMAC-PRNG deterministic instantiate procedure
+ *  Puts prng into the known initial state, mixes seed || nonce into it as
+ *  the NIST SP 800-90A instantiate function does without personalization,
+ *  and enables tc_hmac_prng_generate
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                prng == NULL,
+ *                seed == NULL,
+ *                seedlen < MIN_SLEN,
+ *                seedlen > MAX_SLEN,
+ *                nonce == NULL && noncelen > 0,
+ *                noncelen > MAX_ALEN
+ *  @note This is the HMAC_DRBG of RFC 6979, where seed is the private key
+ *        and nonce the reduced message hash. Unlike tc_hmac_prng_init, no
+ *        personalization is mixed in, so the output only depends on seed
+ *        and nonce: use tc_hmac_prng_init for random number generation.
+ *  @param prng IN/OUT -- the PRNG state to instantiate
+ *  @param seed IN -- secret seed material
+ *  @param seedlen IN -- length of seed in bytes
+ *  @param nonce IN -- nonce mixed in after seed
+ *  @param noncelen IN -- nonce length in bytes
+ */
+int tc_hmac_prng_instantiate(TCHmacPrng_t prng, const uint8_t *seed,
+			     unsigned int seedlen, const uint8_t *nonce,
+			     unsigned int noncelen);
+
 /**
  *  @brief HMAC-PRNG generate procedure
  *  Generates outlen pseudo-random bytes into out buffer, updates prng
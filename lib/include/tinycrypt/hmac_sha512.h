@@ -0,0 +1,133 @@
+/* hmac_sha512.h - TinyCrypt interface to an HMAC-SHA512 implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to an HMAC-SHA512 implementation.
+ *
+ *  Overview:   HMAC-SHA512 is the HMAC construction of hmac.h instantiated
+ *              with SHA-512 instead of SHA-256. On 64-bit hosts it
+ *              authenticates bulk data faster than HMAC-SHA256.
+ *
+ *  Security:   The security of the HMAC depends on the length of the key and
+ *              on the security of the hash function. Keys longer than
+ *              TC_SHA512_BLOCK_SIZE bytes are hashed first.
+ *
+ *  Requires:   SHA-512
+ *
+ *  Usage:      1) call tc_hmac_sha512_set_key to set the HMAC key.
+ *
+ *              2) call tc_hmac_sha512_init to initialize a struct
+ *              tc_hmac_sha512_state_struct before processing the data.
+ *
+ *              3) call tc_hmac_sha512_update to process the next input
+ *              segment; it can be called as many times as needed to process
+ *              all of the segments of the input; the order is important.
+ *
+ *              4) call tc_hmac_sha512_final to out put the tag.
+ */
+
+#ifndef __TC_HMAC_SHA512_H__
+#define __TC_HMAC_SHA512_H__
+
+#include <tinycrypt/sha512.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct tc_hmac_sha512_state_struct {
+	/* the internal state required by h */
+	struct tc_sha512_state_struct hash_state;
+	/* HMAC key schedule */
+	uint8_t key[2*TC_SHA512_BLOCK_SIZE];
+};
+typedef struct tc_hmac_sha512_state_struct *TCHmacSha512State_t;
+
+/**
+ *  @brief HMAC-SHA512 set key procedure
+ *  Configures ctx to use key
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if
+ *                ctx == NULL or
+ *                key == NULL or
+ *                key_size == 0
+ * @param ctx IN/OUT -- the struct tc_hmac_sha512_state_struct to initial
+ * @param key IN -- the HMAC key to configure
+ * @param key_size IN -- the HMAC key size
+ */
+int tc_hmac_sha512_set_key(TCHmacSha512State_t ctx, const uint8_t *key,
+			   unsigned int key_size);
+
+/**
+ * @brief HMAC-SHA512 init procedure
+ * Initializes ctx to begin the next HMAC operation
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if: ctx == NULL
+ * @param ctx IN/OUT -- struct tc_hmac_sha512_state_struct buffer to init
+ */
+int tc_hmac_sha512_init(TCHmacSha512State_t ctx);
+
+/**
+ *  @brief HMAC-SHA512 update procedure
+ *  Mixes data_length bytes addressed by data into state
+ *  @return returns TC_CRYPTO_SUCCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if: ctx == NULL
+ *  @note Assumes state has been initialized by tc_hmac_sha512_init
+ *  @param ctx IN/OUT -- state of HMAC computation so far
+ *  @param data IN -- data to incorporate into state
+ *  @param data_length IN -- size of data in bytes
+ */
+int tc_hmac_sha512_update(TCHmacSha512State_t ctx, const void *data,
+			  size_t data_length);
+
+/**
+ *  @brief HMAC-SHA512 final procedure
+ *  Writes the HMAC tag into the tag buffer
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                tag == NULL or
+ *                ctx == NULL or
+ *                taglen != TC_SHA512_DIGEST_SIZE
+ *  @note ctx is erased before exiting. This should never be changed/removed.
+ *  @param tag IN/OUT -- buffer to receive computed HMAC tag
+ *  @param taglen IN -- size of tag in bytes
+ *  @param ctx IN/OUT -- the HMAC state for computing tag
+ */
+int tc_hmac_sha512_final(uint8_t *tag, unsigned int taglen,
+			 TCHmacSha512State_t ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*__TC_HMAC_SHA512_H__*/
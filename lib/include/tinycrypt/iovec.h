@@ -0,0 +1,111 @@
+/* iovec.h - TinyCrypt scatter-gather segment descriptor */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Scatter-gather input segments.
+ *
+ *  Overview:  The *_v variants of the hash, MAC and cipher procedures
+ *             (tc_sha256_update_v, tc_hmac_update_v, tc_cmac_update_v,
+ *             tc_ctr_mode_v, tc_cbc_mode_encrypt_v and tc_cbc_mode_decrypt_v)
+ *             take their input as an array of segments. The segments are
+ *             processed in order, exactly as if they had been copied into a
+ *             single contiguous buffer, so that, e.g., a packet header and
+ *             its payload kept in different buffers can be processed without
+ *             first copying them together. Segments may have any length,
+ *             including zero; cipher blocks that straddle two or more
+ *             segments are handled internally.
+ *
+ *  Usage:     Fill an array of struct tc_iovec with the address and length
+ *             of each segment and pass it, with the number of segments, to
+ *             the *_v procedure.
+ */
+
+#ifndef __TC_IOVEC_H__
+#define __TC_IOVEC_H__
+
+#include <tinycrypt/constants.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* struct tc_iovec describes one input segment */
+struct tc_iovec {
+/* start of the segment */
+	const void *iov_base;
+/* length of the segment in bytes */
+	size_t iov_len;
+};
+
+/**
+ * @brief Computes the total length of an array of segments
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                len == NULL or
+ *                iov == NULL when iovcnt > 0 or
+ *                a segment has iov_base == NULL and iov_len > 0 or
+ *                the total length overflows a size_t
+ * @param len OUT -- total length of the segments in bytes
+ * @param iov IN -- array of segments
+ * @param iovcnt IN -- number of segments
+ */
+static inline int tc_iovec_length(size_t *len, const struct tc_iovec *iov,
+				  unsigned int iovcnt)
+{
+	size_t total = 0;
+	unsigned int i;
+
+	if (len == (size_t *) 0 ||
+	    (iovcnt > 0 && iov == (const struct tc_iovec *) 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+	for (i = 0; i < iovcnt; ++i) {
+		if ((iov[i].iov_len > 0 && iov[i].iov_base == (const void *) 0) ||
+		    iov[i].iov_len > (size_t) -1 - total) {
+			return TC_CRYPTO_FAIL;
+		}
+		total += iov[i].iov_len;
+	}
+	*len = total;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_IOVEC_H__ */
@@ -0,0 +1,251 @@
+/* merkle.h - TinyCrypt interface to a SHA-256 Merkle tree hash */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a SHA-256 Merkle tree hash.
+ *
+ *  Overview:  A Merkle tree hash splits its input into leaves of
+ *             TC_MERKLE_LEAF_SIZE bytes (the last leaf may be shorter),
+ *             hashes each leaf, then hashes pairs of nodes up to a single
+ *             root. TinyCrypt builds the tree of RFC 6962 section 2.1 with
+ *             SHA-256: leaves are hashed as SHA-256(0x00 || leaf), interior
+ *             nodes as SHA-256(0x01 || left || right), the left subtree of
+ *             every node holds the largest power of two of leaves smaller than
+ *             the node's total, and the root of an empty input is
+ *             SHA-256 of the empty string.
+ *
+ *             Unlike plain SHA-256, the leaves are independent: an application
+ *             can hash them concurrently (e.g. on its own worker threads) with
+ *             tc_merkle_leaf and combine the results with tc_merkle_add_leaf
+ *             or tc_merkle_root; tc_merkle_root_parallel (merkle_parallel.h,
+ *             built into the libtinycrypt_threads.a add-on) does so on a
+ *             reused worker pool. libtinycrypt.a itself does not create
+ *             threads.
+ *
+ *             To update a tree in place, tc_merkle_tree_build keeps all of
+ *             its 2n - 1 nodes in a buffer of TC_MERKLE_TREE_SIZE(n) bytes;
+ *             after changing one leaf, tc_merkle_tree_update rehashes only
+ *             the O(log n) nodes on the path from that leaf to the root.
+ *
+ *  Security:  The 0x00 and 0x01 prefixes separate leaf and node hashes, so a
+ *             node cannot be passed off as a leaf (second pre-image attacks on
+ *             the tree). The root is NOT equal to the SHA-256 digest of the
+ *             input, and it depends on TC_MERKLE_LEAF_SIZE.
+ *
+ *  Requires:  SHA-256
+ *
+ *  Usage:     1) call tc_merkle_init to initialize a struct tc_merkle_struct.
+ *
+ *             2) call tc_merkle_update to hash the next input segment, as
+ *             with tc_sha256_update; or call tc_merkle_add_leaf to append
+ *             a leaf hash computed with tc_merkle_leaf. Leaves must be
+ *             appended in order.
+ *
+ *             3) call tc_merkle_final to output the root.
+ *
+ *             Alternatively, call tc_merkle_root to compute the root of an
+ *             array of leaf hashes in one step, or tc_merkle_tree_build and
+ *             tc_merkle_tree_update to keep the tree for later updates.
+ */
+
+#ifndef __TC_MERKLE_H__
+#define __TC_MERKLE_H__
+
+#include <tinycrypt/sha256.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bytes of input per leaf */
+#define TC_MERKLE_LEAF_SIZE (4096)
+/* max number of pending subtree roots (one per bit of the leaf count) */
+#define TC_MERKLE_MAX_DEPTH (64)
+
+/* bytes needed to store a tree of n > 0 leaves (2n - 1 nodes) */
+#define TC_MERKLE_TREE_SIZE(n) ((2 * (size_t)(n) - 1) * TC_SHA256_DIGEST_SIZE)
+
+/* struct tc_merkle_struct represents the state of a Merkle tree hash */
+typedef struct tc_merkle_struct {
+/* roots of the complete subtrees built so far, largest first */
+	uint8_t stack[TC_MERKLE_MAX_DEPTH][TC_SHA256_DIGEST_SIZE];
+/* number of leaves appended so far */
+	uint64_t leaves;
+/* hash state of the current, incomplete leaf */
+	struct tc_sha256_state_struct leaf;
+/* bytes of input in the current leaf */
+	size_t leaf_len;
+} *TCMerkleState_t;
+
+/**
+ *  @brief Merkle tree initialization procedure
+ *  Initializes t to hash a new input
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if t == NULL
+ *  @param t IN/OUT -- the Merkle tree state to initialize
+ */
+int tc_merkle_init(TCMerkleState_t t);
+
+/**
+ *  @brief Merkle tree update procedure
+ *  Hashes datalen bytes addressed by data, cutting leaves every
+ *  TC_MERKLE_LEAF_SIZE bytes of input
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                t == NULL or
+ *                data == NULL when datalen > 0
+ *  @note Assumes t has been initialized by tc_merkle_init
+ *  @param t IN/OUT -- the Merkle tree state
+ *  @param data IN -- the next input segment
+ *  @param datalen IN -- length of data in bytes
+ */
+int tc_merkle_update(TCMerkleState_t t, const uint8_t *data, size_t datalen);
+
+/**
+ *  @brief Merkle tree leaf append procedure
+ *  Appends a leaf hash computed by tc_merkle_leaf
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                t == NULL or
+ *                leaf_hash == NULL or
+ *                tc_merkle_update left an incomplete leaf in t
+ *  @note Every leaf but the last must hold exactly TC_MERKLE_LEAF_SIZE bytes
+ *        for the root to match the one computed by tc_merkle_update
+ *  @param t IN/OUT -- the Merkle tree state
+ *  @param leaf_hash IN -- the TC_SHA256_DIGEST_SIZE bytes hash of the leaf
+ */
+int tc_merkle_add_leaf(TCMerkleState_t t, const uint8_t *leaf_hash);
+
+/**
+ *  @brief Merkle tree final procedure
+ *  Hashes the incomplete leaf, if any, and writes the root
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                root == NULL or
+ *                t == NULL
+ *  @note t is erased before exiting
+ *  @param root OUT -- the TC_SHA256_DIGEST_SIZE bytes root
+ *  @param t IN/OUT -- the Merkle tree state
+ */
+int tc_merkle_final(uint8_t *root, TCMerkleState_t t);
+
+/**
+ *  @brief Merkle tree leaf hash procedure
+ *  Computes SHA-256(0x00 || data)
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                leaf_hash == NULL or
+ *                data == NULL when datalen > 0 or
+ *                datalen > TC_MERKLE_LEAF_SIZE
+ *  @param leaf_hash OUT -- the TC_SHA256_DIGEST_SIZE bytes leaf hash
+ *  @param data IN -- the leaf
+ *  @param datalen IN -- length of the leaf in bytes
+ */
+int tc_merkle_leaf(uint8_t *leaf_hash, const uint8_t *data, size_t datalen);
+
+/**
+ *  @brief Merkle tree node hash procedure
+ *  Computes SHA-256(0x01 || left || right)
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                node_hash == NULL or
+ *                left == NULL or
+ *                right == NULL
+ *  @param node_hash OUT -- the TC_SHA256_DIGEST_SIZE bytes node hash
+ *  @param left IN -- hash of the left child
+ *  @param right IN -- hash of the right child
+ */
+int tc_merkle_node(uint8_t *node_hash, const uint8_t *left,
+		   const uint8_t *right);
+
+/**
+ *  @brief Merkle tree root procedure
+ *  Computes the root of the tree whose leaf hashes are given, in order
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                root == NULL or
+ *                leaf_hashes == NULL when n > 0
+ *  @note Only the n - 1 interior nodes are hashed; to update single leaves,
+ *        keep the interior nodes with tc_merkle_tree_build instead
+ *  @param root OUT -- the TC_SHA256_DIGEST_SIZE bytes root
+ *  @param leaf_hashes IN -- n consecutive TC_SHA256_DIGEST_SIZE bytes hashes
+ *  @param n IN -- number of leaves
+ */
+int tc_merkle_root(uint8_t *root, const uint8_t *leaf_hashes, size_t n);
+
+/**
+ *  @brief Merkle tree build procedure
+ *  Computes and stores every node of the tree whose leaf hashes are given,
+ *  in order, and writes its root
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                root == NULL or
+ *                nodes == NULL or
+ *                leaf_hashes == NULL or
+ *                n == 0
+ *  @param root OUT -- the TC_SHA256_DIGEST_SIZE bytes root
+ *  @param nodes OUT -- buffer of TC_MERKLE_TREE_SIZE(n) bytes for the tree
+ *  @param leaf_hashes IN -- n consecutive TC_SHA256_DIGEST_SIZE bytes hashes
+ *  @param n IN -- number of leaves
+ */
+int tc_merkle_tree_build(uint8_t *root, uint8_t *nodes,
+			 const uint8_t *leaf_hashes, size_t n);
+
+/**
+ *  @brief Merkle tree leaf replacement procedure
+ *  Replaces the hash of leaf i in a tree stored by tc_merkle_tree_build,
+ *  rehashes the nodes on its path and writes the new root
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                root == NULL or
+ *                nodes == NULL or
+ *                leaf_hash == NULL or
+ *                i >= n
+ *  @note Hashes at most log2(n) + 1 nodes
+ *  @param root OUT -- the TC_SHA256_DIGEST_SIZE bytes root
+ *  @param nodes IN/OUT -- the tree, as stored by tc_merkle_tree_build
+ *  @param n IN -- number of leaves, as given to tc_merkle_tree_build
+ *  @param i IN -- index of the leaf to replace
+ *  @param leaf_hash IN -- the new TC_SHA256_DIGEST_SIZE bytes leaf hash
+ */
+int tc_merkle_tree_update(uint8_t *root, uint8_t *nodes, size_t n, size_t i,
+			  const uint8_t *leaf_hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_MERKLE_H__ */
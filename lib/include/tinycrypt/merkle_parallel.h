@@ -0,0 +1,117 @@
+/* merkle_parallel.h - TinyCrypt interface to a multi-threaded Merkle tree hash */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a multi-threaded Merkle tree hash.
+ *
+ *  Overview:  The leaves of a Merkle tree hash (see merkle.h) are
+ *             independent, so large inputs are hashed on the reusable worker
+ *             pool of thread_pool.h. tc_merkle_root_parallel gives each
+ *             thread a run of leaves forming a complete subtree (a power of
+ *             two of leaves, the last run excepted) and combines the subtree
+ *             roots with tc_merkle_root; the root is byte-identical to the
+ *             one computed by tc_merkle_update and tc_merkle_final.
+ *             tc_merkle_leaves_parallel outputs the leaf hashes instead, e.g.
+ *             to keep the tree with tc_merkle_tree_build. Runs are at least
+ *             TC_MERKLE_PARALLEL_MIN_LEAVES leaves long, so small inputs are
+ *             hashed by the calling thread alone.
+ *
+ *  Security:  The same as the Merkle tree hash (see merkle.h).
+ *
+ *  Requires:  SHA-256, the Merkle tree hash and the worker pool (POSIX
+ *             threads). Built into the libtinycrypt_threads.a add-on (link
+ *             with -pthread).
+ *
+ *  Usage:     call tc_merkle_root_parallel with the input and the number of
+ *             threads (e.g. the number of cores) to use.
+ */
+
+#ifndef __TC_MERKLE_PARALLEL_H__
+#define __TC_MERKLE_PARALLEL_H__
+
+#include <tinycrypt/merkle.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* fewest leaves hashed by one thread (rounded up to a power of two) */
+#ifndef TC_MERKLE_PARALLEL_MIN_LEAVES
+#define TC_MERKLE_PARALLEL_MIN_LEAVES (16)
+#endif
+
+/**
+ *  @brief Multi-threaded Merkle tree root procedure
+ *  Computes the root of the Merkle tree hash of datalen bytes addressed by
+ *  data on up to nthreads threads
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                root == NULL or
+ *                data == NULL when datalen > 0 or
+ *                nthreads == 0
+ *  @param root OUT -- the TC_SHA256_DIGEST_SIZE bytes root
+ *  @param data IN -- the input
+ *  @param datalen IN -- length of data in bytes
+ *  @param nthreads IN -- maximum number of threads, the caller included
+ */
+int tc_merkle_root_parallel(uint8_t *root, const uint8_t *data,
+			    size_t datalen, unsigned int nthreads);
+
+/**
+ *  @brief Multi-threaded Merkle tree leaf hash procedure
+ *  Computes the hashes of the leaves of datalen bytes addressed by data, cut
+ *  every TC_MERKLE_LEAF_SIZE bytes as by tc_merkle_update, on up to nthreads
+ *  threads
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                leaf_hashes == NULL or
+ *                data == NULL or
+ *                datalen == 0 or
+ *                nthreads == 0
+ *  @param leaf_hashes OUT -- ceil(datalen / TC_MERKLE_LEAF_SIZE) consecutive
+ *                            TC_SHA256_DIGEST_SIZE bytes leaf hashes
+ *  @param data IN -- the input
+ *  @param datalen IN -- length of data in bytes
+ *  @param nthreads IN -- maximum number of threads, the caller included
+ */
+int tc_merkle_leaves_parallel(uint8_t *leaf_hashes, const uint8_t *data,
+			      size_t datalen, unsigned int nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_MERKLE_PARALLEL_H__ */
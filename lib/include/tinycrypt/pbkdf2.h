@@ -0,0 +1,129 @@
+/* pbkdf2.h - TinyCrypt interface to a PBKDF2-HMAC-SHA256 implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a PBKDF2-HMAC-SHA256 implementation.
+ *
+ *  Overview:  PBKDF2 (RFC 8018, NIST SP 800-132) derives keys from a
+ *             password by iterating a pseudo-random function; TinyCrypt hard
+ *             codes HMAC-SHA256 as the function. Each 32-byte output block i
+ *             is U_1 ^ U_2 ^ ... ^ U_c, where U_1 = HMAC(P, S || INT(i)) and
+ *             U_j = HMAC(P, U_{j-1}).
+ *
+ *             The hash states after the HMAC inner and outer key blocks are
+ *             computed once per call and copied for every iteration, so an
+ *             iteration costs two SHA-256 compressions instead of four.
+ *
+ *  Security:  The iteration count is what slows down password guessing; pick
+ *             the largest count the application can afford (NIST SP 800-132
+ *             asks for at least 1000, current guidance is much higher). Use a
+ *             random salt of at least 16 bytes per password. Asking for more
+ *             than 32 bytes of output multiplies the defender's work but not
+ *             the attacker's, who only needs the first block.
+ *
+ *  Requires:  SHA-256 and HMAC-SHA256
+ *
+ *  Usage:     call tc_pbkdf2_sha256 with the password, salt and iteration
+ *             count. Output blocks are independent, so an application that
+ *             needs a long output can derive parts of it concurrently by
+ *             calling tc_pbkdf2_sha256_block from its own threads.
+ */
+
+#ifndef __TC_PBKDF2_H__
+#define __TC_PBKDF2_H__
+
+#include <tinycrypt/hmac.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* max number of 32-byte output blocks (the block index is 32 bits) */
+#define TC_PBKDF2_MAX_BLOCKS (0xffffffffUL)
+
+/**
+ *  @brief PBKDF2-HMAC-SHA256 procedure
+ *  Derives outlen bytes from password and salt
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                outlen == 0 or
+ *                outlen > TC_PBKDF2_MAX_BLOCKS * TC_SHA256_DIGEST_SIZE or
+ *                password == NULL when passwordlen > 0 or
+ *                salt == NULL when saltlen > 0 or
+ *                iterations == 0
+ *  @param out OUT -- the derived key
+ *  @param outlen IN -- length of the derived key in bytes
+ *  @param password IN -- the password
+ *  @param passwordlen IN -- length of the password in bytes
+ *  @param salt IN -- the salt
+ *  @param saltlen IN -- length of the salt in bytes
+ *  @param iterations IN -- the iteration count c
+ */
+int tc_pbkdf2_sha256(uint8_t *out, size_t outlen,
+		     const uint8_t *password, unsigned int passwordlen,
+		     const uint8_t *salt, size_t saltlen,
+		     unsigned int iterations);
+
+/**
+ *  @brief PBKDF2-HMAC-SHA256 single block procedure
+ *  Derives output block index (counting from 1), i.e. the bytes at offset
+ *  (index - 1) * TC_SHA256_DIGEST_SIZE of the tc_pbkdf2_sha256 output
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                block == NULL or
+ *                password == NULL when passwordlen > 0 or
+ *                salt == NULL when saltlen > 0 or
+ *                index == 0 or
+ *                iterations == 0
+ *  @param block OUT -- the TC_SHA256_DIGEST_SIZE bytes output block
+ *  @param password IN -- the password
+ *  @param passwordlen IN -- length of the password in bytes
+ *  @param salt IN -- the salt
+ *  @param saltlen IN -- length of the salt in bytes
+ *  @param iterations IN -- the iteration count c
+ *  @param index IN -- the block index i
+ */
+int tc_pbkdf2_sha256_block(uint8_t *block,
+			   const uint8_t *password, unsigned int passwordlen,
+			   const uint8_t *salt, size_t saltlen,
+			   unsigned int iterations, uint32_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_PBKDF2_H__ */
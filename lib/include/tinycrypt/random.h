@@ -0,0 +1,127 @@
+/* random.h - TinyCrypt interface to a per-thread PRNG pool */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a pool of per-thread HMAC-PRNG instances.
+ *
+ *  Overview:  tc_random_bytes fills a buffer with random bytes from an
+ *             HMAC-PRNG instance owned by the calling thread. The instance is
+ *             created on the first call in each thread, seeded with
+ *             TC_RANDOM_SEED_SIZE bytes from the kernel (default_CSPRNG) and
+ *             a personalization string unique to the thread, and reseeded
+ *             from the kernel every TC_RANDOM_RESEED_INTERVAL calls. Threads
+ *             share no PRNG state and take no lock after their first call,
+ *             so that they do not contend for a shared instance. On one
+ *             thread this is no faster than a single HMAC-PRNG behind an
+ *             uncontended lock (a little slower in our measurements); the
+ *             gain with several threads on several cores has not been
+ *             measured. Without thread-local storage, all threads share one
+ *             instance behind a lock.
+ *
+ *             buffered_CSPRNG exposes the same instances as a uECC RNG
+ *             function (see uECC_set_rng in ecc.h).
+ *
+ *  Security:  A forked child reseeds its instance before its first output,
+ *             so that it never repeats the output of its parent. Instances
+ *             are erased when their thread exits, or by tc_random_erase.
+ *             fork() is detected with pthread_atfork; a child created by
+ *             calling clone(2) directly is not detected.
+ *
+ *  Requires:  POSIX threads, HMAC-PRNG and default_CSPRNG
+ *             (ecc_platform_specific.c). Built into the
+ *             libtinycrypt_threads.a add-on (link with -pthread).
+ *
+ *  Usage:     call tc_random_bytes from any thread; no initialization is
+ *             needed. Optionally call tc_random_erase in a thread once it
+ *             will not need random bytes anymore.
+ */
+
+#ifndef __TC_RANDOM_H__
+#define __TC_RANDOM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* kernel entropy bytes used to (re)seed an instance */
+#define TC_RANDOM_SEED_SIZE 48
+
+/* calls to tc_random_bytes served by an instance between reseeds */
+#ifndef TC_RANDOM_RESEED_INTERVAL
+#define TC_RANDOM_RESEED_INTERVAL 65536
+#endif
+
+/**
+ *  @brief Fills out with len random bytes from the instance of the calling
+ *  thread, creating or reseeding the instance as needed
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL when len > 0 or
+ *                the kernel entropy source failed
+ *  @param out OUT -- buffer to receive the random bytes
+ *  @param len IN -- number of bytes
+ */
+int tc_random_bytes(uint8_t *out, size_t len);
+
+/**
+ *  @brief Erases the instance of the calling thread; the next call to
+ *  tc_random_bytes in the thread creates a new one
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ */
+int tc_random_erase(void);
+
+/**
+ *  @brief uECC RNG function drawing from the instance of the calling thread
+ *  Adapts tc_random_bytes to the uECC_RNG_Function interface, as an
+ *  alternative to default_CSPRNG for platforms where system calls are
+ *  expensive (e.g. sandboxes that trap them): most calls make no system
+ *  call. It is slower than default_CSPRNG where getrandom(2) is cheap.
+ *  Enable it with uECC_set_rng(&buffered_CSPRNG).
+ *  @return returns 1 if dest was filled with size random bytes
+ *          returns 0 if:
+ *                dest == NULL or
+ *                size == 0 or
+ *                the kernel entropy source failed
+ *  @param dest OUT -- buffer to receive the random bytes
+ *  @param size IN -- number of bytes
+ */
+int buffered_CSPRNG(uint8_t *dest, unsigned int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_RANDOM_H__ */
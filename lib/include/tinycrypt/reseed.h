@@ -0,0 +1,239 @@
+/* reseed.h - TinyCrypt interface to a background reseed manager */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a background reseed manager for the PRNGs.
+ *
+ *  Overview:  A reseed manager reseeds registered HMAC-PRNG and CTR-PRNG
+ *             instances every few generate calls, without making their
+ *             callers wait for the entropy source. A background thread
+ *             fetches TC_RESEED_ENTROPY_SIZE bytes of entropy ahead of time
+ *             for each registered instance. The generate wrappers
+ *             (tc_reseed_hmac_prng_generate and tc_reseed_ctr_prng_generate)
+ *             reseed the instance with those bytes once its interval has
+ *             elapsed, then let the thread fetch the next ones. The instance
+ *             itself is only touched by the thread calling the wrapper, so
+ *             instances need no lock; the manager lock is only held to
+ *             copy the prefetched bytes.
+ *
+ *             If the bytes are not ready yet when the interval elapses, the
+ *             reseed is postponed to a later call. It is done synchronously
+ *             only when the instance cannot generate any more (see
+ *             TC_HMAC_PRNG_RESEED_REQ and TC_CTR_PRNG_RESEED_REQ).
+ *
+ *             An interval of 1 gives prediction resistance: nothing is
+ *             prefetched for the instance, and every generate call first
+ *             reseeds it with entropy fetched synchronously during that
+ *             call, so the call waits for the entropy source.
+ *
+ *  Security:  The entropy source must be cryptographically secure (e.g.
+ *             default_CSPRNG). Prefetched bytes are erased once used, and all
+ *             of them by tc_reseed_unregister and tc_reseed_manager_stop.
+ *
+ *  Requires:  POSIX threads, HMAC-PRNG and CTR-PRNG. Built into the
+ *             libtinycrypt_threads.a add-on (link with -pthread).
+ *
+ *  Usage:     1) call tc_reseed_manager_start with an array of entries and an
+ *             entropy source; this starts the background thread.
+ *
+ *             2) instantiate each PRNG as usual and register it with
+ *             tc_reseed_register_hmac_prng or tc_reseed_register_ctr_prng.
+ *
+ *             3) generate through tc_reseed_hmac_prng_generate or
+ *             tc_reseed_ctr_prng_generate from the thread using the PRNG.
+ *
+ *             4) call tc_reseed_unregister when an instance is no longer
+ *             used, and tc_reseed_manager_stop to stop the thread.
+ */
+
+#ifndef __TC_RESEED_H__
+#define __TC_RESEED_H__
+
+#include <tinycrypt/hmac_prng.h>
+#include <tinycrypt/ctr_prng.h>
+
+#include <pthread.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* entropy bytes fetched for each reseed */
+#define TC_RESEED_ENTROPY_SIZE 48
+
+/* the entropy source: fills size bytes into dest, returns 1 or 0 on error */
+typedef int (*TCReseedEntropy_t)(uint8_t *dest, unsigned int size);
+
+/* struct tc_reseed_entry_struct represents one registered PRNG */
+typedef struct tc_reseed_entry_struct {
+/* the registered TCHmacPrng_t or TCCtrPrng_t; NULL if the entry is free */
+	void *prng;
+/* whether prng is a TCCtrPrng_t */
+	int is_ctr;
+/* generate calls between reseeds */
+	unsigned int interval;
+/* generate calls left before the next reseed */
+	unsigned int calls_left;
+/* prefetched entropy, valid when ready != 0 */
+	uint8_t entropy[TC_RESEED_ENTROPY_SIZE];
+	int ready;
+/* reseeds done with prefetched entropy */
+	uint64_t reseeds;
+/* reseeds that had to wait for the entropy source */
+	uint64_t sync_reseeds;
+} *TCReseedEntry_t;
+
+/* struct tc_reseed_manager_struct represents the state of a reseed manager */
+typedef struct tc_reseed_manager_struct {
+/* registered PRNGs */
+	struct tc_reseed_entry_struct *entries;
+	unsigned int num_entries;
+/* the entropy source */
+	TCReseedEntropy_t entropy;
+/* protects entries and running */
+	pthread_mutex_t lock;
+/* wakes up the background thread */
+	pthread_cond_t wake;
+	pthread_t thread;
+	int running;
+} *TCReseedManager_t;
+
+/**
+ *  @brief Starts a reseed manager and its background thread
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                m == NULL or
+ *                entries == NULL or
+ *                num_entries == 0 or
+ *                entropy == NULL or
+ *                the thread could not be created
+ *  @param m OUT -- the reseed manager
+ *  @param entries IN/OUT -- storage for num_entries registrations; must stay
+ *         valid until tc_reseed_manager_stop returns
+ *  @param num_entries IN -- number of entries
+ *  @param entropy IN -- the entropy source (e.g. default_CSPRNG)
+ */
+int tc_reseed_manager_start(TCReseedManager_t m,
+			    struct tc_reseed_entry_struct *entries,
+			    unsigned int num_entries,
+			    TCReseedEntropy_t entropy);
+
+/**
+ *  @brief Stops the background thread and erases all entries
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if m == NULL
+ *  @param m IN/OUT -- the reseed manager
+ */
+int tc_reseed_manager_stop(TCReseedManager_t m);
+
+/**
+ *  @brief Registers an HMAC-PRNG, to be reseeded every interval generate
+ *  calls
+ *  @return returns the entry of prng
+ *          returns NULL if:
+ *                m == NULL or
+ *                prng == NULL or
+ *                interval == 0 or
+ *                all entries are in use
+ *  @note Assumes tc_hmac_prng_init has been called for prng; it need not
+ *        have been reseeded yet
+ *  @param m IN/OUT -- the reseed manager
+ *  @param prng IN -- the PRNG
+ *  @param interval IN -- generate calls between reseeds; 1 reseeds before
+ *         every call with entropy fetched during that call (prediction
+ *         resistance)
+ */
+TCReseedEntry_t tc_reseed_register_hmac_prng(TCReseedManager_t m,
+					     TCHmacPrng_t prng,
+					     unsigned int interval);
+
+/**
+ *  @brief Registers a CTR-PRNG, to be reseeded every interval generate calls
+ *  @return returns the entry of prng
+ *          returns NULL as tc_reseed_register_hmac_prng does
+ *  @note Assumes tc_ctr_prng_init has been called for prng
+ *  @param m IN/OUT -- the reseed manager
+ *  @param prng IN -- the PRNG
+ *  @param interval IN -- generate calls between reseeds
+ */
+TCReseedEntry_t tc_reseed_register_ctr_prng(TCReseedManager_t m,
+					    TCCtrPrng_t *prng,
+					    unsigned int interval);
+
+/**
+ *  @brief Unregisters a PRNG and erases its prefetched entropy
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if m == NULL or e == NULL
+ *  @param m IN/OUT -- the reseed manager
+ *  @param e IN/OUT -- the entry returned when registering the PRNG
+ */
+int tc_reseed_unregister(TCReseedManager_t m, TCReseedEntry_t e);
+
+/**
+ *  @brief Reseeds the HMAC-PRNG of e if due, then calls tc_hmac_prng_generate
+ *  @return returns the result of tc_hmac_prng_generate
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                m == NULL or
+ *                e == NULL or
+ *                e does not hold an HMAC-PRNG or
+ *                a synchronous reseed failed
+ *  @param m IN/OUT -- the reseed manager
+ *  @param e IN/OUT -- the entry of the PRNG
+ *  @param out OUT -- as in tc_hmac_prng_generate
+ *  @param outlen IN -- as in tc_hmac_prng_generate
+ */
+int tc_reseed_hmac_prng_generate(TCReseedManager_t m, TCReseedEntry_t e,
+				 uint8_t *out, unsigned int outlen);
+
+/**
+ *  @brief Reseeds the CTR-PRNG of e if due, then calls tc_ctr_prng_generate
+ *  @return returns the result of tc_ctr_prng_generate
+ *          returns TC_CRYPTO_FAIL (0) as tc_reseed_hmac_prng_generate does
+ *  @param m IN/OUT -- the reseed manager
+ *  @param e IN/OUT -- the entry of the PRNG
+ *  @param additional_input IN -- as in tc_ctr_prng_generate
+ *  @param additionallen IN -- as in tc_ctr_prng_generate
+ *  @param out OUT -- as in tc_ctr_prng_generate
+ *  @param outlen IN -- as in tc_ctr_prng_generate
+ */
+int tc_reseed_ctr_prng_generate(TCReseedManager_t m, TCReseedEntry_t e,
+				const uint8_t *additional_input,
+				unsigned int additionallen,
+				uint8_t *out, unsigned int outlen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_RESEED_H__ */
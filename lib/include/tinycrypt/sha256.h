@@ -52,11 +52,23 @@
  *
  *              3) call tc_sha256_final to out put the digest from a hashing
  *              operation.
+ *
+ *              Inputs of exactly 32 or 64 bytes (digests and pairs of digests,
+ *              as in Merkle proofs) can be hashed in one call with
+ *              tc_sha256_32 or tc_sha256_64, which skip the hash state and
+ *              the generic padding; tc_sha256d computes a double SHA-256.
+ *
+ *              A state in progress can be copied with tc_sha256_clone (e.g.
+ *              to hash a common prefix once), or serialized with
+ *              tc_sha256_export and restored with tc_sha256_import (e.g. to
+ *              checkpoint a long hash across restarts).
  */
 
 #ifndef __TC_SHA256_H__
 #define __TC_SHA256_H__
 
+#include <tinycrypt/iovec.h>
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -67,6 +79,11 @@ extern "C" {
 #define TC_SHA256_BLOCK_SIZE (64)
 #define TC_SHA256_DIGEST_SIZE (32)
 #define TC_SHA256_STATE_BLOCKS (TC_SHA256_DIGEST_SIZE/4)
+/* current version of the tc_sha256_export format */
+#define TC_SHA256_EXPORT_VERSION (1)
+/* version, iv, bits_hashed, leftover_offset and leftover */
+#define TC_SHA256_EXPORT_SIZE (1 + TC_SHA256_DIGEST_SIZE + 8 + 1 + \
+			       TC_SHA256_BLOCK_SIZE)
 
 struct tc_sha256_state_struct {
 	unsigned int iv[TC_SHA256_STATE_BLOCKS];
@@ -104,6 +121,21 @@ int tc_sha256_init(TCSha256State_t s);
  */
 int tc_sha256_update (TCSha256State_t s, const uint8_t *data, size_t datalen);
 
+/**
+ *  @brief SHA256 scatter-gather update procedure
+ *  Hashes the iovcnt segments of iov into state s, in order
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                iov is invalid (see tc_iovec_length)
+ *  @note Assumes s has been initialized by tc_sha256_init
+ *  @param s Sha256 state struct
+ *  @param iov segments of the message to hash
+ *  @param iovcnt number of segments
+ */
+int tc_sha256_update_v(TCSha256State_t s, const struct tc_iovec *iov,
+		       unsigned int iovcnt);
+
 /**
  *  @brief SHA256 final procedure
  *  Inserts the completed hash computation into digest
@@ -122,6 +154,119 @@ int tc_sha256_update (TCSha256State_t s, const uint8_t *data, size_t datalen);
  */
 int tc_sha256_final(uint8_t *digest, TCSha256State_t s);
 
+/**
+ *  @brief SHA-256 state clone procedure
+ *  Copies the state of a hash computation in progress, so that a common
+ *  prefix is hashed once and each copy then hashes a different suffix
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                dst == NULL or
+ *                src == NULL
+ *  @param dst OUT -- the copy
+ *  @param src IN -- the state to copy, initialized by tc_sha256_init
+ */
+int tc_sha256_clone(TCSha256State_t dst,
+		    const struct tc_sha256_state_struct *src);
+
+/**
+ *  @brief SHA-256 state export procedure
+ *  Serializes the state of a hash computation in progress into
+ *  TC_SHA256_EXPORT_SIZE bytes
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                outlen < TC_SHA256_EXPORT_SIZE or
+ *                s == NULL
+ *  @note The format is a version byte (TC_SHA256_EXPORT_VERSION), the
+ *        chaining value and the number of bits hashed in big-endian, the
+ *        number of buffered bytes and the block buffer. It does not depend on
+ *        the host, so states can be stored and moved between machines. It
+ *        contains buffered input in the clear: protect it like the input.
+ *  @param out OUT -- buffer receiving the serialized state
+ *  @param outlen IN -- size of out in bytes
+ *  @param s IN -- the state to export, initialized by tc_sha256_init
+ */
+int tc_sha256_export(uint8_t *out, size_t outlen,
+		     const struct tc_sha256_state_struct *s);
+
+/**
+ *  @brief SHA-256 state import procedure
+ *  Restores a state serialized by tc_sha256_export
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                in == NULL or
+ *                inlen != TC_SHA256_EXPORT_SIZE or
+ *                the version is not TC_SHA256_EXPORT_VERSION or
+ *                the serialized state is malformed
+ *  @param s OUT -- the restored state
+ *  @param in IN -- the serialized state
+ *  @param inlen IN -- length of in in bytes
+ */
+int tc_sha256_import(TCSha256State_t s, const uint8_t *in, size_t inlen);
+
+/**
+ *  @brief SHA-256 procedure for 32-byte inputs
+ *  Computes the SHA-256 digest of exactly 32 bytes (e.g. a digest) in a
+ *  single compression, without a hash state
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                digest == NULL or
+ *                data == NULL
+ *  @note digest may point to the same buffer as data
+ *  @param digest OUT -- the 32-byte digest
+ *  @param data IN -- the 32 bytes to hash
+ */
+int tc_sha256_32(uint8_t *digest, const uint8_t *data);
+
+/**
+ *  @brief SHA-256 midstate completion procedure for 32-byte inputs
+ *  Computes the digest of the data already hashed into s followed by 32 more
+ *  bytes, in a single compression and without modifying s; e.g. the inner
+ *  and outer hashes of HMAC over a 32-byte message from precomputed states
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                digest == NULL or
+ *                s == NULL or
+ *                s has buffered bytes (a multiple of TC_SHA256_BLOCK_SIZE
+ *                bytes must have been hashed) or
+ *                data == NULL
+ *  @note digest may point to the same buffer as data
+ *  @param digest OUT -- the 32-byte digest
+ *  @param s IN -- the midstate, left unchanged
+ *  @param data IN -- the 32 bytes to hash
+ */
+int tc_sha256_midstate_32(uint8_t *digest,
+			  const struct tc_sha256_state_struct *s,
+			  const uint8_t *data);
+
+/**
+ *  @brief SHA-256 procedure for 64-byte inputs
+ *  Computes the SHA-256 digest of exactly 64 bytes (e.g. two concatenated
+ *  digests); the padding block is hashed with a precomputed message schedule
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                digest == NULL or
+ *                data == NULL
+ *  @note digest may point into data
+ *  @param digest OUT -- the 32-byte digest
+ *  @param data IN -- the 64 bytes to hash
+ */
+int tc_sha256_64(uint8_t *digest, const uint8_t *data);
+
+/**
+ *  @brief Double SHA-256 procedure
+ *  Computes SHA-256(SHA-256(data))
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                digest == NULL or
+ *                data == NULL
+ *  @param digest OUT -- the 32-byte digest
+ *  @param data IN -- the data to hash
+ *  @param datalen IN -- length of data in bytes
+ */
+int tc_sha256d(uint8_t *digest, const uint8_t *data, size_t datalen);
+
 #ifdef __cplusplus
 }
 #endif
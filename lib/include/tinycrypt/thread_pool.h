@@ -0,0 +1,96 @@
+/* thread_pool.h - TinyCrypt interface to a reusable worker thread pool */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to a reusable pool of worker threads.
+ *
+ *  Overview:  tc_thread_pool_run runs ntasks independent tasks on the calling
+ *             thread and up to nthreads - 1 worker threads of a process-wide
+ *             pool, and returns once all of them are done. Workers are
+ *             created on demand, up to TC_THREAD_POOL_MAX_THREADS - 1, and
+ *             then sleep between runs, so that splitting a large buffer
+ *             costs no thread creation after the first call. The parallel
+ *             modes (e.g. tc_ctr_mode_parallel) are built on top of it.
+ *
+ *  Security:  Tasks run on other threads: anything they read or write must
+ *             stay valid until tc_thread_pool_run returns. A child process
+ *             created by fork() starts with an empty pool, which is refilled
+ *             by its first run.
+ *
+ *  Requires:  POSIX threads. Built into the libtinycrypt_threads.a add-on
+ *             (link with -pthread).
+ *
+ *  Usage:     call tc_thread_pool_run with a task function and its argument;
+ *             the task receives the index of the task to run. Runs from
+ *             different threads are serialized, and a task must not call
+ *             tc_thread_pool_run itself.
+ */
+
+#ifndef __TC_THREAD_POOL_H__
+#define __TC_THREAD_POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* threads running the tasks of one call, the calling thread included */
+#ifndef TC_THREAD_POOL_MAX_THREADS
+#define TC_THREAD_POOL_MAX_THREADS 64
+#endif
+
+/* runs task number i of the argument arg */
+typedef void (*TCThreadPoolTask_t)(void *arg, unsigned int i);
+
+/**
+ *  @brief Runs task(arg, i) for every i in [0, ntasks) on up to nthreads
+ *  threads, the calling thread included, and waits for all of them
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                task == NULL or
+ *                nthreads == 0
+ *  @note nthreads is capped to TC_THREAD_POOL_MAX_THREADS. If workers
+ *        cannot be created, the tasks run on the threads available, down to
+ *        the calling thread alone.
+ *  @param task IN -- the task function
+ *  @param arg IN -- argument passed to every task
+ *  @param ntasks IN -- number of tasks
+ *  @param nthreads IN -- maximum number of threads running the tasks
+ */
+int tc_thread_pool_run(TCThreadPoolTask_t task, void *arg,
+		       unsigned int ntasks, unsigned int nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_THREAD_POOL_H__ */
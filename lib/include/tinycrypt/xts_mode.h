@@ -0,0 +1,197 @@
+/* xts_mode.h - TinyCrypt interface to XTS mode */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Interface to XTS mode.
+ *
+ *  Overview:  XTS (XEX-based tweaked-codebook mode with ciphertext stealing)
+ *             is a NIST approved mode of operation defined in IEEE Std 1619
+ *             and SP 800-38E, intended for the encryption of data on storage
+ *             devices. Each data unit (e.g. a disk sector) is encrypted under
+ *             a tweak derived from its data unit sequence number, so that
+ *             ciphertext can be read and written one data unit at a time
+ *             without storing an IV. TinyCrypt hard codes AES128 as the block
+ *             cipher (XTS-AES-128).
+ *
+ *  Security:  XTS provides confidentiality only; it provides NO data
+ *             integrity, and identical plaintext written to the same data
+ *             unit gives identical ciphertext.
+ *
+ *             XTS-AES-128 uses two independent 128-bit keys: key1 encrypts
+ *             the data and key2 encrypts the tweak. The two keys must be
+ *             different; every XTS procedure fails if key1 == key2.
+ *
+ *             SP 800-38E limits a data unit to 2^20 AES blocks; TinyCrypt
+ *             accepts data units of any length from 16 bytes up to that
+ *             limit. Lengths which are not a multiple of 16 bytes are handled
+ *             by ciphertext stealing.
+ *
+ *  Requires:  AES-128
+ *
+ *  Usage:     1) call tc_aes128_set_encrypt_key to set key2 into the tweak key
+ *             schedule, and tc_aes128_set_encrypt_key (to encrypt) or
+ *             tc_aes128_set_decrypt_key (to decrypt) to set key1 into the data
+ *             key schedule.
+ *
+ *             2) call tc_xts_mode_encrypt/decrypt to process one data unit,
+ *             or tc_xts_mode_encrypt/decrypt_sectors to process a batch of
+ *             consecutive equally-sized sectors (e.g. 4 KiB sectors).
+ */
+
+#ifndef __TC_XTS_MODE_H__
+#define __TC_XTS_MODE_H__
+
+#include <tinycrypt/aes.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maximum length of a data unit, in bytes (2^20 blocks) */
+#define TC_XTS_MAX_DATA_UNIT (((uint32_t) 1 << 20) * TC_AES_BLOCK_SIZE)
+
+/**
+ *  @brief XTS data unit encryption procedure
+ *  Encrypts len bytes of in into out under the given tweak
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                tweak == NULL or
+ *                data_sched == NULL or
+ *                tweak_sched == NULL or
+ *                key1 == key2 or
+ *                len < TC_AES_BLOCK_SIZE or
+ *                len > TC_XTS_MAX_DATA_UNIT
+ *  @note Assumes: - data_sched was set by tc_aes128_set_encrypt_key(key1)
+ *              - tweak_sched was set by tc_aes128_set_encrypt_key(key2)
+ *              - out and in point to len bytes; they may be the same buffer
+ *  @param out OUT -- buffer to receive the ciphertext
+ *  @param in IN -- plaintext to encrypt
+ *  @param len IN -- length of the data unit in bytes
+ *  @param tweak IN -- 16 byte tweak value (the data unit sequence number,
+ *                     little-endian, for IEEE Std 1619)
+ *  @param data_sched IN -- AES key schedule of key1
+ *  @param tweak_sched IN -- AES key schedule of key2
+ */
+int tc_xts_mode_encrypt(uint8_t *out, const uint8_t *in, unsigned int len,
+			const uint8_t *tweak, const TCAesKeySched_t data_sched,
+			const TCAesKeySched_t tweak_sched);
+
+/**
+ *  @brief XTS data unit decryption procedure
+ *  Decrypts len bytes of in into out under the given tweak
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                out == NULL or
+ *                in == NULL or
+ *                tweak == NULL or
+ *                data_sched == NULL or
+ *                tweak_sched == NULL or
+ *                key1 == key2 or
+ *                len < TC_AES_BLOCK_SIZE or
+ *                len > TC_XTS_MAX_DATA_UNIT
+ *  @note Assumes: - data_sched was set by tc_aes128_set_decrypt_key(key1)
+ *              - tweak_sched was set by tc_aes128_set_encrypt_key(key2)
+ *              - out and in point to len bytes; they may be the same buffer
+ *  @param out OUT -- buffer to receive the plaintext
+ *  @param in IN -- ciphertext to decrypt
+ *  @param len IN -- length of the data unit in bytes
+ *  @param tweak IN -- 16 byte tweak value used to encrypt the data unit
+ *  @param data_sched IN -- AES key schedule of key1
+ *  @param tweak_sched IN -- AES key schedule of key2
+ */
+int tc_xts_mode_decrypt(uint8_t *out, const uint8_t *in, unsigned int len,
+			const uint8_t *tweak, const TCAesKeySched_t data_sched,
+			const TCAesKeySched_t tweak_sched);
+
+/**
+ *  @brief XTS multi-sector encryption procedure
+ *  Encrypts len bytes of in into out as consecutive sectors of sector_size
+ *  bytes, the first one having sequence number sector; the tweak of each
+ *  sector is its sequence number encoded in little-endian
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                any pointer is NULL or
+ *                key1 == key2 or
+ *                sector_size < TC_AES_BLOCK_SIZE or
+ *                sector_size > TC_XTS_MAX_DATA_UNIT or
+ *                len == 0 or
+ *                (len % sector_size) != 0
+ *  @note Assumes the same key schedules as tc_xts_mode_encrypt
+ *  @param out OUT -- buffer to receive the ciphertext
+ *  @param in IN -- plaintext to encrypt
+ *  @param len IN -- length of in in bytes, a multiple of sector_size
+ *  @param sector_size IN -- size of each sector in bytes
+ *  @param sector IN -- sequence number of the first sector
+ *  @param data_sched IN -- AES key schedule of key1
+ *  @param tweak_sched IN -- AES key schedule of key2
+ */
+int tc_xts_mode_encrypt_sectors(uint8_t *out, const uint8_t *in, size_t len,
+				unsigned int sector_size, uint64_t sector,
+				const TCAesKeySched_t data_sched,
+				const TCAesKeySched_t tweak_sched);
+
+/**
+ *  @brief XTS multi-sector decryption procedure
+ *  Decrypts len bytes of in into out as consecutive sectors of sector_size
+ *  bytes, the first one having sequence number sector
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                any pointer is NULL or
+ *                key1 == key2 or
+ *                sector_size < TC_AES_BLOCK_SIZE or
+ *                sector_size > TC_XTS_MAX_DATA_UNIT or
+ *                len == 0 or
+ *                (len % sector_size) != 0
+ *  @note Assumes the same key schedules as tc_xts_mode_decrypt
+ *  @param out OUT -- buffer to receive the plaintext
+ *  @param in IN -- ciphertext to decrypt
+ *  @param len IN -- length of in in bytes, a multiple of sector_size
+ *  @param sector_size IN -- size of each sector in bytes
+ *  @param sector IN -- sequence number of the first sector
+ *  @param data_sched IN -- AES key schedule of key1
+ *  @param tweak_sched IN -- AES key schedule of key2
+ */
+int tc_xts_mode_decrypt_sectors(uint8_t *out, const uint8_t *in, size_t len,
+				unsigned int sector_size, uint64_t sector,
+				const TCAesKeySched_t data_sched,
+				const TCAesKeySched_t tweak_sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TC_XTS_MODE_H__ */
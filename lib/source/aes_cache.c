@@ -0,0 +1,238 @@
+/* aes_cache.c - TinyCrypt implementation of an AES-128 key schedule cache */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/aes_cache.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#define ROTL64(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+static uint64_t load64_le(const uint8_t *p)
+{
+	uint64_t v = 0;
+	unsigned int i;
+
+	for (i = 8; i > 0; --i) {
+		v = (v << 8) | p[i - 1];
+	}
+	return v;
+}
+
+#define SIPROUND(v0, v1, v2, v3) \
+	do { \
+		v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+		v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2; \
+		v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0; \
+		v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+	} while (0)
+
+/*
+ * Returns SipHash-2-4 of the TC_AES_KEY_SIZE bytes of key under the hash key
+ * of cache. The hash key is secret, so an adversary choosing the AES keys
+ * cannot predict which of them share a set.
+ */
+static uint64_t hash(TCAesCache_t cache, const uint8_t *key)
+{
+	uint64_t v0 = cache->hash_key[0] ^ 0x736f6d6570736575ULL;
+	uint64_t v1 = cache->hash_key[1] ^ 0x646f72616e646f6dULL;
+	uint64_t v2 = cache->hash_key[0] ^ 0x6c7967656e657261ULL;
+	uint64_t v3 = cache->hash_key[1] ^ 0x7465646279746573ULL;
+	uint64_t m[3];
+	unsigned int i;
+
+	/* two message words, then the final word holding the length */
+	m[0] = load64_le(key);
+	m[1] = load64_le(&key[8]);
+	m[2] = (uint64_t) TC_AES_KEY_SIZE << 56;
+	for (i = 0; i < 3; ++i) {
+		v3 ^= m[i];
+		SIPROUND(v0, v1, v2, v3);
+		SIPROUND(v0, v1, v2, v3);
+		v0 ^= m[i];
+	}
+
+	v2 ^= 0xff;
+	SIPROUND(v0, v1, v2, v3);
+	SIPROUND(v0, v1, v2, v3);
+	SIPROUND(v0, v1, v2, v3);
+	SIPROUND(v0, v1, v2, v3);
+
+	return v0 ^ v1 ^ v2 ^ v3;
+}
+
+int tc_aes_cache_init(TCAesCache_t cache,
+		      struct tc_aes_cache_entry_struct *entries,
+		      unsigned int num_entries, const uint8_t *hash_key)
+{
+	/* input sanity check: */
+	if (cache == (TCAesCache_t) 0 ||
+	    entries == (struct tc_aes_cache_entry_struct *) 0 ||
+	    hash_key == (const uint8_t *) 0 ||
+	    num_entries == 0 ||
+	    (num_entries > TC_AES_CACHE_WAYS &&
+	     num_entries % TC_AES_CACHE_WAYS != 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	cache->entries = entries;
+	cache->num_entries = num_entries;
+	cache->ways = (num_entries < TC_AES_CACHE_WAYS) ?
+		      num_entries : TC_AES_CACHE_WAYS;
+	cache->num_sets = num_entries / cache->ways;
+	cache->hash_key[0] = load64_le(hash_key);
+	cache->hash_key[1] = load64_le(&hash_key[8]);
+
+	return tc_aes_cache_erase(cache);
+}
+
+/*
+ * Returns the first entry of the set where key may be cached.
+ */
+static struct tc_aes_cache_entry_struct *set_of(TCAesCache_t cache,
+						const uint8_t *key)
+{
+	/* maps the high half of the hash to [0, num_sets) without a division */
+	unsigned int set = (unsigned int)
+		(((hash(cache, key) >> 32) * cache->num_sets) >> 32);
+
+	return &cache->entries[set * cache->ways];
+}
+
+/*
+ * Returns the entry of set holding key, or NULL if key is not in cache.
+ */
+static struct tc_aes_cache_entry_struct *find(TCAesCache_t cache,
+					      struct tc_aes_cache_entry_struct *set,
+					      const uint8_t *key)
+{
+	struct tc_aes_cache_entry_struct *e;
+	unsigned int i;
+
+	for (i = 0; i < cache->ways; ++i) {
+		e = &set[i];
+		if (e->valid && _compare(e->key, key, TC_AES_KEY_SIZE) == 0) {
+			return e;
+		}
+	}
+
+	return (struct tc_aes_cache_entry_struct *) 0;
+}
+
+/*
+ * Selects the entry of set to be replaced following the CLOCK policy: the
+ * hand of the set sweeps its entries, giving referenced entries a second
+ * chance, and stops at the first free or unreferenced entry.
+ */
+static struct tc_aes_cache_entry_struct *victim(TCAesCache_t cache,
+						struct tc_aes_cache_entry_struct *set)
+{
+	struct tc_aes_cache_entry_struct *e;
+
+	for (;;) {
+		e = &set[set->hand];
+		set->hand = (uint8_t) ((set->hand + 1) % cache->ways);
+		if (!e->valid || !e->referenced) {
+			return e;
+		}
+		e->referenced = 0;
+	}
+}
+
+/*
+ * Zeroizes the key and key schedule held by e, leaving the clock hand of its
+ * set in place.
+ */
+static void wipe(struct tc_aes_cache_entry_struct *e)
+{
+	_set_secure(&e->sched, 0, sizeof(e->sched));
+	_set_secure(e->key, 0, sizeof(e->key));
+	e->valid = 0;
+	e->referenced = 0;
+}
+
+TCAesKeySched_t tc_aes_cache_lookup(TCAesCache_t cache, const uint8_t *key)
+{
+	struct tc_aes_cache_entry_struct *set;
+	struct tc_aes_cache_entry_struct *e;
+
+	/* input sanity check: */
+	if (cache == (TCAesCache_t) 0 ||
+	    key == (const uint8_t *) 0) {
+		return (TCAesKeySched_t) 0;
+	}
+
+	set = set_of(cache, key);
+	e = find(cache, set, key);
+	if (e == (struct tc_aes_cache_entry_struct *) 0) {
+		e = victim(cache, set);
+
+		/* securely drop the replaced key before reusing its entry */
+		wipe(e);
+		(void)tc_aes128_set_encrypt_key(&e->sched, key);
+		(void)_copy(e->key, sizeof(e->key), key, TC_AES_KEY_SIZE);
+		e->valid = 1;
+	}
+	e->referenced = 1;
+
+	return &e->sched;
+}
+
+int tc_aes_cache_evict(TCAesCache_t cache, const uint8_t *key)
+{
+	struct tc_aes_cache_entry_struct *e;
+
+	/* input sanity check: */
+	if (cache == (TCAesCache_t) 0 ||
+	    key == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	e = find(cache, set_of(cache, key), key);
+	if (e != (struct tc_aes_cache_entry_struct *) 0) {
+		wipe(e);
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_aes_cache_erase(TCAesCache_t cache)
+{
+	/* input sanity check: */
+	if (cache == (TCAesCache_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set_secure(cache->entries, 0,
+		    cache->num_entries * sizeof(cache->entries[0]));
+
+	return TC_CRYPTO_SUCCESS;
+}
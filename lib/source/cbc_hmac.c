@@ -0,0 +1,133 @@
+/* cbc_hmac.c - TinyCrypt stitched AES-CBC + HMAC-SHA256 implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/cbc_hmac.h>
+#include <tinycrypt/cbc_mode.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/* AES blocks encrypted before they are mixed into HMAC: one SHA-256 block */
+#define STITCH_BLOCKS (TC_SHA256_BLOCK_SIZE / TC_AES_BLOCK_SIZE)
+
+int tc_cbc_hmac_seal(uint8_t *out, size_t outlen, const uint8_t *in,
+		     size_t inlen, const uint8_t *iv,
+		     const TCAesKeySched_t sched, const TCHmacState_t mac)
+{
+	struct tc_hmac_state_struct h;
+	const uint8_t *chain;
+	uint8_t *group;
+	unsigned int n, i;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    iv == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    mac == (TCHmacState_t) 0 ||
+	    inlen == 0 ||
+	    (inlen % TC_AES_BLOCK_SIZE) != 0 ||
+	    outlen != inlen + TC_CBC_HMAC_OVERHEAD) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* work on a copy so that the caller's keyed state can be reused */
+	h = *mac;
+	(void)tc_hmac_init(&h);
+
+	(void)_copy(out, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+	(void)tc_hmac_update(&h, out, TC_AES_BLOCK_SIZE);
+	chain = out;
+	out += TC_AES_BLOCK_SIZE;
+
+	/*
+	 * Encrypt a SHA-256 block worth of AES blocks, then hash it while it
+	 * is still hot in cache, instead of hashing the whole ciphertext in a
+	 * second pass.
+	 */
+	while (inlen > 0) {
+		group = out;
+		for (n = 0; n < STITCH_BLOCKS && inlen > 0; ++n) {
+			for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
+				out[i] = chain[i] ^ in[i];
+			}
+			(void)tc_aes_encrypt(out, out, sched);
+			chain = out;
+			out += TC_AES_BLOCK_SIZE;
+			in += TC_AES_BLOCK_SIZE;
+			inlen -= TC_AES_BLOCK_SIZE;
+		}
+		(void)tc_hmac_update(&h, group, n * TC_AES_BLOCK_SIZE);
+	}
+
+	/* tc_hmac_final erases h */
+	return tc_hmac_final(out, TC_CBC_HMAC_TAG_SIZE, &h);
+}
+
+int tc_cbc_hmac_open(uint8_t *out, size_t outlen, const uint8_t *in,
+		     size_t inlen, const TCAesKeySched_t sched,
+		     const TCHmacState_t mac)
+{
+	struct tc_hmac_state_struct h;
+	uint8_t tag[TC_CBC_HMAC_TAG_SIZE];
+	size_t mlen;
+	int result;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    mac == (TCHmacState_t) 0 ||
+	    outlen == 0 ||
+	    (outlen % TC_AES_BLOCK_SIZE) != 0 ||
+	    inlen != outlen + TC_CBC_HMAC_OVERHEAD) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* authenticate iv || ciphertext before decrypting any of it */
+	mlen = inlen - TC_CBC_HMAC_TAG_SIZE;
+	h = *mac;
+	(void)tc_hmac_init(&h);
+	(void)tc_hmac_update_large(&h, in, mlen);
+	(void)tc_hmac_final(tag, sizeof(tag), &h);
+
+	if (_compare(tag, &in[mlen], sizeof(tag)) != 0) {
+		result = TC_CRYPTO_FAIL;
+	} else {
+		result = tc_cbc_mode_decrypt_large(out, outlen,
+						   &in[TC_AES_BLOCK_SIZE],
+						   outlen, in, sched);
+	}
+
+	_set_secure(tag, 0, sizeof(tag));
+
+	return result;
+}
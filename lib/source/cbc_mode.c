@@ -38,9 +38,17 @@ int tc_cbc_mode_encrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			    unsigned int inlen, const uint8_t *iv,
 			    const TCAesKeySched_t sched)
 {
+	return tc_cbc_mode_encrypt_large(out, outlen, in, inlen, iv, sched);
+}
+
+int tc_cbc_mode_encrypt_large(uint8_t *out, size_t outlen, const uint8_t *in,
+			      size_t inlen, const uint8_t *iv,
+			      const TCAesKeySched_t sched)
+{
 
 	uint8_t buffer[TC_AES_BLOCK_SIZE];
-	unsigned int n, m;
+	size_t n;
+	unsigned int m;
 
 	/* input sanity check: */
 	if (out == (uint8_t *) 0 ||
@@ -78,10 +86,18 @@ int tc_cbc_mode_decrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			    unsigned int inlen, const uint8_t *iv,
 			    const TCAesKeySched_t sched)
 {
+	return tc_cbc_mode_decrypt_large(out, outlen, in, inlen, iv, sched);
+}
+
+int tc_cbc_mode_decrypt_large(uint8_t *out, size_t outlen, const uint8_t *in,
+			      size_t inlen, const uint8_t *iv,
+			      const TCAesKeySched_t sched)
+{
 
 	uint8_t buffer[TC_AES_BLOCK_SIZE];
 	const uint8_t *p;
-	unsigned int n, m;
+	size_t n;
+	unsigned int m;
 
 	/* sanity check the inputs */
 	if (out == (uint8_t *) 0 ||
@@ -112,3 +128,194 @@ int tc_cbc_mode_decrypt(uint8_t *out, unsigned int outlen, const uint8_t *in,
 
 	return TC_CRYPTO_SUCCESS;
 }
+
+int tc_cbc_mode_encrypt_v(uint8_t *out, size_t outlen,
+			  const struct tc_iovec *iov, unsigned int iovcnt,
+			  const uint8_t *iv, const TCAesKeySched_t sched)
+{
+
+	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	const uint8_t *in;
+	size_t len, n;
+	unsigned int i, m;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    iv == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    !tc_iovec_length(&len, iov, iovcnt) ||
+	    len == 0 ||
+	    (len % TC_AES_BLOCK_SIZE) != 0 ||
+	    outlen < TC_AES_BLOCK_SIZE ||
+	    len != outlen - TC_AES_BLOCK_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* copy iv to the buffer */
+	(void)_copy(buffer, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+	/* copy iv to the output buffer */
+	(void)_copy(out, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+	out += TC_AES_BLOCK_SIZE;
+
+	/*
+	 * The plaintext is mixed into the chaining buffer one byte at a time,
+	 * so a block may straddle any number of segments.
+	 */
+	for (i = m = 0; i < iovcnt; ++i) {
+		in = iov[i].iov_base;
+		for (n = 0; n < iov[i].iov_len; ++n) {
+			buffer[m++] ^= *in++;
+			if (m == TC_AES_BLOCK_SIZE) {
+				(void)tc_aes_encrypt(buffer, buffer, sched);
+				(void)_copy(out, TC_AES_BLOCK_SIZE,
+					    buffer, TC_AES_BLOCK_SIZE);
+				out += TC_AES_BLOCK_SIZE;
+				m = 0;
+			}
+		}
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cbc_mode_decrypt_v(uint8_t *out, size_t outlen,
+			  const struct tc_iovec *iov, unsigned int iovcnt,
+			  const uint8_t *iv, const TCAesKeySched_t sched)
+{
+
+	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	uint8_t staged[TC_AES_BLOCK_SIZE];
+	uint8_t chain[TC_AES_BLOCK_SIZE];
+	const uint8_t *block;
+	const uint8_t *p = (const uint8_t *) 0;
+	size_t left = 0;
+	size_t len, n;
+	unsigned int m, i = 0;
+
+	/* sanity check the inputs */
+	if (out == (uint8_t *) 0 ||
+	    iv == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    !tc_iovec_length(&len, iov, iovcnt) ||
+	    outlen == 0 ||
+	    (outlen % TC_AES_BLOCK_SIZE) != 0 ||
+	    len != outlen) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)_copy(chain, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+
+	for (n = 0; n < outlen; n += TC_AES_BLOCK_SIZE) {
+		while (left == 0) {
+			p = iov[i].iov_base;
+			left = iov[i++].iov_len;
+		}
+		if (left >= TC_AES_BLOCK_SIZE) {
+			/* the whole block is in this segment */
+			block = p;
+			p += TC_AES_BLOCK_SIZE;
+			left -= TC_AES_BLOCK_SIZE;
+		} else {
+			/* the block straddles segments: gather it */
+			for (m = 0; m < TC_AES_BLOCK_SIZE; ++m) {
+				while (left == 0) {
+					p = iov[i].iov_base;
+					left = iov[i++].iov_len;
+				}
+				staged[m] = *p++;
+				--left;
+			}
+			block = staged;
+		}
+
+		(void)tc_aes_decrypt(buffer, block, sched);
+		for (m = 0; m < TC_AES_BLOCK_SIZE; ++m) {
+			*out++ = buffer[m] ^ chain[m];
+		}
+		(void)_copy(chain, TC_AES_BLOCK_SIZE, block, TC_AES_BLOCK_SIZE);
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cbc_mode_init(TCCbcMode_t c, const uint8_t *iv,
+		     const TCAesKeySched_t sched)
+{
+	/* input sanity check: */
+	if (c == (TCCbcMode_t) 0 ||
+	    iv == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)_copy(c->iv, TC_AES_BLOCK_SIZE, iv, TC_AES_BLOCK_SIZE);
+	c->sched = sched;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cbc_mode_encrypt_update(TCCbcMode_t c, uint8_t *out, const uint8_t *in,
+			       size_t len)
+{
+	unsigned int m;
+
+	/* input sanity check: */
+	if (c == (TCCbcMode_t) 0 ||
+	    (len > 0 && (out == (uint8_t *) 0 || in == (const uint8_t *) 0)) ||
+	    (len % TC_AES_BLOCK_SIZE) != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	for (; len > 0; len -= TC_AES_BLOCK_SIZE) {
+		for (m = 0; m < TC_AES_BLOCK_SIZE; ++m) {
+			c->iv[m] ^= in[m];
+		}
+		(void)tc_aes_encrypt(c->iv, c->iv, c->sched);
+		(void)_copy(out, TC_AES_BLOCK_SIZE, c->iv, TC_AES_BLOCK_SIZE);
+		out += TC_AES_BLOCK_SIZE;
+		in += TC_AES_BLOCK_SIZE;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cbc_mode_decrypt_update(TCCbcMode_t c, uint8_t *out, const uint8_t *in,
+			       size_t len)
+{
+	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	uint8_t next[TC_AES_BLOCK_SIZE];
+	unsigned int m;
+
+	/* input sanity check: */
+	if (c == (TCCbcMode_t) 0 ||
+	    (len > 0 && (out == (uint8_t *) 0 || in == (const uint8_t *) 0)) ||
+	    (len % TC_AES_BLOCK_SIZE) != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	for (; len > 0; len -= TC_AES_BLOCK_SIZE) {
+		/* keep the ciphertext block, out may overwrite it */
+		(void)_copy(next, TC_AES_BLOCK_SIZE, in, TC_AES_BLOCK_SIZE);
+		(void)tc_aes_decrypt(buffer, next, c->sched);
+		for (m = 0; m < TC_AES_BLOCK_SIZE; ++m) {
+			out[m] = buffer[m] ^ c->iv[m];
+		}
+		(void)_copy(c->iv, TC_AES_BLOCK_SIZE, next, TC_AES_BLOCK_SIZE);
+		out += TC_AES_BLOCK_SIZE;
+		in += TC_AES_BLOCK_SIZE;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_cbc_mode_erase(TCCbcMode_t c)
+{
+	if (c == (TCCbcMode_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* destroy the current state */
+	_set_secure(c, 0, sizeof(*c));
+
+	return TC_CRYPTO_SUCCESS;
+}
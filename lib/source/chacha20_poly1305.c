@@ -0,0 +1,554 @@
+/* chacha20_poly1305.c - TinyCrypt ChaCha20-Poly1305 AEAD implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/chacha20_poly1305.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/* Poly1305 block size in bytes */
+#define POLY1305_BLOCK_SIZE 16
+
+/* "expand 32-byte k" */
+static const uint32_t sigma[4] = {
+	0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+};
+
+static inline uint32_t load32_le(const uint8_t *p)
+{
+	return ((uint32_t) p[0]) | ((uint32_t) p[1] << 8) |
+	       ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline void store32_le(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t) v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void store64_le(uint8_t *p, uint64_t v)
+{
+	store32_le(p, (uint32_t) v);
+	store32_le(p + 4, (uint32_t)(v >> 32));
+}
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTERROUND(a, b, c, d) \
+	a += b; d ^= a; d = ROTL32(d, 16); \
+	c += d; b ^= c; b = ROTL32(b, 12); \
+	a += b; d ^= a; d = ROTL32(d, 8); \
+	c += d; b ^= c; b = ROTL32(b, 7)
+
+/*
+ *  assumes: out points to TC_CHACHA20_BLOCK_SIZE bytes, input to the 16
+ *           words of the ChaCha20 input block
+ *  effects: writes the keystream block of input into out
+ */
+static void chacha20_block(uint8_t *out, const uint32_t *input)
+{
+	uint32_t x[16];
+	unsigned int i;
+
+	for (i = 0; i < 16; ++i) {
+		x[i] = input[i];
+	}
+	for (i = 0; i < 10; ++i) {
+		/* column round */
+		QUARTERROUND(x[0], x[4], x[8], x[12]);
+		QUARTERROUND(x[1], x[5], x[9], x[13]);
+		QUARTERROUND(x[2], x[6], x[10], x[14]);
+		QUARTERROUND(x[3], x[7], x[11], x[15]);
+		/* diagonal round */
+		QUARTERROUND(x[0], x[5], x[10], x[15]);
+		QUARTERROUND(x[1], x[6], x[11], x[12]);
+		QUARTERROUND(x[2], x[7], x[8], x[13]);
+		QUARTERROUND(x[3], x[4], x[9], x[14]);
+	}
+	for (i = 0; i < 16; ++i) {
+		store32_le(&out[4 * i], x[i] + input[i]);
+	}
+
+	_set_secure(x, 0, sizeof(x));
+}
+
+/*
+ *  assumes: s != NULL and block points to POLY1305_BLOCK_SIZE bytes
+ *  effects: mixes one full block into the Poly1305 accumulator, computing
+ *           h = (h + block + 2^128) * r mod 2^130 - 5 with 26-bit limbs so
+ *           that all products fit in 64 bits
+ */
+static void poly1305_block(TCChaChaPolyStream_t s, const uint8_t *block)
+{
+	const uint32_t mask = 0x3ffffff;
+	uint32_t r0 = s->r[0], r1 = s->r[1], r2 = s->r[2];
+	uint32_t r3 = s->r[3], r4 = s->r[4];
+	uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+	uint32_t h0, h1, h2, h3, h4, c;
+	uint64_t d0, d1, d2, d3, d4;
+
+	h0 = s->h[0] + (load32_le(&block[0]) & mask);
+	h1 = s->h[1] + ((load32_le(&block[3]) >> 2) & mask);
+	h2 = s->h[2] + ((load32_le(&block[6]) >> 4) & mask);
+	h3 = s->h[3] + ((load32_le(&block[9]) >> 6) & mask);
+	h4 = s->h[4] + ((load32_le(&block[12]) >> 8) | ((uint32_t) 1 << 24));
+
+	d0 = (uint64_t) h0 * r0 + (uint64_t) h1 * s4 + (uint64_t) h2 * s3 +
+	     (uint64_t) h3 * s2 + (uint64_t) h4 * s1;
+	d1 = (uint64_t) h0 * r1 + (uint64_t) h1 * r0 + (uint64_t) h2 * s4 +
+	     (uint64_t) h3 * s3 + (uint64_t) h4 * s2;
+	d2 = (uint64_t) h0 * r2 + (uint64_t) h1 * r1 + (uint64_t) h2 * r0 +
+	     (uint64_t) h3 * s4 + (uint64_t) h4 * s3;
+	d3 = (uint64_t) h0 * r3 + (uint64_t) h1 * r2 + (uint64_t) h2 * r1 +
+	     (uint64_t) h3 * r0 + (uint64_t) h4 * s4;
+	d4 = (uint64_t) h0 * r4 + (uint64_t) h1 * r3 + (uint64_t) h2 * r2 +
+	     (uint64_t) h3 * r1 + (uint64_t) h4 * r0;
+
+	/* partial carry propagation */
+	c = (uint32_t)(d0 >> 26); h0 = (uint32_t) d0 & mask;
+	d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t) d1 & mask;
+	d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t) d2 & mask;
+	d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t) d3 & mask;
+	d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t) d4 & mask;
+	h0 += c * 5; c = h0 >> 26; h0 &= mask;
+	h1 += c;
+
+	s->h[0] = h0; s->h[1] = h1; s->h[2] = h2; s->h[3] = h3; s->h[4] = h4;
+}
+
+/*
+ *  assumes: s != NULL and data points to len bytes
+ *  effects: mixes data into the Poly1305 accumulator, buffering the bytes
+ *           that don't fill a block
+ */
+static void poly1305_update(TCChaChaPolyStream_t s, const uint8_t *data,
+			    size_t len)
+{
+	if (s->leftover_offset > 0) {
+		while (len > 0 && s->leftover_offset < POLY1305_BLOCK_SIZE) {
+			s->leftover[s->leftover_offset++] = *data++;
+			--len;
+		}
+		if (s->leftover_offset < POLY1305_BLOCK_SIZE) {
+			return;
+		}
+		poly1305_block(s, s->leftover);
+		s->leftover_offset = 0;
+	}
+	while (len >= POLY1305_BLOCK_SIZE) {
+		poly1305_block(s, data);
+		data += POLY1305_BLOCK_SIZE;
+		len -= POLY1305_BLOCK_SIZE;
+	}
+	while (len > 0) {
+		s->leftover[s->leftover_offset++] = *data++;
+		--len;
+	}
+}
+
+/*
+ *  assumes: s != NULL
+ *  effects: zero pads the data mixed so far to a multiple of 16 bytes, as
+ *           RFC 8439 does between the associated data and the ciphertext
+ */
+static void poly1305_pad(TCChaChaPolyStream_t s)
+{
+	if (s->leftover_offset > 0) {
+		_set(&s->leftover[s->leftover_offset], 0,
+		     POLY1305_BLOCK_SIZE - s->leftover_offset);
+		poly1305_block(s, s->leftover);
+		s->leftover_offset = 0;
+	}
+}
+
+/*
+ *  assumes: tag != NULL, s != NULL and all the data mixed so far is padded
+ *  effects: writes h + s mod 2^128 into tag; the reduction mod 2^130 - 5 is
+ *           done with masks instead of branches
+ */
+static void poly1305_finish(uint8_t *tag, TCChaChaPolyStream_t s)
+{
+	const uint32_t mask26 = 0x3ffffff;
+	uint32_t h0 = s->h[0], h1 = s->h[1], h2 = s->h[2];
+	uint32_t h3 = s->h[3], h4 = s->h[4];
+	uint32_t g0, g1, g2, g3, g4, c, mask;
+	uint64_t f;
+
+	/* fully carry h */
+	c = h1 >> 26; h1 &= mask26;
+	h2 += c; c = h2 >> 26; h2 &= mask26;
+	h3 += c; c = h3 >> 26; h3 &= mask26;
+	h4 += c; c = h4 >> 26; h4 &= mask26;
+	h0 += c * 5; c = h0 >> 26; h0 &= mask26;
+	h1 += c;
+
+	/* compute g = h + 5 - 2^130 */
+	g0 = h0 + 5; c = g0 >> 26; g0 &= mask26;
+	g1 = h1 + c; c = g1 >> 26; g1 &= mask26;
+	g2 = h2 + c; c = g2 >> 26; g2 &= mask26;
+	g3 = h3 + c; c = g3 >> 26; g3 &= mask26;
+	g4 = h4 + c - ((uint32_t) 1 << 26);
+
+	/* select h if h < 2^130 - 5, g otherwise */
+	mask = (g4 >> 31) - 1;
+	g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+	mask = ~mask;
+	h0 = (h0 & mask) | g0;
+	h1 = (h1 & mask) | g1;
+	h2 = (h2 & mask) | g2;
+	h3 = (h3 & mask) | g3;
+	h4 = (h4 & mask) | g4;
+
+	/* h = h % 2^128, packed into 32-bit words */
+	h0 = h0 | (h1 << 26);
+	h1 = (h1 >> 6) | (h2 << 20);
+	h2 = (h2 >> 12) | (h3 << 14);
+	h3 = (h3 >> 18) | (h4 << 8);
+
+	/* tag = (h + s) % 2^128 */
+	f = (uint64_t) h0 + s->pad[0]; store32_le(&tag[0], (uint32_t) f);
+	f = (uint64_t) h1 + s->pad[1] + (f >> 32);
+	store32_le(&tag[4], (uint32_t) f);
+	f = (uint64_t) h2 + s->pad[2] + (f >> 32);
+	store32_le(&tag[8], (uint32_t) f);
+	f = (uint64_t) h3 + s->pad[3] + (f >> 32);
+	store32_le(&tag[12], (uint32_t) f);
+}
+
+/*
+ *  assumes: s != NULL, out and in point to len bytes
+ *  effects: XORs the next len bytes of keystream into out, generating whole
+ *           ChaCha20 blocks straight into out when the stream is aligned
+ */
+static void chacha20_xor(TCChaChaPolyStream_t s, uint8_t *out,
+			 const uint8_t *in, size_t len)
+{
+	unsigned int i;
+
+	while (len > 0 && s->keystream_offset < TC_CHACHA20_BLOCK_SIZE) {
+		*out++ = *in++ ^ s->keystream[s->keystream_offset++];
+		--len;
+	}
+	while (len >= TC_CHACHA20_BLOCK_SIZE) {
+		chacha20_block(s->keystream, s->input);
+		++s->input[12];
+		for (i = 0; i < TC_CHACHA20_BLOCK_SIZE; ++i) {
+			out[i] = in[i] ^ s->keystream[i];
+		}
+		out += TC_CHACHA20_BLOCK_SIZE;
+		in += TC_CHACHA20_BLOCK_SIZE;
+		len -= TC_CHACHA20_BLOCK_SIZE;
+	}
+	if (len > 0) {
+		chacha20_block(s->keystream, s->input);
+		++s->input[12];
+		for (i = 0; i < len; ++i) {
+			out[i] = in[i] ^ s->keystream[i];
+		}
+		s->keystream_offset = (unsigned int) len;
+	}
+}
+
+/*
+ *  assumes: tag != NULL and s != NULL
+ *  effects: closes the Poly1305 input with the padded ciphertext and the
+ *           length block, and writes the tag
+ */
+static void compute_tag(uint8_t *tag, TCChaChaPolyStream_t s)
+{
+	uint8_t lengths[POLY1305_BLOCK_SIZE];
+
+	poly1305_pad(s);
+	store64_le(&lengths[0], s->alen);
+	store64_le(&lengths[8], s->plen);
+	poly1305_block(s, lengths);
+	poly1305_finish(tag, s);
+}
+
+/*
+ *  assumes: s != NULL
+ *  effects: checks that len more bytes of payload can be processed and, on
+ *           the first payload segment, pads the associated data
+ */
+static int start_payload(TCChaChaPolyStream_t s, size_t len)
+{
+	if ((uint64_t) len > TC_CHACHA20_POLY1305_MAX_BYTES - s->plen) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (!s->aad_done) {
+		poly1305_pad(s);
+		s->aad_done = 1;
+	}
+	s->plen += len;
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_config(TCChaChaPolyMode_t c, const uint8_t *key,
+				const uint8_t *nonce, unsigned int nlen)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (c == (TCChaChaPolyMode_t) 0 ||
+	    key == (const uint8_t *) 0 ||
+	    nonce == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	} else if (nlen != TC_CHACHA20_POLY1305_NONCE_SIZE) {
+		return TC_CRYPTO_FAIL; /* The allowed nonce size is: 12. See documentation.*/
+	}
+
+	for (i = 0; i < TC_CHACHA20_KEY_SIZE / 4; ++i) {
+		c->key[i] = load32_le(&key[4 * i]);
+	}
+	for (i = 0; i < TC_CHACHA20_POLY1305_NONCE_SIZE / 4; ++i) {
+		c->nonce[i] = load32_le(&nonce[4 * i]);
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_erase(TCChaChaPolyMode_t c)
+{
+	if (c == (TCChaChaPolyMode_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set_secure(c, 0, sizeof(*c));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_stream_init(TCChaChaPolyStream_t s,
+				     const TCChaChaPolyMode_t c)
+{
+	uint8_t otk[TC_CHACHA20_BLOCK_SIZE];
+	unsigned int i;
+
+	/* input sanity check: */
+	if (s == (TCChaChaPolyStream_t) 0 ||
+	    c == (TCChaChaPolyMode_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(s, 0, sizeof(*s));
+	for (i = 0; i < 4; ++i) {
+		s->input[i] = sigma[i];
+	}
+	for (i = 0; i < 8; ++i) {
+		s->input[4 + i] = c->key[i];
+	}
+	s->input[12] = 0;
+	for (i = 0; i < 3; ++i) {
+		s->input[13 + i] = c->nonce[i];
+	}
+
+	/* block 0 gives the one-time Poly1305 key; the payload starts at 1 */
+	chacha20_block(otk, s->input);
+	s->input[12] = 1;
+	s->keystream_offset = TC_CHACHA20_BLOCK_SIZE;
+
+	/* r is clamped as required by Poly1305 */
+	s->r[0] = load32_le(&otk[0]) & 0x3ffffff;
+	s->r[1] = (load32_le(&otk[3]) >> 2) & 0x3ffff03;
+	s->r[2] = (load32_le(&otk[6]) >> 4) & 0x3ffc0ff;
+	s->r[3] = (load32_le(&otk[9]) >> 6) & 0x3f03fff;
+	s->r[4] = (load32_le(&otk[12]) >> 8) & 0x00fffff;
+	for (i = 0; i < 4; ++i) {
+		s->pad[i] = load32_le(&otk[16 + 4 * i]);
+	}
+
+	_set_secure(otk, 0, sizeof(otk));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_stream_aad(TCChaChaPolyStream_t s,
+				    const uint8_t *associated_data,
+				    size_t alen)
+{
+	/* input sanity check: */
+	if (s == (TCChaChaPolyStream_t) 0 ||
+	    (alen > 0 && associated_data == (const uint8_t *) 0) ||
+	    s->aad_done) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	poly1305_update(s, associated_data, alen);
+	s->alen += alen;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_stream_encrypt(TCChaChaPolyStream_t s, uint8_t *out,
+					const uint8_t *in, size_t len)
+{
+	/* input sanity check: */
+	if (s == (TCChaChaPolyStream_t) 0 ||
+	    (len > 0 && (out == (uint8_t *) 0 || in == (const uint8_t *) 0))) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (!start_payload(s, len)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	chacha20_xor(s, out, in, len);
+	poly1305_update(s, out, len);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_stream_decrypt(TCChaChaPolyStream_t s, uint8_t *out,
+					const uint8_t *in, size_t len)
+{
+	/* input sanity check: */
+	if (s == (TCChaChaPolyStream_t) 0 ||
+	    (len > 0 && (out == (uint8_t *) 0 || in == (const uint8_t *) 0))) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (!start_payload(s, len)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* MAC the ciphertext first, in case out and in are the same buffer */
+	poly1305_update(s, in, len);
+	chacha20_xor(s, out, in, len);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_stream_final(uint8_t *tag, TCChaChaPolyStream_t s)
+{
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    s == (TCChaChaPolyStream_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	compute_tag(tag, s);
+
+	/* destroy the current state */
+	_set_secure(s, 0, sizeof(*s));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_chacha20_poly1305_stream_verify(const uint8_t *tag,
+				       TCChaChaPolyStream_t s)
+{
+	uint8_t expected[TC_CHACHA20_POLY1305_TAG_SIZE];
+	int result;
+
+	/* input sanity check: */
+	if (tag == (const uint8_t *) 0 ||
+	    s == (TCChaChaPolyStream_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	compute_tag(expected, s);
+	result = _compare(expected, tag, sizeof(expected)) == 0 ?
+		 TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+
+	/* destroy the current state */
+	_set_secure(s, 0, sizeof(*s));
+	_set_secure(expected, 0, sizeof(expected));
+
+	return result;
+}
+
+int tc_chacha20_poly1305_seal(uint8_t *out, unsigned int olen,
+			      const uint8_t *associated_data,
+			      unsigned int alen, const uint8_t *payload,
+			      unsigned int plen, TCChaChaPolyMode_t c)
+{
+	struct tc_chacha20_poly1305_stream_struct s;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    c == (TCChaChaPolyMode_t) 0 ||
+	    (plen > 0 && payload == (const uint8_t *) 0) ||
+	    (alen > 0 && associated_data == (const uint8_t *) 0) ||
+	    olen < TC_CHACHA20_POLY1305_TAG_SIZE ||
+	    plen > olen - TC_CHACHA20_POLY1305_TAG_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_chacha20_poly1305_stream_init(&s, c);
+	(void)tc_chacha20_poly1305_stream_aad(&s, associated_data, alen);
+	(void)tc_chacha20_poly1305_stream_encrypt(&s, out, payload, plen);
+
+	return tc_chacha20_poly1305_stream_final(&out[plen], &s);
+}
+
+int tc_chacha20_poly1305_open(uint8_t *out, unsigned int olen,
+			      const uint8_t *associated_data,
+			      unsigned int alen, const uint8_t *payload,
+			      unsigned int plen, TCChaChaPolyMode_t c)
+{
+	struct tc_chacha20_poly1305_stream_struct s;
+	uint8_t tag[TC_CHACHA20_POLY1305_TAG_SIZE];
+	unsigned int clen;
+	int result;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    c == (TCChaChaPolyMode_t) 0 ||
+	    payload == (const uint8_t *) 0 ||
+	    (alen > 0 && associated_data == (const uint8_t *) 0) ||
+	    plen < TC_CHACHA20_POLY1305_TAG_SIZE ||
+	    olen < plen - TC_CHACHA20_POLY1305_TAG_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+	clen = plen - TC_CHACHA20_POLY1305_TAG_SIZE;
+
+	(void)tc_chacha20_poly1305_stream_init(&s, c);
+	(void)tc_chacha20_poly1305_stream_aad(&s, associated_data, alen);
+
+	/* authenticate the ciphertext before decrypting any of it */
+	(void)start_payload(&s, clen);
+	poly1305_update(&s, payload, clen);
+	compute_tag(tag, &s);
+
+	if (_compare(tag, &payload[clen], sizeof(tag)) == 0) {
+		/* the keystream of s is still positioned at block 1 */
+		chacha20_xor(&s, out, payload, clen);
+		result = TC_CRYPTO_SUCCESS;
+	} else {
+		_set(out, 0, clen);
+		result = TC_CRYPTO_FAIL;
+	}
+
+	_set_secure(&s, 0, sizeof(s));
+	_set_secure(tag, 0, sizeof(tag));
+
+	return result;
+}
@@ -35,6 +35,8 @@
 #include <tinycrypt/constants.h>
 #include <tinycrypt/utils.h>
 
+#include <string.h>
+
 /* max number of calls until change the key (2^48).*/
 static const uint64_t MAX_CALLS = ((uint64_t)1 << 48);
 
@@ -154,60 +156,89 @@ int tc_cmac_init(TCCmacState_t s)
 	return TC_CRYPTO_SUCCESS;
 }
 
-int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t data_length)
+/*
+ *  assumes: out and in point to TC_AES_BLOCK_SIZE byte buffers
+ *  effects: XORs the block in into the block out, one word at a time
+ */
+static inline void xor_block(uint8_t *out, const uint8_t *in)
 {
+	unsigned int a[TC_AES_BLOCK_SIZE / sizeof(unsigned int)];
+	unsigned int b[TC_AES_BLOCK_SIZE / sizeof(unsigned int)];
 	unsigned int i;
 
-	/* input sanity check: */
-	if (s == (TCCmacState_t) 0) {
-		return TC_CRYPTO_FAIL;
-	}
-	if (data_length == 0) {
-		return  TC_CRYPTO_SUCCESS;
-	}
-	if (data == (const uint8_t *) 0) {
-		return TC_CRYPTO_FAIL;
+	/* memcpy keeps this portable to targets with strict alignment */
+	(void)memcpy(a, out, sizeof(a));
+	(void)memcpy(b, in, sizeof(b));
+	for (i = 0; i < sizeof(a) / sizeof(a[0]); ++i) {
+		a[i] ^= b[i];
 	}
+	(void)memcpy(out, a, sizeof(a));
+}
 
-	if (s->countdown == 0) {
-		return TC_CRYPTO_FAIL;
+/*
+ *  assumes: s != NULL and data points to nblocks full blocks
+ *  effects: CBC encrypts the nblocks blocks of data into s->iv
+ */
+static void mix_blocks(TCCmacState_t s, const uint8_t *data, size_t nblocks)
+{
+	while (nblocks-- > 0) {
+		xor_block(s->iv, data);
+		tc_aes_encrypt(s->iv, s->iv, s->sched);
+		data += TC_AES_BLOCK_SIZE;
 	}
+}
 
-	s->countdown--;
+/*
+ *  assumes: s != NULL and data != NULL when data_length > 0
+ *  effects: mixes the data_length bytes of data into s, without charging
+ *           s->countdown
+ */
+static void absorb(TCCmacState_t s, const uint8_t *data, size_t data_length)
+{
+	unsigned int i;
 
 	if (s->leftover_offset > 0) {
 		/* last data added to s didn't end on a TC_AES_BLOCK_SIZE byte boundary */
 		size_t remaining_space = TC_AES_BLOCK_SIZE - s->leftover_offset;
 
-		if (data_length < remaining_space) {
-			/* still not enough data to encrypt this time either */
+		if (data_length <= remaining_space) {
+			/*
+			 * still not enough data to encrypt this time either: a
+			 * completed block may be the last one, which
+			 * tc_cmac_final mixes with K1, so it is kept until more
+			 * data arrives
+			 */
 			_copy(&s->leftover[s->leftover_offset], data_length, data, data_length);
 			s->leftover_offset += data_length;
-			return TC_CRYPTO_SUCCESS;
+			return;
+		}
+		/*
+		 * leftover block is now full; encrypt it first, mixing the
+		 * completing bytes straight from data instead of staging them
+		 */
+		for (i = 0; i < s->leftover_offset; ++i) {
+			s->iv[i] ^= s->leftover[i];
+		}
+		for (; i < TC_AES_BLOCK_SIZE; ++i) {
+			s->iv[i] ^= *data++;
 		}
-		/* leftover block is now full; encrypt it first */
-		_copy(&s->leftover[s->leftover_offset],
-		      remaining_space,
-		      data,
-		      remaining_space);
 		data_length -= remaining_space;
-		data += remaining_space;
 		s->leftover_offset = 0;
 
-		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
-			s->iv[i] ^= s->leftover[i];
-		}
 		tc_aes_encrypt(s->iv, s->iv, s->sched);
 	}
 
-	/* CBC encrypt each (except the last) of the data blocks */
-	while (data_length > TC_AES_BLOCK_SIZE) {
-		for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
-			s->iv[i] ^= data[i];
-		}
-		tc_aes_encrypt(s->iv, s->iv, s->sched);
-		data += TC_AES_BLOCK_SIZE;
-		data_length  -= TC_AES_BLOCK_SIZE;
+	/*
+	 * CBC encrypt each (except the last) of the data blocks in place from
+	 * data; the last block is kept for tc_cmac_final since it is mixed
+	 * with a subkey
+	 */
+	if (data_length > TC_AES_BLOCK_SIZE) {
+		size_t nblocks = (data_length - 1) / TC_AES_BLOCK_SIZE;
+
+		mix_blocks(s, data, nblocks);
+		data += nblocks * TC_AES_BLOCK_SIZE;
+		data_length -= nblocks * TC_AES_BLOCK_SIZE;
 	}
 
 	if (data_length > 0) {
@@ -215,21 +246,72 @@ int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t data_length)
 		_copy(s->leftover, data_length, data, data_length);
 		s->leftover_offset = data_length;
 	}
+}
+
+int tc_cmac_update(TCCmacState_t s, const uint8_t *data, size_t data_length)
+{
+	/* input sanity check: */
+	if (s == (TCCmacState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (data_length == 0) {
+		return  TC_CRYPTO_SUCCESS;
+	}
+	if (data == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (s->countdown == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	s->countdown--;
+
+	absorb(s, data, data_length);
 
 	return TC_CRYPTO_SUCCESS;
 }
 
-int tc_cmac_final(uint8_t *tag, TCCmacState_t s)
+int tc_cmac_update_v(TCCmacState_t s, const struct tc_iovec *iov,
+		     unsigned int iovcnt)
 {
-	uint8_t *k;
+	size_t len;
 	unsigned int i;
 
 	/* input sanity check: */
-	if (tag == (uint8_t *) 0 ||
-	    s == (TCCmacState_t) 0) {
+	if (s == (TCCmacState_t) 0 ||
+	    !tc_iovec_length(&len, iov, iovcnt)) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (len == 0) {
+		return TC_CRYPTO_SUCCESS;
+	}
+
+	/* one call, charged once like tc_cmac_update, whatever iovcnt is */
+	if (s->countdown == 0) {
 		return TC_CRYPTO_FAIL;
 	}
 
+	s->countdown--;
+
+	for (i = 0; i < iovcnt; ++i) {
+		if (iov[i].iov_len > 0) {
+			absorb(s, iov[i].iov_base, iov[i].iov_len);
+		}
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/*
+ *  assumes: tag != NULL and s != NULL
+ *  effects: mixes the last (padded) message block into s and encrypts it
+ *           into tag
+ */
+static void compute_tag(uint8_t *tag, TCCmacState_t s)
+{
+	uint8_t *k;
+
 	if (s->leftover_offset == TC_AES_BLOCK_SIZE) {
 		/* the last message block is a full-sized block */
 		k = (uint8_t *) s->K1;
@@ -241,14 +323,40 @@ int tc_cmac_final(uint8_t *tag, TCCmacState_t s)
 		s->leftover[s->leftover_offset] = TC_CMAC_PADDING;
 		k = (uint8_t *) s->K2;
 	}
-	for (i = 0; i < TC_AES_BLOCK_SIZE; ++i) {
-		s->iv[i] ^= s->leftover[i] ^ k[i];
-	}
+	xor_block(s->iv, s->leftover);
+	xor_block(s->iv, k);
 
 	tc_aes_encrypt(tag, s->iv, s->sched);
+}
+
+int tc_cmac_final(uint8_t *tag, TCCmacState_t s)
+{
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    s == (TCCmacState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	compute_tag(tag, s);
 
 	/* erasing state: */
 	tc_cmac_erase(s);
 
 	return TC_CRYPTO_SUCCESS;
 }
+
+int tc_cmac_final_reinit(uint8_t *tag, TCCmacState_t s)
+{
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    s == (TCCmacState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	compute_tag(tag, s);
+
+	/* keep the key, reset the rest of the state for the next message: */
+	tc_cmac_init(s);
+
+	return TC_CRYPTO_SUCCESS;
+}
@@ -37,11 +37,17 @@
 int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 		unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched)
 {
+	return tc_ctr_mode_large(out, outlen, in, inlen, ctr, sched);
+}
+
+int tc_ctr_mode_large(uint8_t *out, size_t outlen, const uint8_t *in,
+		      size_t inlen, uint8_t *ctr, const TCAesKeySched_t sched)
+{
 
 	uint8_t buffer[TC_AES_BLOCK_SIZE];
 	uint8_t nonce[TC_AES_BLOCK_SIZE];
 	unsigned int block_num;
-	unsigned int i;
+	size_t i;
 
 	/* input sanity check: */
 	if (out == (uint8_t *) 0 ||
@@ -50,7 +56,8 @@ int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 	    sched == (TCAesKeySched_t) 0 ||
 	    inlen == 0 ||
 	    outlen == 0 ||
-	    outlen != inlen) {
+	    outlen != inlen ||
+	    (uint64_t) inlen > TC_CTR_MAX_BYTES) {
 		return TC_CRYPTO_FAIL;
 	}
 
@@ -83,3 +90,148 @@ int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 
 	return TC_CRYPTO_SUCCESS;
 }
+
+/*
+ * Adds blocks to the last 4 bytes of ctr, exactly as tc_ctr_mode increments
+ * its counter.
+ */
+static void add_blocks(uint8_t *ctr, unsigned int blocks)
+{
+	unsigned int block_num;
+
+	block_num = (ctr[12] << 24) | (ctr[13] << 16) |
+		    (ctr[14] << 8) | (ctr[15]);
+	block_num += blocks;
+	ctr[12] = (uint8_t)(block_num >> 24);
+	ctr[13] = (uint8_t)(block_num >> 16);
+	ctr[14] = (uint8_t)(block_num >> 8);
+	ctr[15] = (uint8_t)(block_num);
+}
+
+int tc_ctr_advance(uint8_t *ctr, unsigned int blocks)
+{
+	/* input sanity check: */
+	if (ctr == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	add_blocks(ctr, blocks);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/*
+ * Produces the next keystream block from s->ctr and advances s->ctr.
+ */
+static int next_keystream(TCCtrStream_t s)
+{
+	if (!tc_aes_encrypt(s->keystream, s->ctr, s->sched)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	add_blocks(s->ctr, 1);
+	s->keystream_offset = 0;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_ctr_stream_init(TCCtrStream_t s, const uint8_t *ctr,
+		       const TCAesKeySched_t sched)
+{
+	/* input sanity check: */
+	if (s == (TCCtrStream_t) 0 ||
+	    ctr == (const uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(s, 0, sizeof(*s));
+	(void)_copy(s->ctr, sizeof(s->ctr), ctr, sizeof(s->ctr));
+	s->sched = sched;
+
+	/* no keystream is available until the first block is encrypted */
+	s->keystream_offset = TC_AES_BLOCK_SIZE;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_ctr_stream_xor(TCCtrStream_t s, uint8_t *out, const uint8_t *in,
+		      size_t len)
+{
+	/* input sanity check: */
+	if (s == (TCCtrStream_t) 0 ||
+	    out == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (len == 0) {
+		return TC_CRYPTO_SUCCESS;
+	}
+	if (in == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* past 2^32 blocks, the counter would wrap and repeat the keystream */
+	if ((uint64_t) len > TC_CTR_MAX_BYTES - s->bytes) {
+		return TC_CRYPTO_FAIL;
+	}
+	s->bytes += (uint64_t) len;
+
+	while (len-- > 0) {
+		if (s->keystream_offset == TC_AES_BLOCK_SIZE &&
+		    !next_keystream(s)) {
+			return TC_CRYPTO_FAIL;
+		}
+		*out++ = s->keystream[s->keystream_offset++] ^ *in++;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_ctr_stream_erase(TCCtrStream_t s)
+{
+	if (s == (TCCtrStream_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* destroy the current state */
+	_set_secure(s, 0, sizeof(*s));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_ctr_mode_v(uint8_t *out, size_t outlen,
+		  const struct tc_iovec *iov, unsigned int iovcnt,
+		  uint8_t *ctr, const TCAesKeySched_t sched)
+{
+	struct tc_ctr_stream_struct s;
+	size_t len = 0;
+	unsigned int i;
+	int result = TC_CRYPTO_SUCCESS;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    ctr == (uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    !tc_iovec_length(&len, iov, iovcnt) ||
+	    outlen == 0 ||
+	    len != outlen ||
+	    (uint64_t) outlen > TC_CTR_MAX_BYTES) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* the stream carries partial keystream blocks across segments */
+	(void)tc_ctr_stream_init(&s, ctr, sched);
+	for (i = 0; i < iovcnt && result; ++i) {
+		result = tc_ctr_stream_xor(&s, out, iov[i].iov_base,
+					   iov[i].iov_len);
+		out += iov[i].iov_len;
+	}
+
+	/* update the counter */
+	if (result) {
+		(void)_copy(ctr, TC_AES_BLOCK_SIZE, s.ctr, TC_AES_BLOCK_SIZE);
+	}
+	(void)tc_ctr_stream_erase(&s);
+
+	return result;
+}
@@ -0,0 +1,136 @@
+/* ctr_parallel.c - TinyCrypt implementation of multi-threaded CTR mode */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(unix) || defined(__linux__) || defined(__unix__) || \
+    defined(__unix) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(TC_POSIX)
+
+#include <tinycrypt/ctr_parallel.h>
+#include <tinycrypt/thread_pool.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/* struct ctr_job describes how a buffer is split into chunks */
+struct ctr_job {
+	uint8_t *out;
+	const uint8_t *in;
+	size_t len;
+	const uint8_t *ctr;
+	TCAesKeySched_t sched;
+/* blocks per chunk (the last chunk may be shorter) */
+	size_t chunk_blocks;
+/* result of each chunk */
+	int result[TC_THREAD_POOL_MAX_THREADS];
+};
+
+/* processes chunk i with the counter advanced to its first block */
+static void ctr_chunk(void *arg, unsigned int i)
+{
+	struct ctr_job *job = (struct ctr_job *) arg;
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+	size_t off = (size_t) i * job->chunk_blocks * TC_AES_BLOCK_SIZE;
+	size_t n = job->chunk_blocks * TC_AES_BLOCK_SIZE;
+
+	if (n > job->len - off) {
+		n = job->len - off;
+	}
+
+	(void)_copy(ctr, sizeof(ctr), job->ctr, sizeof(ctr));
+	/* chunks start below block 2^32 (see TC_CTR_MAX_BYTES) */
+	(void)tc_ctr_advance(ctr, (unsigned int) ((size_t) i *
+						  job->chunk_blocks));
+	job->result[i] = tc_ctr_mode_large(&job->out[off], n, &job->in[off],
+					   n, ctr, job->sched);
+}
+
+int tc_ctr_mode_parallel(uint8_t *out, const uint8_t *in, size_t len,
+			 uint8_t *ctr, const TCAesKeySched_t sched,
+			 unsigned int nthreads)
+{
+	struct ctr_job job;
+	size_t blocks;
+	size_t min_blocks = TC_CTR_PARALLEL_MIN_CHUNK / TC_AES_BLOCK_SIZE;
+	unsigned int nchunks;
+	unsigned int i;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    ctr == (uint8_t *) 0 ||
+	    sched == (TCAesKeySched_t) 0 ||
+	    len == 0 ||
+	    (uint64_t) len > TC_CTR_MAX_BYTES ||
+	    nthreads == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* one chunk per thread, none shorter than TC_CTR_PARALLEL_MIN_CHUNK */
+	blocks = (len + TC_AES_BLOCK_SIZE - 1) / TC_AES_BLOCK_SIZE;
+	if (nthreads > TC_THREAD_POOL_MAX_THREADS) {
+		nthreads = TC_THREAD_POOL_MAX_THREADS;
+	}
+	if (min_blocks == 0) {
+		min_blocks = 1;
+	}
+	nchunks = nthreads;
+	if ((blocks + min_blocks - 1) / min_blocks < nchunks) {
+		nchunks = (unsigned int) ((blocks + min_blocks - 1) / min_blocks);
+	}
+	if (nchunks <= 1) {
+		return tc_ctr_mode_large(out, len, in, len, ctr, sched);
+	}
+
+	job.out = out;
+	job.in = in;
+	job.len = len;
+	job.ctr = ctr;
+	job.sched = sched;
+	job.chunk_blocks = (blocks + nchunks - 1) / nchunks;
+	/* rounding up may leave the last chunks empty */
+	nchunks = (unsigned int) ((blocks + job.chunk_blocks - 1) /
+				  job.chunk_blocks);
+
+	(void)tc_thread_pool_run(&ctr_chunk, &job, nchunks, nchunks);
+
+	for (i = 0; i < nchunks; ++i) {
+		if (!job.result[i]) {
+			return TC_CRYPTO_FAIL;
+		}
+	}
+
+	/* the counter wraps modulo 2^32 as in tc_ctr_mode */
+	(void)tc_ctr_advance(ctr, (unsigned int) blocks);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+#endif /* platform */
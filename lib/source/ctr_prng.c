@@ -43,22 +43,55 @@
  */
 
 /**
- *  @brief Array incrementer
- *  Treats the supplied array as one contiguous number (MSB in arr[0]), and
- *  increments it by one
+ *  @brief CTR PRNG keystream
+ *  Fills out with len bytes of keystream: for each block, V is incremented
+ *  as one 128-bit big-endian number (10.2.1.2 step 2.1 / 10.2.1.5.1 step
+ *  4.1) and encrypted. V is kept as two 64-bit words while generating and
+ *  written back to ctx once, and whole blocks are encrypted directly into
+ *  out.
  *  @return none
- *  @param arr IN/OUT -- array to be incremented
- *  @param len IN -- size of arr in bytes
+ *  @param ctx IN/OUT -- CTR PRNG state
+ *  @param out OUT -- buffer to receive the keystream
+ *  @param len IN -- number of bytes to produce
  */
-static void arrInc(uint8_t arr[], unsigned int len)
+static void ctr_keystream(TCCtrPrng_t * const ctx, uint8_t *out,
+			  unsigned int len)
 {
+	uint8_t block[TC_AES_BLOCK_SIZE];
+	uint8_t v[TC_AES_BLOCK_SIZE];
+	uint64_t hi = 0U;
+	uint64_t lo = 0U;
 	unsigned int i;
-	if (0 != arr) {
-		for (i = len; i > 0U; i--) {
-			if (++arr[i-1] != 0U) {
-				break;
-			}
+
+	for (i = 0U; i < 8U; i++) {
+		hi = (hi << 8) | ctx->V[i];
+		lo = (lo << 8) | ctx->V[i + 8U];
+	}
+
+	while (len > 0U) {
+		/* increment the 128-bit counter, carrying into the high word */
+		if (++lo == 0U) {
+			hi++;
 		}
+		for (i = 0U; i < 8U; i++) {
+			v[i] = (uint8_t)(hi >> (56U - 8U * i));
+			v[i + 8U] = (uint8_t)(lo >> (56U - 8U * i));
+		}
+
+		if (len >= TC_AES_BLOCK_SIZE) {
+			(void)tc_aes_encrypt(out, v, &ctx->key);
+			out += TC_AES_BLOCK_SIZE;
+			len -= TC_AES_BLOCK_SIZE;
+		} else {
+			(void)tc_aes_encrypt(block, v, &ctx->key);
+			memcpy(out, block, len);
+			len = 0U;
+		}
+	}
+
+	for (i = 0U; i < 8U; i++) {
+		ctx->V[i] = (uint8_t)(hi >> (56U - 8U * i));
+		ctx->V[i + 8U] = (uint8_t)(lo >> (56U - 8U * i));
 	}
 }
 
@@ -76,27 +109,9 @@ static void tc_ctr_prng_update(TCCtrPrng_t * const ctx, uint8_t const * const pr
 	if (0 != ctx) {
 		/* 10.2.1.2 step 1 */
 		uint8_t temp[TC_AES_KEY_SIZE + TC_AES_BLOCK_SIZE];
-		unsigned int len = 0U;
 
-		/* 10.2.1.2 step 2 */
-		while (len < sizeof temp) {
-			unsigned int blocklen = sizeof(temp) - len;
-			uint8_t output_block[TC_AES_BLOCK_SIZE];
-
-			/* 10.2.1.2 step 2.1 */
-			arrInc(ctx->V, sizeof ctx->V);
-
-			/* 10.2.1.2 step 2.2 */
-			if (blocklen > TC_AES_BLOCK_SIZE) {
-				blocklen = TC_AES_BLOCK_SIZE;
-			}
-			(void)tc_aes_encrypt(output_block, ctx->V, &ctx->key);
-
-			/* 10.2.1.2 step 2.3/step 3 */
-			memcpy(&(temp[len]), output_block, blocklen);
-
-			len += blocklen;
-		}
+		/* 10.2.1.2 step 2/step 3 */
+		ctr_keystream(ctx, temp, sizeof temp);
 
 		/* 10.2.1.2 step 4 */
 		if (0 != providedData) {
@@ -234,26 +249,8 @@ int tc_ctr_prng_generate(TCCtrPrng_t * const ctx,
       
 			/* 10.2.1.5.1 step 3 - implicit */
 
-			/* 10.2.1.5.1 step 4 */
-			unsigned int len = 0U;      
-			while (len < outlen) {
-				unsigned int blocklen = outlen - len;
-				uint8_t output_block[TC_AES_BLOCK_SIZE];
-
-				/* 10.2.1.5.1 step 4.1 */
-				arrInc(ctx->V, sizeof ctx->V);
-
-				/* 10.2.1.5.1 step 4.2 */
-				(void)tc_aes_encrypt(output_block, ctx->V, &ctx->key);
-      
-				/* 10.2.1.5.1 step 4.3/step 5 */
-				if (blocklen > TC_AES_BLOCK_SIZE) {
-					blocklen = TC_AES_BLOCK_SIZE;
-				}
-				memcpy(&(out[len]), output_block, blocklen);
-
-				len += blocklen;
-			}
+			/* 10.2.1.5.1 step 4/step 5 */
+			ctr_keystream(ctx, out, outlen);
       
 			/* 10.2.1.5.1 step 6 */
 			tc_ctr_prng_update(ctx, additional_input_buf);
@@ -74,6 +74,12 @@ uECC_RNG_Function uECC_get_rng(void)
 	return g_rng_function;
 }
 
+int uECC_global_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	(void)ctx;
+	return g_rng_function && g_rng_function(dest, size);
+}
+
 int uECC_curve_private_key_size(uECC_Curve curve)
 {
 	return BITS_TO_BYTES(curve->num_n_bits);
@@ -834,19 +840,20 @@ void uECC_vli_bytesToNative(unsigned int *native, const uint8_t *bytes,
   	}
 }
 
-int uECC_generate_random_int(uECC_word_t *random, const uECC_word_t *top,
-			     wordcount_t num_words)
+int uECC_generate_random_int_ex(uECC_word_t *random, const uECC_word_t *top,
+				wordcount_t num_words, uECC_RNG_Function_ex rng,
+				void *rng_ctx)
 {
 	uECC_word_t mask = (uECC_word_t)-1;
 	uECC_word_t tries;
 	bitcount_t num_bits = uECC_vli_numBits(top, num_words);
 
-	if (!g_rng_function) {
+	if (!rng) {
 		return 0;
 	}
 
 	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
-		if (!g_rng_function((uint8_t *)random, num_words * uECC_WORD_SIZE)) {
+		if (!rng(rng_ctx, (uint8_t *)random, num_words * uECC_WORD_SIZE)) {
       			return 0;
     		}
 		random[num_words - 1] &=
@@ -859,6 +866,14 @@ int uECC_generate_random_int(uECC_word_t *random, const uECC_word_t *top,
 	return 0;
 }
 
+int uECC_generate_random_int(uECC_word_t *random, const uECC_word_t *top,
+			     wordcount_t num_words)
+{
+	return uECC_generate_random_int_ex(random, top, num_words,
+					   g_rng_function ? &uECC_global_rng : 0,
+					   0);
+}
+
 
 int uECC_valid_point(const uECC_word_t *point, uECC_Curve curve)
 {
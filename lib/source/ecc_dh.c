@@ -94,7 +94,8 @@ int uECC_make_key_with_d(uint8_t *public_key, uint8_t *private_key,
 	return 0;
 }
 
-int uECC_make_key(uint8_t *public_key, uint8_t *private_key, uECC_Curve curve)
+int uECC_make_key_ex(uint8_t *public_key, uint8_t *private_key,
+		     uECC_Curve curve, uECC_RNG_Function_ex rng, void *rng_ctx)
 {
 
 	uECC_word_t _random[NUM_ECC_WORDS * 2];
@@ -104,9 +105,8 @@ int uECC_make_key(uint8_t *public_key, uint8_t *private_key, uECC_Curve curve)
 
 	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
 		/* Generating _private uniformly at random: */
-		uECC_RNG_Function rng_function = uECC_get_rng();
-		if (!rng_function ||
-			!rng_function((uint8_t *)_random, 2 * NUM_ECC_WORDS*uECC_WORD_SIZE)) {
+		if (!rng ||
+			!rng(rng_ctx, (uint8_t *)_random, 2 * NUM_ECC_WORDS*uECC_WORD_SIZE)) {
         		return 0;
 		}
 
@@ -136,8 +136,15 @@ int uECC_make_key(uint8_t *public_key, uint8_t *private_key, uECC_Curve curve)
 	return 0;
 }
 
-int uECC_shared_secret(const uint8_t *public_key, const uint8_t *private_key,
-		       uint8_t *secret, uECC_Curve curve)
+int uECC_make_key(uint8_t *public_key, uint8_t *private_key, uECC_Curve curve)
+{
+	return uECC_make_key_ex(public_key, private_key, curve,
+				uECC_get_rng() ? &uECC_global_rng : 0, 0);
+}
+
+int uECC_shared_secret_ex(const uint8_t *public_key, const uint8_t *private_key,
+			  uint8_t *secret, uECC_Curve curve,
+			  uECC_RNG_Function_ex rng, void *rng_ctx)
 {
 
 	uECC_word_t _public[NUM_ECC_WORDS * 2];
@@ -168,8 +175,9 @@ int uECC_shared_secret(const uint8_t *public_key, const uint8_t *private_key,
 
 	/* If an RNG function was specified, try to get a random initial Z value to
 	 * improve protection against side-channel attacks. */
-	if (uECC_get_rng()) {
-		if (!uECC_generate_random_int(p2[carry], curve->p, num_words)) {
+	if (rng) {
+		if (!uECC_generate_random_int_ex(p2[carry], curve->p, num_words,
+						 rng, rng_ctx)) {
 			r = 0;
 			goto clear_and_out;
     		}
@@ -190,3 +198,10 @@ clear_and_out:
 
 	return r;
 }
+
+int uECC_shared_secret(const uint8_t *public_key, const uint8_t *private_key,
+		       uint8_t *secret, uECC_Curve curve)
+{
+	return uECC_shared_secret_ex(public_key, private_key, secret, curve,
+				     uECC_get_rng() ? &uECC_global_rng : 0, 0);
+}
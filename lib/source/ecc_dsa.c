@@ -56,6 +56,8 @@
 #include <tinycrypt/constants.h>
 #include <tinycrypt/ecc.h>
 #include <tinycrypt/ecc_dsa.h>
+#include <tinycrypt/hmac_prng.h>
+#include <tinycrypt/utils.h>
 
 
 static void bits2int(uECC_word_t *native, const uint8_t *bits,
@@ -91,9 +93,14 @@ static void bits2int(uECC_word_t *native, const uint8_t *bits,
 	}
 }
 
-int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
-		     unsigned hash_size, uECC_word_t *k, uint8_t *signature,
-		     uECC_Curve curve)
+/*
+ * Signs with the given k; rng, if not NULL, provides the random number that
+ * blinds the inversion of k.
+ */
+static int sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
+		       unsigned hash_size, uECC_word_t *k, uint8_t *signature,
+		       uECC_Curve curve, uECC_RNG_Function_ex rng,
+		       void *rng_ctx)
 {
 
 	uECC_word_t tmp[NUM_ECC_WORDS];
@@ -119,11 +126,12 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 
 	/* If an RNG function was specified, get a random number
 	to prevent side channel analysis of k. */
-	if (!uECC_get_rng()) {
+	if (!rng) {
 		uECC_vli_clear(tmp, num_n_words);
 		tmp[0] = 1;
 	}
-	else if (!uECC_generate_random_int(tmp, curve->n, num_n_words)) {
+	else if (!uECC_generate_random_int_ex(tmp, curve->n, num_n_words,
+					      rng, rng_ctx)) {
 		return 0;
 	}
 
@@ -153,8 +161,17 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 	return 1;
 }
 
-int uECC_sign(const uint8_t *private_key, const uint8_t *message_hash,
-	      unsigned hash_size, uint8_t *signature, uECC_Curve curve)
+int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
+		     unsigned hash_size, uECC_word_t *k, uint8_t *signature,
+		     uECC_Curve curve)
+{
+	return sign_with_k(private_key, message_hash, hash_size, k, signature,
+			   curve, uECC_get_rng() ? &uECC_global_rng : 0, 0);
+}
+
+int uECC_sign_ex(const uint8_t *private_key, const uint8_t *message_hash,
+		 unsigned hash_size, uint8_t *signature, uECC_Curve curve,
+		 uECC_RNG_Function_ex rng, void *rng_ctx)
 {
 	      uECC_word_t _random[2*NUM_ECC_WORDS];
 	      uECC_word_t k[NUM_ECC_WORDS];
@@ -162,23 +179,86 @@ int uECC_sign(const uint8_t *private_key, const uint8_t *message_hash,
 
 	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
 		/* Generating _random uniformly at random: */
-		uECC_RNG_Function rng_function = uECC_get_rng();
-		if (!rng_function ||
-		    !rng_function((uint8_t *)_random, 2*NUM_ECC_WORDS*uECC_WORD_SIZE)) {
+		if (!rng ||
+		    !rng(rng_ctx, (uint8_t *)_random, 2*NUM_ECC_WORDS*uECC_WORD_SIZE)) {
 			return 0;
 		}
 
 		// computing k as modular reduction of _random (see FIPS 186.4 B.5.1):
 		uECC_vli_mmod(k, _random, curve->n, BITS_TO_WORDS(curve->num_n_bits));
 
-		if (uECC_sign_with_k(private_key, message_hash, hash_size, k, signature, 
-		    curve)) {
+		if (sign_with_k(private_key, message_hash, hash_size, k, signature,
+				curve, rng, rng_ctx)) {
 			return 1;
 		}
 	}
 	return 0;
 }
 
+int uECC_sign(const uint8_t *private_key, const uint8_t *message_hash,
+	      unsigned hash_size, uint8_t *signature, uECC_Curve curve)
+{
+	return uECC_sign_ex(private_key, message_hash, hash_size, signature,
+			    curve, uECC_get_rng() ? &uECC_global_rng : 0, 0);
+}
+
+/* uECC_RNG_Function_ex drawing from the TCHmacPrng_t given as context */
+static int hmac_prng_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	return tc_hmac_prng_generate(dest, size, (TCHmacPrng_t) ctx) ==
+	       TC_CRYPTO_SUCCESS;
+}
+
+int uECC_sign_deterministic(const uint8_t *private_key,
+			    const uint8_t *message_hash, unsigned hash_size,
+			    uint8_t *signature, uECC_Curve curve)
+{
+	struct tc_hmac_prng_struct prng;
+	uECC_word_t k[NUM_ECC_WORDS];
+	uint8_t h1[NUM_ECC_BYTES];
+	uint8_t t[NUM_ECC_BYTES];
+	unsigned num_n_bytes = BITS_TO_BYTES(curve->num_n_bits);
+	wordcount_t num_n_words = BITS_TO_WORDS(curve->num_n_bits);
+	uECC_word_t tries;
+	int result = 0;
+
+	/* h1 = bits2octets(message_hash), i.e. the hash reduced mod curve_n */
+	bits2int(k, message_hash, hash_size, curve);
+	if (uECC_vli_cmp_unsafe(curve->n, k, num_n_words) != 1) {
+		uECC_vli_sub(k, k, curve->n, num_n_words);
+	}
+	uECC_vli_nativeToBytes(h1, num_n_bytes, k);
+
+	/* RFC 6979 3.2 steps b. to g.: K and V from private_key || h1 */
+	if (!tc_hmac_prng_instantiate(&prng, private_key, num_n_bytes,
+				      h1, num_n_bytes)) {
+		return 0;
+	}
+
+	for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
+		/*
+		 * Step h.: each generate call outputs T and then updates K and
+		 * V as required before trying the next candidate. T has as
+		 * many bits as curve_n, so bits2int does not reduce it: a k out
+		 * of [1, curve_n - 1] is rejected by sign_with_k.
+		 */
+		(void)tc_hmac_prng_generate(t, num_n_bytes, &prng);
+		bits2int(k, t, num_n_bytes, curve);
+
+		/* the value blinding the inversion of k comes from the DRBG */
+		if (sign_with_k(private_key, message_hash, hash_size, k,
+				signature, curve, &hmac_prng_rng, &prng)) {
+			result = 1;
+			break;
+		}
+	}
+
+	_set_secure(&prng, 0, sizeof(prng));
+	_set_secure(k, 0, sizeof(k));
+	_set_secure(t, 0, sizeof(t));
+	return result;
+}
+
 static bitcount_t smax(bitcount_t a, bitcount_t b)
 {
 	return (a > b ? a : b);
@@ -60,10 +60,20 @@
     defined(__unix) |  (defined(__APPLE__) && defined(__MACH__)) || \
     defined(uECC_POSIX)
 
-/* Some POSIX-like system with /dev/urandom or /dev/random. */
+/* Some POSIX-like system with getrandom(2), /dev/urandom or /dev/random. */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include <tinycrypt/ecc_platform_specific.h>
+
 #include <sys/types.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 #include <stdint.h>
 
@@ -71,11 +81,8 @@
 #define O_CLOEXEC 0
 #endif
 
-int default_CSPRNG(uint8_t *dest, unsigned int size) {
-
-  /* input sanity check: */
-  if (dest == (uint8_t *) 0 || (size <= 0))
-    return 0;
+/* Reads size bytes from /dev/urandom (or /dev/random if it is missing). */
+static int urandom_read(uint8_t *dest, size_t size) {
 
   int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
   if (fd == -1) {
@@ -86,9 +93,12 @@ int default_CSPRNG(uint8_t *dest, unsigned int size) {
   }
 
   char *ptr = (char *)dest;
-  size_t left = (size_t) size;
+  size_t left = size;
   while (left > 0) {
     ssize_t bytes_read = read(fd, ptr, left);
+    if (bytes_read < 0 && errno == EINTR) {
+      continue;
+    }
     if (bytes_read <= 0) { // read failed
       close(fd);
       return 0;
@@ -101,5 +111,45 @@ int default_CSPRNG(uint8_t *dest, unsigned int size) {
   return 1;
 }
 
+#if defined(__linux__) && defined(SYS_getrandom)
+/*
+ * Reads size bytes with getrandom(2), which needs no file descriptor and
+ * works in a chroot. Returns -1 if the kernel does not provide the system
+ * call (or a seccomp filter denies it), so that the caller can fall back to
+ * /dev/urandom.
+ */
+static int getrandom_read(uint8_t *dest, size_t size) {
+
+  while (size > 0) {
+    long bytes_read = syscall(SYS_getrandom, dest, size, 0);
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return (errno == ENOSYS || errno == EPERM) ? -1 : 0;
+    }
+    size -= (size_t) bytes_read;
+    dest += bytes_read;
+  }
+  return 1;
+}
+#endif
+
+int default_CSPRNG(uint8_t *dest, unsigned int size) {
+
+  /* input sanity check: */
+  if (dest == (uint8_t *) 0 || (size <= 0))
+    return 0;
+
+#if defined(__linux__) && defined(SYS_getrandom)
+  int result = getrandom_read(dest, size);
+  if (result >= 0) {
+    return result;
+  }
+#endif
+
+  return urandom_read(dest, size);
+}
+
 #endif /* platform */
 
@@ -0,0 +1,374 @@
+/* file.c - TinyCrypt implementation of file hashing and encryption helpers */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(unix) || defined(__linux__) || defined(__unix__) || \
+    defined(__unix) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(TC_POSIX)
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <tinycrypt/file.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* consumes the next len bytes of a file */
+typedef int (*sink_t)(void *ctx, const uint8_t *data, size_t len);
+
+/*
+ * Reads fd through a buffer until end of file. Regular files are read with
+ * pread from offset off so that the file offset of fd is not changed.
+ */
+static int read_chunks(int fd, int regular, off_t off, sink_t sink,
+		       void *ctx, uint64_t *total)
+{
+	uint8_t buffer[TC_FILE_BUFFER_SIZE];
+	ssize_t n;
+	int result = TC_CRYPTO_SUCCESS;
+
+	for (;;) {
+		if (regular) {
+			n = pread(fd, buffer, sizeof(buffer), off);
+		} else {
+			n = read(fd, buffer, sizeof(buffer));
+		}
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			result = n == 0 ? TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+			break;
+		}
+		if (!sink(ctx, buffer, (size_t) n)) {
+			result = TC_CRYPTO_FAIL;
+			break;
+		}
+		off += n;
+		*total += (uint64_t) n;
+	}
+
+	_set_secure(buffer, 0, sizeof(buffer));
+
+	return result;
+}
+
+/* struct reader is shared by read_pipe and its reader thread */
+struct reader {
+	int fd;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+/* set by read_pipe when the sink fails */
+	int stop;
+/* nonzero when buffer i holds data for the sink */
+	int full[2];
+/* result of the read into buffer i: bytes, 0 at end of file, -1 on error */
+	ssize_t len[2];
+	uint8_t buffer[2][TC_FILE_BUFFER_SIZE];
+};
+
+/*
+ * Reads r->fd into the two buffers in turn, waiting for the sink to empty a
+ * buffer before refilling it. Cancellation is only enabled around read, so
+ * that read_pipe can stop a thread blocked on an idle descriptor.
+ */
+static void *reader_thread(void *arg)
+{
+	struct reader *r = (struct reader *) arg;
+	unsigned int i = 0;
+	int state;
+	ssize_t n;
+
+	(void)pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+	for (;;) {
+		(void)pthread_mutex_lock(&r->lock);
+		while (r->full[i] && !r->stop) {
+			(void)pthread_cond_wait(&r->cond, &r->lock);
+		}
+		if (r->stop) {
+			(void)pthread_mutex_unlock(&r->lock);
+			break;
+		}
+		(void)pthread_mutex_unlock(&r->lock);
+
+		(void)pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &state);
+		do {
+			n = read(r->fd, r->buffer[i], TC_FILE_BUFFER_SIZE);
+		} while (n < 0 && errno == EINTR);
+		(void)pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+
+		(void)pthread_mutex_lock(&r->lock);
+		r->len[i] = n < 0 ? -1 : n;
+		r->full[i] = 1;
+		(void)pthread_cond_broadcast(&r->cond);
+		(void)pthread_mutex_unlock(&r->lock);
+		if (n <= 0) {
+			break;
+		}
+		i ^= 1;
+	}
+
+	return (void *) 0;
+}
+
+/*
+ * Reads fd until end of file with double buffering: a reader thread fills
+ * one buffer while sink consumes the other, so that waiting for a pipe or a
+ * socket overlaps with hashing or encryption. Falls back to read_chunks if
+ * the thread cannot be created.
+ */
+static int read_pipe(int fd, sink_t sink, void *ctx, uint64_t *total)
+{
+	struct reader r;
+	pthread_t thread;
+	unsigned int i = 0;
+	ssize_t n;
+	int result = TC_CRYPTO_SUCCESS;
+
+	r.fd = fd;
+	r.stop = 0;
+	r.full[0] = r.full[1] = 0;
+	if (pthread_mutex_init(&r.lock, (pthread_mutexattr_t *) 0) != 0) {
+		return read_chunks(fd, 0, 0, sink, ctx, total);
+	}
+	if (pthread_cond_init(&r.cond, (pthread_condattr_t *) 0) != 0) {
+		(void)pthread_mutex_destroy(&r.lock);
+		return read_chunks(fd, 0, 0, sink, ctx, total);
+	}
+	if (pthread_create(&thread, (pthread_attr_t *) 0, &reader_thread,
+			   &r) != 0) {
+		(void)pthread_cond_destroy(&r.cond);
+		(void)pthread_mutex_destroy(&r.lock);
+		return read_chunks(fd, 0, 0, sink, ctx, total);
+	}
+
+	for (;;) {
+		(void)pthread_mutex_lock(&r.lock);
+		while (!r.full[i]) {
+			(void)pthread_cond_wait(&r.cond, &r.lock);
+		}
+		n = r.len[i];
+		(void)pthread_mutex_unlock(&r.lock);
+		if (n <= 0) {
+			result = n == 0 ? TC_CRYPTO_SUCCESS : TC_CRYPTO_FAIL;
+			break;
+		}
+
+		if (!sink(ctx, r.buffer[i], (size_t) n)) {
+			result = TC_CRYPTO_FAIL;
+			(void)pthread_mutex_lock(&r.lock);
+			r.stop = 1;
+			(void)pthread_cond_broadcast(&r.cond);
+			(void)pthread_mutex_unlock(&r.lock);
+			(void)pthread_cancel(thread);
+			break;
+		}
+		*total += (uint64_t) n;
+
+		(void)pthread_mutex_lock(&r.lock);
+		r.full[i] = 0;
+		(void)pthread_cond_broadcast(&r.cond);
+		(void)pthread_mutex_unlock(&r.lock);
+		i ^= 1;
+	}
+
+	(void)pthread_join(thread, (void **) 0);
+	(void)pthread_cond_destroy(&r.cond);
+	(void)pthread_mutex_destroy(&r.lock);
+	_set_secure(r.buffer, 0, sizeof(r.buffer));
+
+	return result;
+}
+
+/*
+ * Feeds the contents of fd to sink: regular files are mapped one window at a
+ * time, falling back to pread from the first window that cannot be mapped;
+ * regular files reporting a size of zero (e.g. in /proc or /sys) are read
+ * until end of file, and anything else is read until end of file by
+ * read_pipe.
+ */
+static int process(int fd, sink_t sink, void *ctx, uint64_t *nbytes)
+{
+	struct stat st;
+	uint64_t total = 0;
+	off_t off = 0;
+	size_t len;
+	void *map;
+	int result = TC_CRYPTO_SUCCESS;
+
+	if (fstat(fd, &st) != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (!S_ISREG(st.st_mode)) {
+		result = read_pipe(fd, sink, ctx, &total);
+		goto done;
+	}
+
+	/* pseudo files report no size but still have contents */
+	if (st.st_size == 0) {
+		result = read_chunks(fd, 0, 0, sink, ctx, &total);
+		goto done;
+	}
+
+	while (off < st.st_size) {
+		len = TC_FILE_MAP_SIZE;
+		if ((uint64_t) (st.st_size - off) < (uint64_t) len) {
+			len = (size_t) (st.st_size - off);
+		}
+		map = mmap((void *) 0, len, PROT_READ, MAP_PRIVATE, fd, off);
+		if (map == MAP_FAILED) {
+			result = read_chunks(fd, 1, off, sink, ctx, &total);
+			goto done;
+		}
+		(void)posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+		result = sink(ctx, (const uint8_t *) map, len);
+		(void)munmap(map, len);
+		if (!result) {
+			goto done;
+		}
+		off += (off_t) len;
+		total += (uint64_t) len;
+	}
+
+done:
+	if (nbytes != (uint64_t *) 0) {
+		*nbytes = total;
+	}
+	return result;
+}
+
+static int sha256_sink(void *ctx, const uint8_t *data, size_t len)
+{
+	return tc_sha256_update((TCSha256State_t) ctx, data, len);
+}
+
+int tc_sha256_file(TCSha256State_t s, int fd, uint64_t *nbytes)
+{
+	/* input sanity check: */
+	if (s == (TCSha256State_t) 0 ||
+	    fd < 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return process(fd, sha256_sink, s, nbytes);
+}
+
+static int hmac_sink(void *ctx, const uint8_t *data, size_t len)
+{
+	return tc_hmac_update_large((TCHmacState_t) ctx, data, len);
+}
+
+int tc_hmac_file(TCHmacState_t ctx, int fd, uint64_t *nbytes)
+{
+	/* input sanity check: */
+	if (ctx == (TCHmacState_t) 0 ||
+	    fd < 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return process(fd, hmac_sink, ctx, nbytes);
+}
+
+struct ctr_sink_ctx {
+	TCCtrStream_t s;
+	int out_fd;
+};
+
+/* writes all len bytes of data to fd */
+static int write_all(int fd, const uint8_t *data, size_t len)
+{
+	ssize_t n;
+
+	while (len > 0) {
+		n = write(fd, data, len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return TC_CRYPTO_FAIL;
+		}
+		data += n;
+		len -= (size_t) n;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+static int ctr_sink(void *ctx, const uint8_t *data, size_t len)
+{
+	struct ctr_sink_ctx *c = (struct ctr_sink_ctx *) ctx;
+	uint8_t buffer[TC_FILE_BUFFER_SIZE];
+	size_t n;
+	int result = TC_CRYPTO_SUCCESS;
+
+	while (len > 0) {
+		n = len < sizeof(buffer) ? len : sizeof(buffer);
+		if (!tc_ctr_stream_xor(c->s, buffer, data, n) ||
+		    !write_all(c->out_fd, buffer, n)) {
+			result = TC_CRYPTO_FAIL;
+			break;
+		}
+		data += n;
+		len -= n;
+	}
+
+	_set_secure(buffer, 0, sizeof(buffer));
+
+	return result;
+}
+
+int tc_ctr_file(TCCtrStream_t s, int in_fd, int out_fd, uint64_t *nbytes)
+{
+	struct ctr_sink_ctx c;
+
+	/* input sanity check: */
+	if (s == (TCCtrStream_t) 0 ||
+	    in_fd < 0 ||
+	    out_fd < 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	c.s = s;
+	c.out_fd = out_fd;
+
+	return process(in_fd, ctr_sink, &c, nbytes);
+}
+
+#endif /* platform */
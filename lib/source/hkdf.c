@@ -0,0 +1,139 @@
+/* hkdf.c - TinyCrypt implementation of HKDF-SHA256 */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/hkdf.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+int tc_hkdf_extract(uint8_t *prk, const uint8_t *salt, unsigned int saltlen,
+		    const uint8_t *ikm, size_t ikmlen)
+{
+	struct tc_hmac_midstates_struct m;
+	struct tc_iovec iov;
+
+	/* input sanity check: */
+	if (prk == (uint8_t *) 0 ||
+	    (salt == (const uint8_t *) 0 && saltlen > 0) ||
+	    (ikm == (const uint8_t *) 0 && ikmlen > 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/*
+	 * An empty salt is an empty HMAC key, which HMAC pads with zeros just
+	 * like the TC_SHA256_DIGEST_SIZE zero bytes RFC 5869 asks for.
+	 */
+	(void)tc_hmac_set_midstates(&m, salt, saltlen);
+	iov.iov_base = ikm;
+	iov.iov_len = ikmlen;
+	(void)tc_hmac_midstates_v(prk, &m, &iov, 1);
+	(void)tc_hmac_midstates_erase(&m);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_hkdf_expand_midstates(uint8_t *okm, size_t okmlen,
+			     const struct tc_hmac_midstates_struct *prk,
+			     const uint8_t *info, size_t infolen)
+{
+	uint8_t t[TC_SHA256_DIGEST_SIZE];
+	uint8_t counter;
+	struct tc_iovec iov[3];
+	size_t n;
+
+	/* input sanity check: */
+	if (okm == (uint8_t *) 0 ||
+	    okmlen == 0 ||
+	    okmlen > TC_HKDF_MAX_OKM_SIZE ||
+	    prk == (const struct tc_hmac_midstates_struct *) 0 ||
+	    (info == (const uint8_t *) 0 && infolen > 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* T(0) is empty */
+	iov[0].iov_base = t;
+	iov[0].iov_len = 0;
+	iov[1].iov_base = info;
+	iov[1].iov_len = infolen;
+	iov[2].iov_base = &counter;
+	iov[2].iov_len = 1;
+
+	for (counter = 1; okmlen > 0; ++counter) {
+		(void)tc_hmac_midstates_v(t, prk, iov, 3);
+		iov[0].iov_len = sizeof(t);
+
+		n = okmlen < sizeof(t) ? okmlen : sizeof(t);
+		(void)_copy(okm, n, t, n);
+		okm += n;
+		okmlen -= n;
+	}
+
+	_set_secure(t, 0, sizeof(t));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_hkdf_expand(uint8_t *okm, size_t okmlen,
+		   const uint8_t *prk, unsigned int prklen,
+		   const uint8_t *info, size_t infolen)
+{
+	struct tc_hmac_midstates_struct m;
+	int result;
+
+	/* input sanity check: */
+	if (prk == (const uint8_t *) 0 ||
+	    prklen < TC_SHA256_DIGEST_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_hmac_set_midstates(&m, prk, prklen);
+	result = tc_hkdf_expand_midstates(okm, okmlen, &m, info, infolen);
+	(void)tc_hmac_midstates_erase(&m);
+
+	return result;
+}
+
+int tc_hkdf(uint8_t *okm, size_t okmlen,
+	    const uint8_t *salt, unsigned int saltlen,
+	    const uint8_t *ikm, size_t ikmlen,
+	    const uint8_t *info, size_t infolen)
+{
+	uint8_t prk[TC_SHA256_DIGEST_SIZE];
+	int result;
+
+	if (!tc_hkdf_extract(prk, salt, saltlen, ikm, ikmlen)) {
+		return TC_CRYPTO_FAIL;
+	}
+	result = tc_hkdf_expand(okm, okmlen, prk, sizeof(prk), info, infolen);
+	_set_secure(prk, 0, sizeof(prk));
+
+	return result;
+}
@@ -110,6 +110,13 @@ int tc_hmac_update(TCHmacState_t ctx,
 		   const void *data,
 		   unsigned int data_length)
 {
+	return tc_hmac_update_large(ctx, data, data_length);
+}
+
+int tc_hmac_update_large(TCHmacState_t ctx,
+			 const void *data,
+			 size_t data_length)
+{
 
 	/* input sanity check: */
 	if (ctx == (TCHmacState_t) 0) {
@@ -121,6 +128,18 @@ int tc_hmac_update(TCHmacState_t ctx,
 	return TC_CRYPTO_SUCCESS;
 }
 
+int tc_hmac_update_v(TCHmacState_t ctx, const struct tc_iovec *iov,
+		     unsigned int iovcnt)
+{
+
+	/* input sanity check: */
+	if (ctx == (TCHmacState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return tc_sha256_update_v(&ctx->hash_state, iov, iovcnt);
+}
+
 int tc_hmac_final(uint8_t *tag, unsigned int taglen, TCHmacState_t ctx)
 {
 
@@ -145,3 +164,68 @@ int tc_hmac_final(uint8_t *tag, unsigned int taglen, TCHmacState_t ctx)
 
 	return TC_CRYPTO_SUCCESS;
 }
+
+int tc_hmac_set_midstates(TCHmacMidstates_t m, const uint8_t *key,
+			  unsigned int key_size)
+{
+	struct tc_hmac_state_struct h;
+	const uint8_t zero = 0x00;
+
+	/* input sanity check: */
+	if (m == (TCHmacMidstates_t) 0 ||
+	    (key == (const uint8_t *) 0 && key_size > 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* keys are zero padded: the empty key is the key 0x00 */
+	if (key_size == 0) {
+		key = &zero;
+		key_size = 1;
+	}
+
+	(void)tc_hmac_set_key(&h, key, key_size);
+	(void)tc_sha256_init(&m->inner);
+	(void)tc_sha256_update(&m->inner, h.key, TC_SHA256_BLOCK_SIZE);
+	(void)tc_sha256_init(&m->outer);
+	(void)tc_sha256_update(&m->outer, &h.key[TC_SHA256_BLOCK_SIZE],
+			       TC_SHA256_BLOCK_SIZE);
+
+	/* destroy the key schedule */
+	_set_secure(&h, 0, sizeof(h));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_hmac_midstates_v(uint8_t *tag, const struct tc_hmac_midstates_struct *m,
+			const struct tc_iovec *iov, unsigned int iovcnt)
+{
+	struct tc_sha256_state_struct s;
+
+	/* input sanity check: */
+	if (tag == (uint8_t *) 0 ||
+	    m == (const struct tc_hmac_midstates_struct *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_sha256_clone(&s, &m->inner);
+	if (!tc_sha256_update_v(&s, iov, iovcnt)) {
+		_set_secure(&s, 0, sizeof(s));
+		return TC_CRYPTO_FAIL;
+	}
+	(void)tc_sha256_final(tag, &s);
+
+	/* the outer message is the 32-byte inner hash: one compression */
+	return tc_sha256_midstate_32(tag, &m->outer, tag);
+}
+
+int tc_hmac_midstates_erase(TCHmacMidstates_t m)
+{
+	if (m == (TCHmacMidstates_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* destroy the current state */
+	_set_secure(m, 0, sizeof(*m));
+
+	return TC_CRYPTO_SUCCESS;
+}
@@ -73,58 +73,76 @@ static const unsigned int MAX_GENS = UINT32_MAX;
 static const unsigned int  MAX_OUT = (1 << 19);
 
 /*
+ * Hashes the inner and outer key blocks of the prng key into prng->h.
+ * The prng key is always TC_SHA256_DIGEST_SIZE bytes long, so unlike
+ * tc_hmac_set_key no dummy hashing is needed to hide its length.
  * Assumes: prng != NULL
  */
-static void update(TCHmacPrng_t prng, const uint8_t *data, unsigned int datalen, const uint8_t *additional_data, unsigned int additional_datalen)
+static void set_key(TCHmacPrng_t prng)
 {
-	const uint8_t separator0 = 0x00;
-	const uint8_t separator1 = 0x01;
+	const uint8_t inner_pad = (uint8_t) 0x36;
+	const uint8_t outer_pad = (uint8_t) 0x5c;
+	uint8_t block[TC_SHA256_BLOCK_SIZE];
+	unsigned int i;
 
-	/* configure the new prng key into the prng's instance of hmac */
-	tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
+	for (i = 0; i < sizeof(prng->key); ++i) {
+		block[i] = inner_pad ^ prng->key[i];
+	}
+	_set(&block[i], inner_pad, sizeof(block) - i);
+	(void)tc_sha256_init(&prng->h.inner);
+	(void)tc_sha256_update(&prng->h.inner, block, sizeof(block));
 
-	/* use current state, e and separator 0 to compute a new prng key: */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_update(&prng->h, &separator0, sizeof(separator0));
+	for (i = 0; i < sizeof(prng->key); ++i) {
+		block[i] = outer_pad ^ prng->key[i];
+	}
+	_set(&block[i], outer_pad, sizeof(block) - i);
+	(void)tc_sha256_init(&prng->h.outer);
+	(void)tc_sha256_update(&prng->h.outer, block, sizeof(block));
+
+	_set_secure(block, 0, sizeof(block));
+}
 
-	if (data && datalen)
-		(void)tc_hmac_update(&prng->h, data, datalen);
-	if (additional_data && additional_datalen)
-		(void)tc_hmac_update(&prng->h, additional_data, additional_datalen);
+/*
+ * Computes v = HMAC(key, v): one compression for each of the inner and
+ * outer hashes, starting from the key midstates.
+ * Assumes: prng != NULL
+ */
+static void next_v(TCHmacPrng_t prng)
+{
+	(void)tc_sha256_midstate_32(prng->v, &prng->h.inner, prng->v);
+	(void)tc_sha256_midstate_32(prng->v, &prng->h.outer, prng->v);
+}
 
-	(void)tc_hmac_final(prng->key, sizeof(prng->key), &prng->h);
+/*
+ * Assumes: prng != NULL and prng->h holds the midstates of prng->key
+ */
+static void update(TCHmacPrng_t prng, const uint8_t *data, unsigned int datalen, const uint8_t *additional_data, unsigned int additional_datalen)
+{
+	uint8_t separator = 0x00;
+	const struct tc_iovec iov[4] = {
+		{ prng->v, sizeof(prng->v) },
+		{ &separator, sizeof(separator) },
+		{ data, data ? datalen : 0 },
+		{ additional_data, additional_data ? additional_datalen : 0 }
+	};
 
-	/* configure the new prng key into the prng's instance of hmac */
-	(void)tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
+	/* use current state, e and separator 0 to compute a new prng key: */
+	(void)tc_hmac_midstates_v(prng->key, &prng->h, iov, 4);
+	set_key(prng);
 
 	/* use the new key to compute a new state variable v */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_final(prng->v, sizeof(prng->v), &prng->h);
+	next_v(prng);
 
 	if (data == 0 || datalen == 0)
 		return;
 
-	/* configure the new prng key into the prng's instance of hmac */
-	tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
-
 	/* use current state, e and separator 1 to compute a new prng key: */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_update(&prng->h, &separator1, sizeof(separator1));
-	(void)tc_hmac_update(&prng->h, data, datalen);
-	if (additional_data && additional_datalen)
-		(void)tc_hmac_update(&prng->h, additional_data, additional_datalen);
-	(void)tc_hmac_final(prng->key, sizeof(prng->key), &prng->h);
-
-	/* configure the new prng key into the prng's instance of hmac */
-	(void)tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
+	separator = 0x01;
+	(void)tc_hmac_midstates_v(prng->key, &prng->h, iov, 4);
+	set_key(prng);
 
 	/* use the new key to compute a new state variable v */
-	(void)tc_hmac_init(&prng->h);
-	(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-	(void)tc_hmac_final(prng->v, sizeof(prng->v), &prng->h);
+	next_v(prng);
 }
 
 int tc_hmac_prng_init(TCHmacPrng_t prng,
@@ -142,6 +160,7 @@ int tc_hmac_prng_init(TCHmacPrng_t prng,
 	/* put the generator into a known state: */
 	_set(prng->key, 0x00, sizeof(prng->key));
 	_set(prng->v, 0x01, sizeof(prng->v));
+	set_key(prng);
 
 	update(prng, personalization, plen, 0, 0);
 
@@ -189,6 +208,36 @@ int tc_hmac_prng_reseed(TCHmacPrng_t prng,
 	return TC_CRYPTO_SUCCESS;
 }
 
+int tc_hmac_prng_instantiate(TCHmacPrng_t prng,
+			     const uint8_t *seed,
+			     unsigned int seedlen,
+			     const uint8_t *nonce,
+			     unsigned int noncelen)
+{
+
+	/* input sanity check: */
+	if (prng == (TCHmacPrng_t) 0 ||
+	    seed == (const uint8_t *) 0 ||
+	    seedlen < MIN_SLEN ||
+	    seedlen > MAX_SLEN ||
+	    (nonce == (const uint8_t *) 0 && noncelen > 0) ||
+	    noncelen > MAX_ALEN) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* put the generator into a known state: */
+	_set(prng->key, 0x00, sizeof(prng->key));
+	_set(prng->v, 0x01, sizeof(prng->v));
+	set_key(prng);
+
+	update(prng, seed, seedlen, nonce, noncelen);
+
+	/* the seed material is all there is: enable hmac_prng_generate */
+	prng->countdown = MAX_GENS;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
 int tc_hmac_prng_generate(uint8_t *out, unsigned int outlen, TCHmacPrng_t prng)
 {
 	unsigned int bufferlen;
@@ -206,13 +255,11 @@ int tc_hmac_prng_generate(uint8_t *out, unsigned int outlen, TCHmacPrng_t prng)
 	prng->countdown--;
 
 	while (outlen != 0) {
-		/* configure the new prng key into the prng's instance of hmac */
-		tc_hmac_set_key(&prng->h, prng->key, sizeof(prng->key));
-
-		/* operate HMAC in OFB mode to create "random" outputs */
-		(void)tc_hmac_init(&prng->h);
-		(void)tc_hmac_update(&prng->h, prng->v, sizeof(prng->v));
-		(void)tc_hmac_final(prng->v, sizeof(prng->v), &prng->h);
+		/*
+		 * operate HMAC in OFB mode to create "random" outputs; the key
+		 * does not change within the loop, so its midstates are reused
+		 */
+		next_v(prng);
 
 		bufferlen = (TC_SHA256_DIGEST_SIZE > outlen) ?
 			outlen : TC_SHA256_DIGEST_SIZE;
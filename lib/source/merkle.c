@@ -0,0 +1,328 @@
+/* merkle.c - TinyCrypt implementation of a SHA-256 Merkle tree hash */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/merkle.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/* RFC 6962 domain separation prefixes */
+static const uint8_t leaf_prefix = 0x00;
+static const uint8_t node_prefix = 0x01;
+
+int tc_merkle_init(TCMerkleState_t t)
+{
+	/* input sanity check: */
+	if (t == (TCMerkleState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(t, 0, sizeof(*t));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_merkle_leaf(uint8_t *leaf_hash, const uint8_t *data, size_t datalen)
+{
+	struct tc_sha256_state_struct s;
+
+	/* input sanity check: */
+	if (leaf_hash == (uint8_t *) 0 ||
+	    (data == (const uint8_t *) 0 && datalen > 0) ||
+	    datalen > TC_MERKLE_LEAF_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_sha256_init(&s);
+	(void)tc_sha256_update(&s, &leaf_prefix, 1);
+	(void)tc_sha256_update(&s, data, datalen);
+	(void)tc_sha256_final(leaf_hash, &s);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_merkle_node(uint8_t *node_hash, const uint8_t *left,
+		   const uint8_t *right)
+{
+	struct tc_sha256_state_struct s;
+
+	/* input sanity check: */
+	if (node_hash == (uint8_t *) 0 ||
+	    left == (const uint8_t *) 0 ||
+	    right == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* node_hash may alias left or right: both are consumed before final */
+	(void)tc_sha256_init(&s);
+	(void)tc_sha256_update(&s, &node_prefix, 1);
+	(void)tc_sha256_update(&s, left, TC_SHA256_DIGEST_SIZE);
+	(void)tc_sha256_update(&s, right, TC_SHA256_DIGEST_SIZE);
+	(void)tc_sha256_final(node_hash, &s);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/* number of complete subtrees in a tree of count leaves */
+static unsigned int subtrees(uint64_t count)
+{
+	unsigned int n = 0;
+
+	for (; count != 0; count >>= 1) {
+		n += (unsigned int)(count & 1);
+	}
+
+	return n;
+}
+
+/*
+ * Appends a leaf hash. The stack holds one complete subtree root per bit set
+ * in the leaf count, largest first, so adding a leaf merges the subtrees
+ * matching the trailing one bits of the count, like a binary carry.
+ */
+static void push_leaf(TCMerkleState_t t, const uint8_t *leaf_hash)
+{
+	unsigned int top = subtrees(t->leaves);
+	uint64_t count;
+
+	(void)_copy(t->stack[top], TC_SHA256_DIGEST_SIZE,
+		    leaf_hash, TC_SHA256_DIGEST_SIZE);
+	for (count = t->leaves; (count & 1) != 0; count >>= 1) {
+		--top;
+		(void)tc_merkle_node(t->stack[top], t->stack[top],
+				     t->stack[top + 1]);
+	}
+	t->leaves++;
+}
+
+int tc_merkle_update(TCMerkleState_t t, const uint8_t *data, size_t datalen)
+{
+	uint8_t leaf_hash[TC_SHA256_DIGEST_SIZE];
+	size_t n;
+
+	/* input sanity check: */
+	if (t == (TCMerkleState_t) 0 ||
+	    (data == (const uint8_t *) 0 && datalen > 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	while (datalen > 0) {
+		if (t->leaf_len == 0) {
+			(void)tc_sha256_init(&t->leaf);
+			(void)tc_sha256_update(&t->leaf, &leaf_prefix, 1);
+		}
+		n = TC_MERKLE_LEAF_SIZE - t->leaf_len;
+		if (n > datalen) {
+			n = datalen;
+		}
+		(void)tc_sha256_update(&t->leaf, data, n);
+		t->leaf_len += n;
+		data += n;
+		datalen -= n;
+
+		if (t->leaf_len == TC_MERKLE_LEAF_SIZE) {
+			(void)tc_sha256_final(leaf_hash, &t->leaf);
+			push_leaf(t, leaf_hash);
+			t->leaf_len = 0;
+		}
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_merkle_add_leaf(TCMerkleState_t t, const uint8_t *leaf_hash)
+{
+	/* input sanity check: */
+	if (t == (TCMerkleState_t) 0 ||
+	    leaf_hash == (const uint8_t *) 0 ||
+	    t->leaf_len != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	push_leaf(t, leaf_hash);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_merkle_final(uint8_t *root, TCMerkleState_t t)
+{
+	uint8_t leaf_hash[TC_SHA256_DIGEST_SIZE];
+	unsigned int top;
+
+	/* input sanity check: */
+	if (root == (uint8_t *) 0 ||
+	    t == (TCMerkleState_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (t->leaf_len != 0) {
+		(void)tc_sha256_final(leaf_hash, &t->leaf);
+		push_leaf(t, leaf_hash);
+	}
+
+	if (t->leaves == 0) {
+		/* the root of an empty tree is the hash of the empty string */
+		(void)tc_sha256_init(&t->leaf);
+		(void)tc_sha256_final(root, &t->leaf);
+	} else {
+		/* fold the subtree roots from the smallest (rightmost) one */
+		top = subtrees(t->leaves);
+		(void)_copy(root, TC_SHA256_DIGEST_SIZE,
+			    t->stack[--top], TC_SHA256_DIGEST_SIZE);
+		while (top-- > 0) {
+			(void)tc_merkle_node(root, t->stack[top], root);
+		}
+	}
+
+	/* destroy the current state */
+	_set(t, 0, sizeof(*t));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_merkle_root(uint8_t *root, const uint8_t *leaf_hashes, size_t n)
+{
+	struct tc_merkle_struct t;
+	size_t i;
+
+	/* input sanity check: */
+	if (root == (uint8_t *) 0 ||
+	    (leaf_hashes == (const uint8_t *) 0 && n > 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_merkle_init(&t);
+	for (i = 0; i < n; ++i) {
+		push_leaf(&t, &leaf_hashes[i * TC_SHA256_DIGEST_SIZE]);
+	}
+
+	return tc_merkle_final(root, &t);
+}
+
+/* largest power of two smaller than n (n > 1) */
+static size_t split(size_t n)
+{
+	size_t k = 1;
+
+	while (k < n - k) {
+		k <<= 1;
+	}
+
+	return k;
+}
+
+/*
+ * Stores the subtree of the n leaf hashes at nodes: its root first, then the
+ * left subtree (2k - 1 nodes), then the right subtree, so that a subtree of n
+ * leaves always spans 2n - 1 consecutive nodes.
+ */
+static void build(uint8_t *nodes, const uint8_t *leaf_hashes, size_t n)
+{
+	size_t k;
+
+	if (n == 1) {
+		(void)_copy(nodes, TC_SHA256_DIGEST_SIZE,
+			    leaf_hashes, TC_SHA256_DIGEST_SIZE);
+		return;
+	}
+
+	k = split(n);
+	build(&nodes[TC_SHA256_DIGEST_SIZE], leaf_hashes, k);
+	build(&nodes[2 * k * TC_SHA256_DIGEST_SIZE],
+	      &leaf_hashes[k * TC_SHA256_DIGEST_SIZE], n - k);
+	(void)tc_merkle_node(nodes, &nodes[TC_SHA256_DIGEST_SIZE],
+			     &nodes[2 * k * TC_SHA256_DIGEST_SIZE]);
+}
+
+int tc_merkle_tree_build(uint8_t *root, uint8_t *nodes,
+			 const uint8_t *leaf_hashes, size_t n)
+{
+	/* input sanity check: */
+	if (root == (uint8_t *) 0 ||
+	    nodes == (uint8_t *) 0 ||
+	    leaf_hashes == (const uint8_t *) 0 ||
+	    n == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	build(nodes, leaf_hashes, n);
+	(void)_copy(root, TC_SHA256_DIGEST_SIZE, nodes, TC_SHA256_DIGEST_SIZE);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_merkle_tree_update(uint8_t *root, uint8_t *nodes, size_t n, size_t i,
+			  const uint8_t *leaf_hash)
+{
+	/* offsets of the subtree roots on the path, and of their children */
+	size_t path[TC_MERKLE_MAX_DEPTH];
+	size_t left[TC_MERKLE_MAX_DEPTH];
+	size_t right[TC_MERKLE_MAX_DEPTH];
+	unsigned int depth = 0;
+	size_t off = 0;
+	size_t k;
+
+	/* input sanity check: */
+	if (root == (uint8_t *) 0 ||
+	    nodes == (uint8_t *) 0 ||
+	    leaf_hash == (const uint8_t *) 0 ||
+	    i >= n) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* walk down to leaf i, then rehash the O(log n) nodes above it */
+	while (n > 1) {
+		k = split(n);
+		path[depth] = off;
+		left[depth] = off + 1;
+		right[depth] = off + 2 * k;
+		if (i < k) {
+			off = left[depth];
+			n = k;
+		} else {
+			off = right[depth];
+			i -= k;
+			n -= k;
+		}
+		++depth;
+	}
+
+	(void)_copy(&nodes[off * TC_SHA256_DIGEST_SIZE], TC_SHA256_DIGEST_SIZE,
+		    leaf_hash, TC_SHA256_DIGEST_SIZE);
+	while (depth-- > 0) {
+		(void)tc_merkle_node(&nodes[path[depth] * TC_SHA256_DIGEST_SIZE],
+				     &nodes[left[depth] * TC_SHA256_DIGEST_SIZE],
+				     &nodes[right[depth] * TC_SHA256_DIGEST_SIZE]);
+	}
+	(void)_copy(root, TC_SHA256_DIGEST_SIZE, nodes, TC_SHA256_DIGEST_SIZE);
+
+	return TC_CRYPTO_SUCCESS;
+}
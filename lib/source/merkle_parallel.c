@@ -0,0 +1,163 @@
+/* merkle_parallel.c - TinyCrypt implementation of a multi-threaded Merkle tree hash */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(unix) || defined(__linux__) || defined(__unix__) || \
+    defined(__unix) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(TC_POSIX)
+
+#include <tinycrypt/merkle_parallel.h>
+#include <tinycrypt/thread_pool.h>
+#include <tinycrypt/constants.h>
+
+/* struct merkle_job describes how the input is split into runs of leaves */
+struct merkle_job {
+	const uint8_t *data;
+	size_t datalen;
+/* leaves per run (the last run may be shorter) */
+	size_t run_leaves;
+/* leaf hashes output, or NULL to output the root of each run */
+	uint8_t *leaf_hashes;
+/* root of each run */
+	uint8_t roots[TC_THREAD_POOL_MAX_THREADS][TC_SHA256_DIGEST_SIZE];
+};
+
+/* number of leaves of a datalen bytes input */
+static size_t count_leaves(size_t datalen)
+{
+	return datalen / TC_MERKLE_LEAF_SIZE +
+	       (datalen % TC_MERKLE_LEAF_SIZE != 0);
+}
+
+/* hashes the leaves of run i */
+static void merkle_run(void *arg, unsigned int i)
+{
+	struct merkle_job *job = (struct merkle_job *) arg;
+	struct tc_merkle_struct t;
+	size_t first = (size_t) i * job->run_leaves;
+	size_t off = first * TC_MERKLE_LEAF_SIZE;
+	size_t len = job->run_leaves * TC_MERKLE_LEAF_SIZE;
+	size_t n;
+
+	if (len > job->datalen - off) {
+		len = job->datalen - off;
+	}
+
+	if (job->leaf_hashes == (uint8_t *) 0) {
+		(void)tc_merkle_init(&t);
+		(void)tc_merkle_update(&t, &job->data[off], len);
+		(void)tc_merkle_final(job->roots[i], &t);
+		return;
+	}
+
+	for (; len > 0; len -= n, off += n, ++first) {
+		n = len < TC_MERKLE_LEAF_SIZE ? len : TC_MERKLE_LEAF_SIZE;
+		(void)tc_merkle_leaf(&job->leaf_hashes[first *
+						       TC_SHA256_DIGEST_SIZE],
+				     &job->data[off], n);
+	}
+}
+
+/*
+ * Splits the input into at most nthreads runs of a power of two of leaves,
+ * so that every run but the last is a complete subtree, and hashes them on
+ * the worker pool. Returns the number of runs.
+ */
+static unsigned int run(struct merkle_job *job, unsigned int nthreads)
+{
+	size_t leaves = count_leaves(job->datalen);
+	unsigned int nruns;
+
+	if (nthreads > TC_THREAD_POOL_MAX_THREADS) {
+		nthreads = TC_THREAD_POOL_MAX_THREADS;
+	}
+	job->run_leaves = 1;
+	while (job->run_leaves < TC_MERKLE_PARALLEL_MIN_LEAVES ||
+	       (leaves + job->run_leaves - 1) / job->run_leaves > nthreads) {
+		job->run_leaves <<= 1;
+	}
+	nruns = (unsigned int) ((leaves + job->run_leaves - 1) /
+				job->run_leaves);
+
+	(void)tc_thread_pool_run(&merkle_run, job, nruns, nruns);
+
+	return nruns;
+}
+
+int tc_merkle_root_parallel(uint8_t *root, const uint8_t *data,
+			    size_t datalen, unsigned int nthreads)
+{
+	struct merkle_job job;
+	unsigned int nruns;
+
+	/* input sanity check: */
+	if (root == (uint8_t *) 0 ||
+	    (data == (const uint8_t *) 0 && datalen > 0) ||
+	    nthreads == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (datalen == 0) {
+		/* the root of an empty tree is the hash of the empty string */
+		return tc_merkle_root(root, (const uint8_t *) 0, 0);
+	}
+
+	job.data = data;
+	job.datalen = datalen;
+	job.leaf_hashes = (uint8_t *) 0;
+	nruns = run(&job, nthreads);
+
+	/* the runs are complete subtrees, combined like leaves (RFC 6962) */
+	return tc_merkle_root(root, &job.roots[0][0], nruns);
+}
+
+int tc_merkle_leaves_parallel(uint8_t *leaf_hashes, const uint8_t *data,
+			      size_t datalen, unsigned int nthreads)
+{
+	struct merkle_job job;
+
+	/* input sanity check: */
+	if (leaf_hashes == (uint8_t *) 0 ||
+	    data == (const uint8_t *) 0 ||
+	    datalen == 0 ||
+	    nthreads == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	job.data = data;
+	job.datalen = datalen;
+	job.leaf_hashes = leaf_hashes;
+	(void)run(&job, nthreads);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+#endif /* platform */
@@ -0,0 +1,144 @@
+/* pbkdf2.c - TinyCrypt implementation of PBKDF2-HMAC-SHA256 */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/pbkdf2.h>
+#include <tinycrypt/sha256.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/*
+ * Computes HMAC(P, u) in place for the iterations after the first: one
+ * compression for the inner hash of the 32-byte message, one for the outer
+ * hash.
+ */
+static void prf_32(uint8_t *u, const struct tc_hmac_midstates_struct *m)
+{
+	(void)tc_sha256_midstate_32(u, &m->inner, u);
+	(void)tc_sha256_midstate_32(u, &m->outer, u);
+}
+
+static void derive_block(uint8_t *block,
+			 const struct tc_hmac_midstates_struct *m,
+			 const uint8_t *salt, size_t saltlen,
+			 unsigned int iterations, uint32_t index)
+{
+	uint8_t u[TC_SHA256_DIGEST_SIZE];
+	uint8_t be_index[4];
+	struct tc_iovec iov[2];
+	unsigned int i, j;
+
+	be_index[0] = (uint8_t)(index >> 24);
+	be_index[1] = (uint8_t)(index >> 16);
+	be_index[2] = (uint8_t)(index >> 8);
+	be_index[3] = (uint8_t)(index);
+
+	iov[0].iov_base = salt;
+	iov[0].iov_len = saltlen;
+	iov[1].iov_base = be_index;
+	iov[1].iov_len = sizeof(be_index);
+	(void)tc_hmac_midstates_v(u, m, iov, 2);
+	(void)_copy(block, TC_SHA256_DIGEST_SIZE, u, sizeof(u));
+
+	for (i = 1; i < iterations; ++i) {
+		prf_32(u, m);
+		for (j = 0; j < sizeof(u); ++j) {
+			block[j] ^= u[j];
+		}
+	}
+
+	_set_secure(u, 0, sizeof(u));
+}
+
+int tc_pbkdf2_sha256(uint8_t *out, size_t outlen,
+		     const uint8_t *password, unsigned int passwordlen,
+		     const uint8_t *salt, size_t saltlen,
+		     unsigned int iterations)
+{
+	struct tc_hmac_midstates_struct m;
+	uint8_t block[TC_SHA256_DIGEST_SIZE];
+	uint32_t index;
+	size_t n;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    outlen == 0 ||
+	    (uint64_t) outlen >
+	    (uint64_t) TC_PBKDF2_MAX_BLOCKS * TC_SHA256_DIGEST_SIZE ||
+	    (password == (const uint8_t *) 0 && passwordlen > 0) ||
+	    (salt == (const uint8_t *) 0 && saltlen > 0) ||
+	    iterations == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_hmac_set_midstates(&m, password, passwordlen);
+
+	for (index = 1; outlen > 0; ++index) {
+		if (outlen >= TC_SHA256_DIGEST_SIZE) {
+			derive_block(out, &m, salt, saltlen, iterations, index);
+			n = TC_SHA256_DIGEST_SIZE;
+		} else {
+			derive_block(block, &m, salt, saltlen, iterations, index);
+			n = outlen;
+			(void)_copy(out, n, block, n);
+		}
+		out += n;
+		outlen -= n;
+	}
+
+	_set_secure(block, 0, sizeof(block));
+	(void)tc_hmac_midstates_erase(&m);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_pbkdf2_sha256_block(uint8_t *block,
+			   const uint8_t *password, unsigned int passwordlen,
+			   const uint8_t *salt, size_t saltlen,
+			   unsigned int iterations, uint32_t index)
+{
+	struct tc_hmac_midstates_struct m;
+
+	/* input sanity check: */
+	if (block == (uint8_t *) 0 ||
+	    (password == (const uint8_t *) 0 && passwordlen > 0) ||
+	    (salt == (const uint8_t *) 0 && saltlen > 0) ||
+	    index == 0 ||
+	    iterations == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_hmac_set_midstates(&m, password, passwordlen);
+	derive_block(block, &m, salt, saltlen, iterations, index);
+	(void)tc_hmac_midstates_erase(&m);
+
+	return TC_CRYPTO_SUCCESS;
+}
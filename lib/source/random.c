@@ -0,0 +1,294 @@
+/* random.c - TinyCrypt implementation of a per-thread PRNG pool */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(unix) || defined(__linux__) || defined(__unix__) || \
+    defined(__unix) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(TC_POSIX)
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <tinycrypt/random.h>
+#include <tinycrypt/hmac_prng.h>
+#include <tinycrypt/ecc_platform_specific.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TC_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define TC_THREAD_LOCAL _Thread_local
+#endif
+
+/* bytes per call to tc_hmac_prng_generate (SP 800-90A allows up to 2^19) */
+#define TC_RANDOM_CHUNK_SIZE (1U << 16)
+
+/* struct tc_random_instance is the PRNG state of one thread */
+struct tc_random_instance {
+/* the HMAC-PRNG */
+	struct tc_hmac_prng_struct prng;
+/* calls left before the next reseed */
+	unsigned int countdown;
+/* value of fork_generation when prng was seeded */
+	unsigned int generation;
+/* whether prng has been instantiated */
+	int seeded;
+};
+
+#if defined(TC_THREAD_LOCAL)
+static TC_THREAD_LOCAL struct tc_random_instance instance;
+#else
+/* without thread-local storage, the threads share one locked instance */
+static struct tc_random_instance instance;
+static pthread_mutex_t instance_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* incremented in the child after each fork() */
+static volatile unsigned int fork_generation;
+
+/* numbers the instances, to make their personalization strings unique */
+static uint64_t instance_count;
+static pthread_mutex_t instance_count_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#if defined(TC_THREAD_LOCAL)
+/* erases the instance of a thread when the thread exits */
+static pthread_key_t instance_key;
+#endif
+static pthread_once_t setup_once = PTHREAD_ONCE_INIT;
+
+static void lock_instance(void)
+{
+#if !defined(TC_THREAD_LOCAL)
+	(void)pthread_mutex_lock(&instance_lock);
+#endif
+}
+
+static void unlock_instance(void)
+{
+#if !defined(TC_THREAD_LOCAL)
+	(void)pthread_mutex_unlock(&instance_lock);
+#endif
+}
+
+/*
+ * The locks are held across fork(), so that the child does not inherit them
+ * locked by a thread that no longer exists
+ */
+static void on_fork_prepare(void)
+{
+	lock_instance();
+	(void)pthread_mutex_lock(&instance_count_lock);
+}
+
+static void on_fork_parent(void)
+{
+	(void)pthread_mutex_unlock(&instance_count_lock);
+	unlock_instance();
+}
+
+static void on_fork_child(void)
+{
+	(void)pthread_mutex_unlock(&instance_count_lock);
+	unlock_instance();
+	fork_generation++;
+}
+
+#if defined(TC_THREAD_LOCAL)
+static void on_thread_exit(void *p)
+{
+	_set_secure(p, 0, sizeof(struct tc_random_instance));
+}
+#endif
+
+static void setup(void)
+{
+	(void)pthread_atfork(&on_fork_prepare, &on_fork_parent,
+			     &on_fork_child);
+#if defined(TC_THREAD_LOCAL)
+	(void)pthread_key_create(&instance_key, &on_thread_exit);
+#endif
+}
+
+/*
+ * Instantiates (or, after a fork, re-instantiates) the PRNG of the calling
+ * thread. The personalization string is the process id, the address of the
+ * instance and a process-wide instance number, which are unique among the
+ * threads of all running processes.
+ */
+static int instantiate(struct tc_random_instance *r)
+{
+	struct {
+		pid_t pid;
+		const void *address;
+		uint64_t number;
+	} personalization;
+	uint8_t seed[TC_RANDOM_SEED_SIZE];
+	int result;
+
+	(void)pthread_once(&setup_once, &setup);
+
+	_set(&personalization, 0, sizeof(personalization));
+	personalization.pid = getpid();
+	personalization.address = r;
+	(void)pthread_mutex_lock(&instance_count_lock);
+	personalization.number = ++instance_count;
+	(void)pthread_mutex_unlock(&instance_count_lock);
+
+	if (!default_CSPRNG(seed, sizeof(seed))) {
+		return TC_CRYPTO_FAIL;
+	}
+	result = tc_hmac_prng_init(&r->prng, (const uint8_t *) &personalization,
+				   sizeof(personalization)) &&
+		 tc_hmac_prng_reseed(&r->prng, seed, sizeof(seed), 0, 0);
+	_set_secure(seed, 0, sizeof(seed));
+	if (!result) {
+		return TC_CRYPTO_FAIL;
+	}
+
+#if defined(TC_THREAD_LOCAL)
+	if (!r->seeded) {
+		(void)pthread_setspecific(instance_key, r);
+	}
+#endif
+	r->generation = fork_generation;
+	r->countdown = TC_RANDOM_RESEED_INTERVAL;
+	r->seeded = 1;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/*
+ * Mixes fresh kernel entropy into the PRNG of the calling thread.
+ */
+static int reseed(struct tc_random_instance *r)
+{
+	uint8_t seed[TC_RANDOM_SEED_SIZE];
+	int result;
+
+	if (!default_CSPRNG(seed, sizeof(seed))) {
+		return TC_CRYPTO_FAIL;
+	}
+	result = tc_hmac_prng_reseed(&r->prng, seed, sizeof(seed), 0, 0);
+	_set_secure(seed, 0, sizeof(seed));
+	if (!result) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	r->countdown = TC_RANDOM_RESEED_INTERVAL;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+/*
+ * Fills out with len bytes from r, instantiating or reseeding it first as
+ * needed.
+ */
+static int generate(struct tc_random_instance *r, uint8_t *out, size_t len)
+{
+	unsigned int n;
+	int result;
+
+	if (!r->seeded || r->generation != fork_generation) {
+		if (!instantiate(r)) {
+			return TC_CRYPTO_FAIL;
+		}
+	} else if (r->countdown == 0) {
+		if (!reseed(r)) {
+			return TC_CRYPTO_FAIL;
+		}
+	}
+	r->countdown--;
+
+	while (len > 0) {
+		n = len > TC_RANDOM_CHUNK_SIZE ? TC_RANDOM_CHUNK_SIZE :
+		    (unsigned int) len;
+		result = tc_hmac_prng_generate(out, n, &r->prng);
+		if (result == TC_HMAC_PRNG_RESEED_REQ) {
+			if (!reseed(r)) {
+				return TC_CRYPTO_FAIL;
+			}
+			continue;
+		} else if (result != TC_CRYPTO_SUCCESS) {
+			return TC_CRYPTO_FAIL;
+		}
+		out += n;
+		len -= n;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_random_bytes(uint8_t *out, size_t len)
+{
+	int result;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 && len > 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	lock_instance();
+	result = generate(&instance, out, len);
+	unlock_instance();
+
+	return result;
+}
+
+int tc_random_erase(void)
+{
+	lock_instance();
+#if defined(TC_THREAD_LOCAL)
+	if (instance.seeded) {
+		(void)pthread_setspecific(instance_key, (const void *) 0);
+	}
+#endif
+	_set_secure(&instance, 0, sizeof(instance));
+	unlock_instance();
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int buffered_CSPRNG(uint8_t *dest, unsigned int size)
+{
+	/* input sanity check: */
+	if (dest == (uint8_t *) 0 || size == 0) {
+		return 0;
+	}
+
+	return tc_random_bytes(dest, size);
+}
+
+#endif /* platform */
@@ -0,0 +1,338 @@
+/* reseed.c - TinyCrypt implementation of a background reseed manager */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(unix) || defined(__linux__) || defined(__unix__) || \
+    defined(__unix) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(TC_POSIX)
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <tinycrypt/reseed.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+/* tc_ctr_prng_generate refuses to generate past 2^48 requests */
+#define CTR_PRNG_MAX_REQS 0x1000000000000ULL
+
+/*
+ * Fetches entropy for the entries that have none ready, outside the lock,
+ * and sleeps until an entry uses its entropy or the manager stops. Entries
+ * with an interval of 1 always fetch their own entropy, so none is
+ * prefetched for them.
+ */
+static void *background(void *arg)
+{
+	TCReseedManager_t m = (TCReseedManager_t) arg;
+	uint8_t entropy[TC_RESEED_ENTROPY_SIZE];
+	TCReseedEntry_t e;
+	unsigned int i;
+	int fetched;
+
+	(void)pthread_mutex_lock(&m->lock);
+	while (m->running) {
+		e = (TCReseedEntry_t) 0;
+		for (i = 0; i < m->num_entries; ++i) {
+			if (m->entries[i].prng && !m->entries[i].ready &&
+			    m->entries[i].interval > 1) {
+				e = &m->entries[i];
+				break;
+			}
+		}
+		if (!e) {
+			(void)pthread_cond_wait(&m->wake, &m->lock);
+			continue;
+		}
+
+		(void)pthread_mutex_unlock(&m->lock);
+		fetched = m->entropy(entropy, sizeof(entropy));
+		(void)pthread_mutex_lock(&m->lock);
+
+		if (!fetched) {
+			/*
+			 * retry when an entry asks for entropy again; a stop
+			 * signalled during the fetch was not waited for, so
+			 * check for it first
+			 */
+			if (m->running) {
+				(void)pthread_cond_wait(&m->wake, &m->lock);
+			}
+		} else if (e->prng && !e->ready) {
+			(void)_copy(e->entropy, sizeof(e->entropy),
+				    entropy, sizeof(entropy));
+			e->ready = 1;
+		}
+	}
+	(void)pthread_mutex_unlock(&m->lock);
+
+	_set_secure(entropy, 0, sizeof(entropy));
+	return (void *) 0;
+}
+
+int tc_reseed_manager_start(TCReseedManager_t m,
+			    struct tc_reseed_entry_struct *entries,
+			    unsigned int num_entries,
+			    TCReseedEntropy_t entropy)
+{
+	/* input sanity check: */
+	if (m == (TCReseedManager_t) 0 ||
+	    entries == (struct tc_reseed_entry_struct *) 0 ||
+	    num_entries == 0 ||
+	    entropy == (TCReseedEntropy_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(entries, 0, num_entries * sizeof(*entries));
+	m->entries = entries;
+	m->num_entries = num_entries;
+	m->entropy = entropy;
+	m->running = 1;
+	if (pthread_mutex_init(&m->lock, (const pthread_mutexattr_t *) 0) != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+	if (pthread_cond_init(&m->wake, (const pthread_condattr_t *) 0) != 0) {
+		(void)pthread_mutex_destroy(&m->lock);
+		return TC_CRYPTO_FAIL;
+	}
+	if (pthread_create(&m->thread, (const pthread_attr_t *) 0,
+			   &background, m) != 0) {
+		(void)pthread_cond_destroy(&m->wake);
+		(void)pthread_mutex_destroy(&m->lock);
+		return TC_CRYPTO_FAIL;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_reseed_manager_stop(TCReseedManager_t m)
+{
+	/* input sanity check: */
+	if (m == (TCReseedManager_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)pthread_mutex_lock(&m->lock);
+	m->running = 0;
+	(void)pthread_cond_signal(&m->wake);
+	(void)pthread_mutex_unlock(&m->lock);
+	(void)pthread_join(m->thread, (void **) 0);
+
+	(void)pthread_cond_destroy(&m->wake);
+	(void)pthread_mutex_destroy(&m->lock);
+	_set_secure(m->entries, 0, m->num_entries * sizeof(*m->entries));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+static TCReseedEntry_t do_register(TCReseedManager_t m, void *prng,
+				   int is_ctr, unsigned int interval)
+{
+	TCReseedEntry_t e = (TCReseedEntry_t) 0;
+	unsigned int i;
+
+	/* input sanity check: */
+	if (m == (TCReseedManager_t) 0 ||
+	    prng == (void *) 0 ||
+	    interval == 0) {
+		return (TCReseedEntry_t) 0;
+	}
+
+	(void)pthread_mutex_lock(&m->lock);
+	for (i = 0; i < m->num_entries; ++i) {
+		if (!m->entries[i].prng) {
+			e = &m->entries[i];
+			_set(e, 0, sizeof(*e));
+			e->prng = prng;
+			e->is_ctr = is_ctr;
+			e->interval = interval;
+			/* the call that reseeds counts as the first one */
+			e->calls_left = interval - 1;
+			(void)pthread_cond_signal(&m->wake);
+			break;
+		}
+	}
+	(void)pthread_mutex_unlock(&m->lock);
+
+	return e;
+}
+
+TCReseedEntry_t tc_reseed_register_hmac_prng(TCReseedManager_t m,
+					     TCHmacPrng_t prng,
+					     unsigned int interval)
+{
+	return do_register(m, prng, 0, interval);
+}
+
+TCReseedEntry_t tc_reseed_register_ctr_prng(TCReseedManager_t m,
+					    TCCtrPrng_t *prng,
+					    unsigned int interval)
+{
+	return do_register(m, prng, 1, interval);
+}
+
+int tc_reseed_unregister(TCReseedManager_t m, TCReseedEntry_t e)
+{
+	/* input sanity check: */
+	if (m == (TCReseedManager_t) 0 ||
+	    e == (TCReseedEntry_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)pthread_mutex_lock(&m->lock);
+	_set_secure(e, 0, sizeof(*e));
+	(void)pthread_mutex_unlock(&m->lock);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+static int reseed_with(TCReseedEntry_t e, const uint8_t *entropy)
+{
+	if (e->is_ctr) {
+		return tc_ctr_prng_reseed((TCCtrPrng_t *) e->prng,
+					  entropy, TC_RESEED_ENTROPY_SIZE,
+					  (const uint8_t *) 0, 0);
+	}
+	return tc_hmac_prng_reseed((TCHmacPrng_t) e->prng,
+				   entropy, TC_RESEED_ENTROPY_SIZE,
+				   (const uint8_t *) 0, 0);
+}
+
+/*
+ * Reseeds the PRNG of e if its interval has elapsed: with an interval of 1
+ * (prediction resistance), always with entropy fetched now; otherwise with
+ * the prefetched entropy if it is ready, or, if the PRNG cannot generate
+ * (exhausted), with entropy fetched now. Called by the thread using the
+ * PRNG, so the PRNG needs no lock.
+ */
+static int reseed_if_due(TCReseedManager_t m, TCReseedEntry_t e,
+			 int exhausted)
+{
+	uint8_t entropy[TC_RESEED_ENTROPY_SIZE];
+	int ready;
+	int result = TC_CRYPTO_SUCCESS;
+
+	if (e->calls_left > 0 && !exhausted) {
+		e->calls_left--;
+		return TC_CRYPTO_SUCCESS;
+	}
+
+	if (e->interval == 1) {
+		/* never use entropy that waited in memory */
+		if (!m->entropy(entropy, sizeof(entropy))) {
+			return TC_CRYPTO_FAIL;
+		}
+		e->sync_reseeds++;
+		result = reseed_with(e, entropy);
+		_set_secure(entropy, 0, sizeof(entropy));
+		return result;
+	}
+
+	(void)pthread_mutex_lock(&m->lock);
+	ready = e->ready;
+	if (ready) {
+		(void)_copy(entropy, sizeof(entropy),
+			    e->entropy, sizeof(e->entropy));
+		_set_secure(e->entropy, 0, sizeof(e->entropy));
+		e->ready = 0;
+	}
+	/* have the next entropy fetched in the background */
+	(void)pthread_cond_signal(&m->wake);
+	(void)pthread_mutex_unlock(&m->lock);
+
+	if (ready) {
+		e->reseeds++;
+	} else if (exhausted) {
+		if (!m->entropy(entropy, sizeof(entropy))) {
+			return TC_CRYPTO_FAIL;
+		}
+		e->sync_reseeds++;
+	} else {
+		/* postpone the reseed to the next call */
+		return TC_CRYPTO_SUCCESS;
+	}
+
+	if (!reseed_with(e, entropy)) {
+		result = TC_CRYPTO_FAIL;
+	}
+	_set_secure(entropy, 0, sizeof(entropy));
+	e->calls_left = e->interval - 1;
+
+	return result;
+}
+
+int tc_reseed_hmac_prng_generate(TCReseedManager_t m, TCReseedEntry_t e,
+				 uint8_t *out, unsigned int outlen)
+{
+	TCHmacPrng_t prng;
+
+	/* input sanity check: */
+	if (m == (TCReseedManager_t) 0 ||
+	    e == (TCReseedEntry_t) 0 ||
+	    e->prng == (void *) 0 ||
+	    e->is_ctr) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	prng = (TCHmacPrng_t) e->prng;
+	if (!reseed_if_due(m, e, prng->countdown == 0)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return tc_hmac_prng_generate(out, outlen, prng);
+}
+
+int tc_reseed_ctr_prng_generate(TCReseedManager_t m, TCReseedEntry_t e,
+				const uint8_t *additional_input,
+				unsigned int additionallen,
+				uint8_t *out, unsigned int outlen)
+{
+	TCCtrPrng_t *prng;
+
+	/* input sanity check: */
+	if (m == (TCReseedManager_t) 0 ||
+	    e == (TCReseedEntry_t) 0 ||
+	    e->prng == (void *) 0 ||
+	    !e->is_ctr) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	prng = (TCCtrPrng_t *) e->prng;
+	if (!reseed_if_due(m, e, prng->reseedCount > CTR_PRNG_MAX_REQS)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	return tc_ctr_prng_generate(prng, additional_input, additionallen,
+				    out, outlen);
+}
+
+#endif /* platform */
@@ -34,7 +34,19 @@
 #include <tinycrypt/constants.h>
 #include <tinycrypt/utils.h>
 
+/*
+ * Setting the initial state values.
+ * These values correspond to the first 32 bits of the fractional parts
+ * of the square roots of the first 8 primes: 2, 3, 5, 7, 11, 13, 17
+ * and 19.
+ */
+static const unsigned int sha256_iv[TC_SHA256_STATE_BLOCKS] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c,
+	0x1f83d9ab, 0x5be0cd19
+};
+
 static void compress(unsigned int *iv, const uint8_t *data);
+static void store_digest(uint8_t *digest, const unsigned int *iv);
 
 int tc_sha256_init(TCSha256State_t s)
 {
@@ -43,21 +55,9 @@ int tc_sha256_init(TCSha256State_t s)
 		return TC_CRYPTO_FAIL;
 	}
 
-	/*
-	 * Setting the initial state values.
-	 * These values correspond to the first 32 bits of the fractional parts
-	 * of the square roots of the first 8 primes: 2, 3, 5, 7, 11, 13, 17
-	 * and 19.
-	 */
 	_set((uint8_t *) s, 0x00, sizeof(*s));
-	s->iv[0] = 0x6a09e667;
-	s->iv[1] = 0xbb67ae85;
-	s->iv[2] = 0x3c6ef372;
-	s->iv[3] = 0xa54ff53a;
-	s->iv[4] = 0x510e527f;
-	s->iv[5] = 0x9b05688c;
-	s->iv[6] = 0x1f83d9ab;
-	s->iv[7] = 0x5be0cd19;
+	(void)_copy((uint8_t *) s->iv, sizeof(s->iv),
+		    (const uint8_t *) sha256_iv, sizeof(sha256_iv));
 
 	return TC_CRYPTO_SUCCESS;
 }
@@ -84,10 +84,29 @@ int tc_sha256_update(TCSha256State_t s, const uint8_t *data, size_t datalen)
 	return TC_CRYPTO_SUCCESS;
 }
 
-int tc_sha256_final(uint8_t *digest, TCSha256State_t s)
+int tc_sha256_update_v(TCSha256State_t s, const struct tc_iovec *iov,
+		       unsigned int iovcnt)
 {
+	size_t len;
 	unsigned int i;
 
+	/* input sanity check: */
+	if (s == (TCSha256State_t) 0 ||
+	    !tc_iovec_length(&len, iov, iovcnt)) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	for (i = 0; i < iovcnt; ++i) {
+		if (iov[i].iov_len > 0) {
+			(void)tc_sha256_update(s, iov[i].iov_base, iov[i].iov_len);
+		}
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_final(uint8_t *digest, TCSha256State_t s)
+{
 	/* input sanity check: */
 	if (digest == (uint8_t *) 0 ||
 	    s == (TCSha256State_t) 0) {
@@ -121,13 +140,7 @@ int tc_sha256_final(uint8_t *digest, TCSha256State_t s)
 	compress(s->iv, s->leftover);
 
 	/* copy the iv out to digest */
-	for (i = 0; i < TC_SHA256_STATE_BLOCKS; ++i) {
-		unsigned int t = *((unsigned int *) &s->iv[i]);
-		*digest++ = (uint8_t)(t >> 24);
-		*digest++ = (uint8_t)(t >> 16);
-		*digest++ = (uint8_t)(t >> 8);
-		*digest++ = (uint8_t)(t);
-	}
+	store_digest(digest, s->iv);
 
 	/* destroy the current state */
 	_set(s, 0, sizeof(*s));
@@ -178,21 +191,22 @@ static inline unsigned int BigEndian(const uint8_t **c)
 	return n;
 }
 
-static void compress(unsigned int *iv, const uint8_t *data)
+/*
+ * Runs the 64 rounds on the message words w, expanding the message schedule
+ * in place.
+ */
+static void compress_words(unsigned int *iv, unsigned int *w)
 {
 	unsigned int a, b, c, d, e, f, g, h;
 	unsigned int s0, s1;
 	unsigned int t1, t2;
-	unsigned int work_space[16];
-	unsigned int n;
 	unsigned int i;
 
 	a = iv[0]; b = iv[1]; c = iv[2]; d = iv[3];
 	e = iv[4]; f = iv[5]; g = iv[6]; h = iv[7];
 
 	for (i = 0; i < 16; ++i) {
-		n = BigEndian(&data);
-		t1 = work_space[i] = n;
+		t1 = w[i];
 		t1 += h + Sigma1(e) + Ch(e, f, g) + k256[i];
 		t2 = Sigma0(a) + Maj(a, b, c);
 		h = g; g = f; f = e; e = d + t1;
@@ -200,12 +214,12 @@ static void compress(unsigned int *iv, const uint8_t *data)
 	}
 
 	for ( ; i < 64; ++i) {
-		s0 = work_space[(i+1)&0x0f];
+		s0 = w[(i+1)&0x0f];
 		s0 = sigma0(s0);
-		s1 = work_space[(i+14)&0x0f];
+		s1 = w[(i+14)&0x0f];
 		s1 = sigma1(s1);
 
-		t1 = work_space[i&0xf] += s0 + s1 + work_space[(i+9)&0xf];
+		t1 = w[i&0xf] += s0 + s1 + w[(i+9)&0xf];
 		t1 += h + Sigma1(e) + Ch(e, f, g) + k256[i];
 		t2 = Sigma0(a) + Maj(a, b, c);
 		h = g; g = f; f = e; e = d + t1;
@@ -215,3 +229,247 @@ static void compress(unsigned int *iv, const uint8_t *data)
 	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
 	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
 }
+
+static void compress(unsigned int *iv, const uint8_t *data)
+{
+	unsigned int work_space[16];
+	unsigned int i;
+
+	for (i = 0; i < 16; ++i) {
+		work_space[i] = BigEndian(&data);
+	}
+
+	compress_words(iv, work_space);
+}
+
+/*
+ * K[i] + W[i] for the padding block of a 64-byte message (0x80, zeros and
+ * the bit length 512): the whole message schedule of that block is constant.
+ */
+static const unsigned int pad64_kw[64] = {
+	0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374, 0x649b69c1, 0xf0fe4786,
+	0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+	0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0,
+	0xfdb1232b, 0xc7353eb0, 0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd,
+	0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16, 0x007f3e86, 0x37088980,
+	0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+	0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431,
+	0x6ed41a95, 0x6d437890, 0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c,
+	0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76
+};
+
+/* runs the 64 rounds on a precomputed K[i] + W[i] schedule */
+static void compress_kw(unsigned int *iv, const unsigned int *kw)
+{
+	unsigned int a, b, c, d, e, f, g, h;
+	unsigned int t1, t2;
+	unsigned int i;
+
+	a = iv[0]; b = iv[1]; c = iv[2]; d = iv[3];
+	e = iv[4]; f = iv[5]; g = iv[6]; h = iv[7];
+
+	for (i = 0; i < 64; ++i) {
+		t1 = h + Sigma1(e) + Ch(e, f, g) + kw[i];
+		t2 = Sigma0(a) + Maj(a, b, c);
+		h = g; g = f; f = e; e = d + t1;
+		d = c; c = b; b = a; a = t1 + t2;
+	}
+
+	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
+	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
+}
+
+static void store_digest(uint8_t *digest, const unsigned int *iv)
+{
+	unsigned int i;
+
+	for (i = 0; i < TC_SHA256_STATE_BLOCKS; ++i) {
+		*digest++ = (uint8_t)(iv[i] >> 24);
+		*digest++ = (uint8_t)(iv[i] >> 16);
+		*digest++ = (uint8_t)(iv[i] >> 8);
+		*digest++ = (uint8_t)(iv[i]);
+	}
+}
+
+int tc_sha256_32(uint8_t *digest, const uint8_t *data)
+{
+	unsigned int iv[TC_SHA256_STATE_BLOCKS];
+	unsigned int w[16];
+	unsigned int i;
+
+	/* input sanity check: */
+	if (digest == (uint8_t *) 0 ||
+	    data == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* a single block: the data, 0x80, zeros and the bit length 256 */
+	for (i = 0; i < 8; ++i) {
+		w[i] = BigEndian(&data);
+	}
+	w[8] = 0x80000000;
+	for (i = 9; i < 15; ++i) {
+		w[i] = 0;
+	}
+	w[15] = 256;
+
+	(void)_copy((uint8_t *) iv, sizeof(iv),
+		    (const uint8_t *) sha256_iv, sizeof(sha256_iv));
+	compress_words(iv, w);
+	store_digest(digest, iv);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_midstate_32(uint8_t *digest,
+			  const struct tc_sha256_state_struct *s,
+			  const uint8_t *data)
+{
+	unsigned int iv[TC_SHA256_STATE_BLOCKS];
+	unsigned int w[16];
+	uint64_t bits;
+	unsigned int i;
+
+	/* input sanity check: */
+	if (digest == (uint8_t *) 0 ||
+	    s == (const struct tc_sha256_state_struct *) 0 ||
+	    s->leftover_offset != 0 ||
+	    data == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* the last block: the data, 0x80, zeros and the total bit length */
+	bits = s->bits_hashed + 256;
+	for (i = 0; i < 8; ++i) {
+		w[i] = BigEndian(&data);
+	}
+	w[8] = 0x80000000;
+	for (i = 9; i < 14; ++i) {
+		w[i] = 0;
+	}
+	w[14] = (unsigned int)(bits >> 32);
+	w[15] = (unsigned int)(bits);
+
+	(void)_copy((uint8_t *) iv, sizeof(iv),
+		    (const uint8_t *) s->iv, sizeof(s->iv));
+	compress_words(iv, w);
+	store_digest(digest, iv);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_64(uint8_t *digest, const uint8_t *data)
+{
+	unsigned int iv[TC_SHA256_STATE_BLOCKS];
+
+	/* input sanity check: */
+	if (digest == (uint8_t *) 0 ||
+	    data == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)_copy((uint8_t *) iv, sizeof(iv),
+		    (const uint8_t *) sha256_iv, sizeof(sha256_iv));
+	compress(iv, data);
+	compress_kw(iv, pad64_kw);
+	store_digest(digest, iv);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256d(uint8_t *digest, const uint8_t *data, size_t datalen)
+{
+	struct tc_sha256_state_struct s;
+
+	/* input sanity check: */
+	if (digest == (uint8_t *) 0 ||
+	    data == (const uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)tc_sha256_init(&s);
+	(void)tc_sha256_update(&s, data, datalen);
+	(void)tc_sha256_final(digest, &s);
+
+	return tc_sha256_32(digest, digest);
+}
+
+int tc_sha256_clone(TCSha256State_t dst,
+		    const struct tc_sha256_state_struct *src)
+{
+	/* input sanity check: */
+	if (dst == (TCSha256State_t) 0 ||
+	    src == (const struct tc_sha256_state_struct *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	(void)_copy((uint8_t *) dst, sizeof(*dst),
+		    (const uint8_t *) src, sizeof(*src));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_export(uint8_t *out, size_t outlen,
+		     const struct tc_sha256_state_struct *s)
+{
+	unsigned int i;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    outlen < TC_SHA256_EXPORT_SIZE ||
+	    s == (const struct tc_sha256_state_struct *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	*out++ = TC_SHA256_EXPORT_VERSION;
+	store_digest(out, s->iv);
+	out += TC_SHA256_DIGEST_SIZE;
+	for (i = 0; i < 8; ++i) {
+		*out++ = (uint8_t)(s->bits_hashed >> (56 - 8 * i));
+	}
+	*out++ = (uint8_t) s->leftover_offset;
+	/* bytes past leftover_offset are stale: export zeros instead */
+	_set(out, 0, TC_SHA256_BLOCK_SIZE);
+	(void)_copy(out, TC_SHA256_BLOCK_SIZE, s->leftover, s->leftover_offset);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_import(TCSha256State_t s, const uint8_t *in, size_t inlen)
+{
+	const uint8_t *p;
+	uint64_t bits_hashed = 0;
+	unsigned int i;
+
+	/* input sanity check: */
+	if (s == (TCSha256State_t) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    inlen != TC_SHA256_EXPORT_SIZE ||
+	    in[0] != TC_SHA256_EXPORT_VERSION) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	p = &in[1 + TC_SHA256_DIGEST_SIZE];
+	for (i = 0; i < 8; ++i) {
+		bits_hashed = (bits_hashed << 8) | *p++;
+	}
+	/* only whole blocks are counted, and a full buffer is compressed */
+	if ((bits_hashed % (TC_SHA256_BLOCK_SIZE << 3)) != 0 ||
+	    *p >= TC_SHA256_BLOCK_SIZE) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(s, 0, sizeof(*s));
+	p = &in[1];
+	for (i = 0; i < TC_SHA256_STATE_BLOCKS; ++i) {
+		s->iv[i] = BigEndian(&p);
+	}
+	s->bits_hashed = bits_hashed;
+	p += 8;
+	s->leftover_offset = *p++;
+	(void)_copy(s->leftover, sizeof(s->leftover), p, s->leftover_offset);
+
+	return TC_CRYPTO_SUCCESS;
+}
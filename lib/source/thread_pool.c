@@ -0,0 +1,226 @@
+/* thread_pool.c - TinyCrypt implementation of a reusable worker thread pool */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(unix) || defined(__linux__) || defined(__unix__) || \
+    defined(__unix) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(TC_POSIX)
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <tinycrypt/thread_pool.h>
+#include <tinycrypt/constants.h>
+
+#include <pthread.h>
+
+/* struct tc_thread_pool_job describes the current run */
+struct tc_thread_pool_job {
+/* the task function and its argument */
+	TCThreadPoolTask_t task;
+	void *arg;
+/* number of tasks, index of the next task to start */
+	unsigned int ntasks;
+	unsigned int next;
+/* tasks started but not finished, or not started yet */
+	unsigned int pending;
+/* workers with a smaller number take part in the run */
+	unsigned int helpers;
+/* incremented by each run, so that sleeping workers notice it */
+	unsigned int generation;
+};
+
+static struct tc_thread_pool_job job;
+
+/* number of workers created so far */
+static unsigned int num_workers;
+
+/* serializes the runs */
+static pthread_mutex_t run_lock = PTHREAD_MUTEX_INITIALIZER;
+/* protects job and num_workers */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+/* signals a new run to the workers */
+static pthread_cond_t work = PTHREAD_COND_INITIALIZER;
+/* signals the end of the last task to the caller */
+static pthread_cond_t done = PTHREAD_COND_INITIALIZER;
+
+static pthread_once_t setup_once = PTHREAD_ONCE_INIT;
+
+/*
+ * Both locks are held across fork(), so that the child does not inherit
+ * them locked by a thread that no longer exists. No run is in progress at
+ * that point; the child has no workers and recreates them on demand.
+ */
+static void on_fork_prepare(void)
+{
+	(void)pthread_mutex_lock(&run_lock);
+	(void)pthread_mutex_lock(&lock);
+}
+
+static void on_fork_parent(void)
+{
+	(void)pthread_mutex_unlock(&lock);
+	(void)pthread_mutex_unlock(&run_lock);
+}
+
+static void on_fork_child(void)
+{
+	num_workers = 0;
+	(void)pthread_cond_init(&work, (const pthread_condattr_t *) 0);
+	(void)pthread_cond_init(&done, (const pthread_condattr_t *) 0);
+	(void)pthread_mutex_unlock(&lock);
+	(void)pthread_mutex_unlock(&run_lock);
+}
+
+static void setup(void)
+{
+	(void)pthread_atfork(&on_fork_prepare, &on_fork_parent,
+			     &on_fork_child);
+}
+
+/*
+ * Runs the tasks of the current job until none is left to start.
+ * Assumes: lock is held; it is released while a task runs
+ */
+static void run_tasks(void)
+{
+	unsigned int i;
+
+	while (job.next < job.ntasks) {
+		i = job.next++;
+		(void)pthread_mutex_unlock(&lock);
+		job.task(job.arg, i);
+		(void)pthread_mutex_lock(&lock);
+		if (--job.pending == 0) {
+			(void)pthread_cond_signal(&done);
+		}
+	}
+}
+
+static void *worker(void *arg)
+{
+	unsigned int number = (unsigned int) (size_t) arg;
+	unsigned int seen;
+
+	(void)pthread_mutex_lock(&lock);
+	seen = job.generation;
+	for (;;) {
+		while (job.generation == seen) {
+			(void)pthread_cond_wait(&work, &lock);
+		}
+		seen = job.generation;
+		if (number < job.helpers) {
+			run_tasks();
+		}
+	}
+
+	return (void *) 0;
+}
+
+/*
+ * Creates workers until there are n of them, or until creation fails.
+ * Assumes: run_lock is held
+ */
+static void add_workers(unsigned int n)
+{
+	pthread_attr_t attr;
+	pthread_t thread;
+
+	if (num_workers >= n ||
+	    pthread_attr_init(&attr) != 0) {
+		return;
+	}
+	(void)pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	(void)pthread_mutex_lock(&lock);
+	while (num_workers < n &&
+	       pthread_create(&thread, &attr, &worker,
+			      (void *) (size_t) num_workers) == 0) {
+		num_workers++;
+	}
+	(void)pthread_mutex_unlock(&lock);
+
+	(void)pthread_attr_destroy(&attr);
+}
+
+int tc_thread_pool_run(TCThreadPoolTask_t task, void *arg,
+		       unsigned int ntasks, unsigned int nthreads)
+{
+	/* input sanity check: */
+	if (task == (TCThreadPoolTask_t) 0 ||
+	    nthreads == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	if (nthreads > TC_THREAD_POOL_MAX_THREADS) {
+		nthreads = TC_THREAD_POOL_MAX_THREADS;
+	}
+	if (nthreads > ntasks) {
+		nthreads = ntasks;
+	}
+	if (nthreads <= 1) {
+		/* nothing to share: no locking at all */
+		unsigned int i;
+
+		for (i = 0; i < ntasks; ++i) {
+			task(arg, i);
+		}
+		return TC_CRYPTO_SUCCESS;
+	}
+
+	(void)pthread_once(&setup_once, &setup);
+	(void)pthread_mutex_lock(&run_lock);
+	add_workers(nthreads - 1);
+
+	(void)pthread_mutex_lock(&lock);
+	job.task = task;
+	job.arg = arg;
+	job.ntasks = ntasks;
+	job.next = 0;
+	job.pending = ntasks;
+	job.helpers = nthreads - 1;
+	job.generation++;
+	(void)pthread_cond_broadcast(&work);
+
+	/* the calling thread takes its share of the tasks */
+	run_tasks();
+	while (job.pending > 0) {
+		(void)pthread_cond_wait(&done, &lock);
+	}
+	(void)pthread_mutex_unlock(&lock);
+
+	(void)pthread_mutex_unlock(&run_lock);
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+#endif /* platform */
@@ -0,0 +1,263 @@
+/* xts_mode.c - TinyCrypt XTS mode implementation */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tinycrypt/xts_mode.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/utils.h>
+
+#define TWEAK_WORDS (TC_AES_BLOCK_SIZE / 4)
+
+/*
+ * Reduction value of GF(2^128) doubling; see gf_wrap in cmac_mode.c. XTS
+ * represents field elements in little-endian order, so the overflow leaves
+ * the most significant bit of byte 15 and the reduction enters byte 0.
+ */
+static const unsigned int xts_wrap = 0x87;
+
+/*
+ * The tweak is kept as four 32-bit words, t[0] holding bytes 0-3 of the
+ * little-endian field element, so that doubling works a word at a time.
+ */
+static void tweak_load(unsigned int *t, const uint8_t *b)
+{
+	unsigned int i;
+
+	for (i = 0; i < TWEAK_WORDS; ++i, b += 4) {
+		t[i] = ((unsigned int) b[0]) | ((unsigned int) b[1] << 8) |
+		       ((unsigned int) b[2] << 16) | ((unsigned int) b[3] << 24);
+	}
+}
+
+/*
+ * Multiplies the tweak by alpha (the polynomial x) in GF(2^128).
+ */
+static void tweak_double(unsigned int *t)
+{
+	unsigned int carry = t[3] >> 31;
+
+	t[3] = (t[3] << 1) | (t[2] >> 31);
+	t[2] = (t[2] << 1) | (t[1] >> 31);
+	t[1] = (t[1] << 1) | (t[0] >> 31);
+	t[0] = (t[0] << 1) ^ (xts_wrap & (0U - carry));
+}
+
+/*
+ * out = in ^ t, for one block; out and in may be the same buffer.
+ */
+static void tweak_xor(uint8_t *out, const uint8_t *in, const unsigned int *t)
+{
+	unsigned int i;
+
+	for (i = 0; i < TWEAK_WORDS; ++i, in += 4, out += 4) {
+		out[0] = in[0] ^ (uint8_t)(t[i]);
+		out[1] = in[1] ^ (uint8_t)(t[i] >> 8);
+		out[2] = in[2] ^ (uint8_t)(t[i] >> 16);
+		out[3] = in[3] ^ (uint8_t)(t[i] >> 24);
+	}
+}
+
+typedef int (*block_cipher)(uint8_t *out, const uint8_t *in,
+			    const TCAesKeySched_t s);
+
+/*
+ * XEX processing of one block: out = E(in ^ t) ^ t.
+ */
+static void xex_block(uint8_t *out, const uint8_t *in, const unsigned int *t,
+		      block_cipher cipher, const TCAesKeySched_t sched)
+{
+	uint8_t buffer[TC_AES_BLOCK_SIZE];
+
+	tweak_xor(buffer, in, t);
+	(void)cipher(buffer, buffer, sched);
+	tweak_xor(out, buffer, t);
+}
+
+/*
+ * Processes one data unit; decrypt selects the order in which the tweaks of
+ * the last two blocks are used when ciphertext stealing is needed.
+ */
+static int xts_data_unit(uint8_t *out, const uint8_t *in, unsigned int len,
+			 const uint8_t *tweak, const TCAesKeySched_t data_sched,
+			 const TCAesKeySched_t tweak_sched, block_cipher cipher,
+			 int decrypt)
+{
+	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	unsigned int t[TWEAK_WORDS];
+	unsigned int t_last[TWEAK_WORDS];
+	unsigned int tail = len % TC_AES_BLOCK_SIZE;
+	unsigned int nblocks = len / TC_AES_BLOCK_SIZE;
+	unsigned int i;
+
+	/* input sanity check: */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    tweak == (const uint8_t *) 0 ||
+	    data_sched == (TCAesKeySched_t) 0 ||
+	    tweak_sched == (TCAesKeySched_t) 0 ||
+	    len < TC_AES_BLOCK_SIZE ||
+	    len > TC_XTS_MAX_DATA_UNIT) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/*
+	 * key1 and key2 must differ: the first TC_AES_KEY_SIZE bytes of an
+	 * AES-128 key schedule (encryption or decryption) are the key itself.
+	 */
+	if (_compare((const uint8_t *) data_sched->words,
+		     (const uint8_t *) tweak_sched->words,
+		     TC_AES_KEY_SIZE) == 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/* the initial tweak is the encryption of the tweak value under key2 */
+	(void)tc_aes_encrypt(buffer, tweak, tweak_sched);
+	tweak_load(t, buffer);
+
+	/* the last full block takes part in ciphertext stealing, if any */
+	if (tail != 0) {
+		--nblocks;
+	}
+
+	for (i = 0; i < nblocks; ++i) {
+		xex_block(out, in, t, cipher, data_sched);
+		tweak_double(t);
+		in += TC_AES_BLOCK_SIZE;
+		out += TC_AES_BLOCK_SIZE;
+	}
+
+	if (tail != 0) {
+		/*
+		 * Ciphertext stealing: encryption processes the last full
+		 * block under tweak t and the padded partial block under the
+		 * next tweak; decryption uses them in the reverse order.
+		 */
+		for (i = 0; i < TWEAK_WORDS; ++i) {
+			t_last[i] = t[i];
+		}
+		tweak_double(t_last);
+		if (decrypt) {
+			xex_block(buffer, in, t_last, cipher, data_sched);
+		} else {
+			xex_block(buffer, in, t, cipher, data_sched);
+		}
+
+		/* steal the head of buffer for the final partial block */
+		for (i = 0; i < tail; ++i) {
+			uint8_t c = buffer[i];
+
+			buffer[i] = in[TC_AES_BLOCK_SIZE + i];
+			out[TC_AES_BLOCK_SIZE + i] = c;
+		}
+
+		if (decrypt) {
+			xex_block(out, buffer, t, cipher, data_sched);
+		} else {
+			xex_block(out, buffer, t_last, cipher, data_sched);
+		}
+		_set(t_last, 0, sizeof(t_last));
+	}
+
+	/* zeroing out the tweak and buffer */
+	_set(t, 0, sizeof(t));
+	_set(buffer, 0, sizeof(buffer));
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_xts_mode_encrypt(uint8_t *out, const uint8_t *in, unsigned int len,
+			const uint8_t *tweak, const TCAesKeySched_t data_sched,
+			const TCAesKeySched_t tweak_sched)
+{
+	return xts_data_unit(out, in, len, tweak, data_sched, tweak_sched,
+			     tc_aes_encrypt, 0);
+}
+
+int tc_xts_mode_decrypt(uint8_t *out, const uint8_t *in, unsigned int len,
+			const uint8_t *tweak, const TCAesKeySched_t data_sched,
+			const TCAesKeySched_t tweak_sched)
+{
+	return xts_data_unit(out, in, len, tweak, data_sched, tweak_sched,
+			     tc_aes_decrypt, 1);
+}
+
+static int xts_sectors(uint8_t *out, const uint8_t *in, size_t len,
+		       unsigned int sector_size, uint64_t sector,
+		       const TCAesKeySched_t data_sched,
+		       const TCAesKeySched_t tweak_sched, block_cipher cipher,
+		       int decrypt)
+{
+	uint8_t tweak[TC_AES_BLOCK_SIZE];
+	unsigned int i;
+
+	/* input sanity check (the rest is checked per sector): */
+	if (out == (uint8_t *) 0 ||
+	    in == (const uint8_t *) 0 ||
+	    sector_size < TC_AES_BLOCK_SIZE ||
+	    len == 0 ||
+	    (len % sector_size) != 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	_set(tweak, 0, sizeof(tweak));
+	for (; len > 0; len -= sector_size, ++sector) {
+		/* the tweak value is the sector number in little-endian */
+		for (i = 0; i < 8; ++i) {
+			tweak[i] = (uint8_t)(sector >> (8 * i));
+		}
+		if (!xts_data_unit(out, in, sector_size, tweak, data_sched,
+				   tweak_sched, cipher, decrypt)) {
+			return TC_CRYPTO_FAIL;
+		}
+		in += sector_size;
+		out += sector_size;
+	}
+
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_xts_mode_encrypt_sectors(uint8_t *out, const uint8_t *in, size_t len,
+				unsigned int sector_size, uint64_t sector,
+				const TCAesKeySched_t data_sched,
+				const TCAesKeySched_t tweak_sched)
+{
+	return xts_sectors(out, in, len, sector_size, sector, data_sched,
+			   tweak_sched, tc_aes_encrypt, 0);
+}
+
+int tc_xts_mode_decrypt_sectors(uint8_t *out, const uint8_t *in, size_t len,
+				unsigned int sector_size, uint64_t sector,
+				const TCAesKeySched_t data_sched,
+				const TCAesKeySched_t tweak_sched)
+{
+	return xts_sectors(out, in, len, sector_size, sector, data_sched,
+			   tweak_sched, tc_aes_decrypt, 1);
+}
@@ -0,0 +1,335 @@
+/* test_aes_cache.c - TinyCrypt implementation of some AES key schedule cache tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following AES key schedule cache routines:
+ *
+ * Scenarios tested include:
+ * - AES128 key schedule cache miss and hit
+ * - AES128 key schedule cache CLOCK replacement
+ * - AES128 key schedule cache eviction
+ * - AES128 key schedule cache CLOCK replacement within a set
+ * - AES128 key schedule cache geometry checks
+ */
+
+#include <tinycrypt/aes_cache.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_OF_ENTRIES 2
+#define NUM_OF_SETS 4
+
+static const uint8_t hash_key[TC_AES_CACHE_HASH_KEY_SIZE] = {
+	0x0f, 0x0e, 0x0d, 0x0c, 0x0b, 0x0a, 0x09, 0x08,
+	0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00
+};
+
+static const uint8_t key_a[TC_AES_KEY_SIZE] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const uint8_t key_b[TC_AES_KEY_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t key_c[TC_AES_KEY_SIZE] = {
+	0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+	0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+};
+
+/*
+ * A miss expands the key; a hit returns the same key schedule.
+ */
+unsigned int test_1(TCAesCache_t cache)
+{
+	unsigned int result = TC_PASS;
+	struct tc_aes_key_sched_struct expected;
+	TCAesKeySched_t s1, s2;
+
+	TC_PRINT("AES cache test #1 (miss and hit):\n");
+
+	(void)tc_aes128_set_encrypt_key(&expected, key_a);
+	s1 = tc_aes_cache_lookup(cache, key_a);
+	if (s1 == (TCAesKeySched_t) 0) {
+		TC_ERROR("AES cache lookup failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	result = check_result(1, expected.words, sizeof(expected.words),
+			      s1->words, sizeof(s1->words));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+
+	s2 = tc_aes_cache_lookup(cache, key_a);
+	if (s2 != s1) {
+		TC_ERROR("AES cache hit returned another schedule in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+	}
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * With two entries referenced, the CLOCK hand gives both a second chance and
+ * then replaces the oldest one.
+ */
+unsigned int test_2(TCAesCache_t cache)
+{
+	unsigned int result = TC_PASS;
+	struct tc_aes_key_sched_struct expected;
+	TCAesKeySched_t sa, sb, sc;
+
+	TC_PRINT("AES cache test #2 (CLOCK replacement):\n");
+
+	sa = tc_aes_cache_lookup(cache, key_a);
+	sb = tc_aes_cache_lookup(cache, key_b);
+	sc = tc_aes_cache_lookup(cache, key_c);
+	if (sa == sb || sc != sa) {
+		TC_ERROR("AES cache did not replace the oldest entry in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+
+	(void)tc_aes128_set_encrypt_key(&expected, key_c);
+	result = check_result(2, expected.words, sizeof(expected.words),
+			      sc->words, sizeof(sc->words));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+
+	if (tc_aes_cache_lookup(cache, key_b) != sb) {
+		TC_ERROR("AES cache lost a cached key in %s.\n", __func__);
+		result = TC_FAIL;
+	}
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Evicting a key zeroizes its entry.
+ */
+unsigned int test_3(TCAesCache_t cache)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t zero[sizeof(struct tc_aes_key_sched_struct)] = {0};
+	struct tc_aes_cache_entry_struct *e;
+	TCAesKeySched_t sc;
+
+	TC_PRINT("AES cache test #3 (eviction):\n");
+
+	sc = tc_aes_cache_lookup(cache, key_c);
+	e = (struct tc_aes_cache_entry_struct *) sc;
+	(void)tc_aes_cache_evict(cache, key_c);
+
+	result = check_result(3, zero, sizeof(e->sched), &e->sched,
+			      sizeof(e->sched));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+	result = check_result(3, zero, sizeof(e->key), e->key, sizeof(e->key));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+	if (e->valid || e->referenced) {
+		TC_ERROR("AES cache kept an evicted entry in %s.\n", __func__);
+		result = TC_FAIL;
+	}
+
+ exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Keys mapped to the same set only compete with each other: once the set is
+ * full of referenced entries, the CLOCK hand of the set replaces its oldest
+ * entry, while the keys of the other sets stay cached.
+ */
+unsigned int test_4(TCAesCache_t cache)
+{
+	unsigned int result = TC_PASS;
+	struct tc_aes_key_sched_struct expected;
+	TCAesKeySched_t first = (TCAesKeySched_t) 0;
+	TCAesKeySched_t other = (TCAesKeySched_t) 0;
+	TCAesKeySched_t s;
+	uint8_t key[TC_AES_KEY_SIZE] = {0};
+	uint8_t other_key[TC_AES_KEY_SIZE] = {0};
+	unsigned int set, in_set0 = 0;
+	unsigned int i;
+
+	TC_PRINT("AES cache test #4 (CLOCK replacement within a set):\n");
+
+	for (i = 0; i < 256 && in_set0 <= TC_AES_CACHE_WAYS; ++i) {
+		key[0] = (uint8_t) i;
+		s = tc_aes_cache_lookup(cache, key);
+		set = (unsigned int) ((struct tc_aes_cache_entry_struct *) s -
+				      cache->entries) / TC_AES_CACHE_WAYS;
+		if (set != 0) {
+			/* keep a single, regularly used, key outside set 0 */
+			if (other == (TCAesKeySched_t) 0) {
+				other = s;
+				other_key[0] = key[0];
+				continue;
+			}
+			(void)tc_aes_cache_evict(cache, key);
+			if (tc_aes_cache_lookup(cache, other_key) != other) {
+				TC_ERROR("AES cache lost a key of another set "
+					 "in %s.\n", __func__);
+				result = TC_FAIL;
+				goto exitTest4;
+			}
+			continue;
+		}
+		if (in_set0 == 0) {
+			first = s;
+		} else if (in_set0 == TC_AES_CACHE_WAYS && s != first) {
+			TC_ERROR("AES cache did not replace the oldest entry "
+				 "of the set in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest4;
+		}
+		++in_set0;
+	}
+	if (in_set0 <= TC_AES_CACHE_WAYS || other == (TCAesKeySched_t) 0) {
+		TC_ERROR("AES cache keys were not spread over the sets in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+
+	(void)tc_aes128_set_encrypt_key(&expected, key);
+	result = check_result(4, expected.words, sizeof(expected.words),
+			      first->words, sizeof(first->words));
+
+ exitTest4:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * A cache larger than a set must be made of whole sets.
+ */
+unsigned int test_5(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_aes_cache_entry_struct entries[TC_AES_CACHE_WAYS + 2];
+	struct tc_aes_cache_struct cache;
+
+	TC_PRINT("AES cache test #5 (geometry checks):\n");
+
+	if (tc_aes_cache_init(&cache, entries, TC_AES_CACHE_WAYS + 2,
+			      hash_key) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_init(&cache, entries, TC_AES_CACHE_WAYS,
+			      (const uint8_t *) 0) != TC_CRYPTO_FAIL ||
+	    tc_aes_cache_init(&cache, entries, TC_AES_CACHE_WAYS - 1,
+			      hash_key) != TC_CRYPTO_SUCCESS ||
+	    cache.num_sets != 1) {
+		TC_ERROR("AES cache accepted a bad geometry in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test AES key schedule cache
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_aes_cache_entry_struct entries[NUM_OF_ENTRIES];
+	struct tc_aes_cache_entry_struct
+		set_entries[NUM_OF_SETS * TC_AES_CACHE_WAYS];
+	struct tc_aes_cache_struct cache;
+	struct tc_aes_cache_struct set_cache;
+
+	TC_START("Performing AES128 key schedule cache tests:");
+
+	(void)tc_aes_cache_init(&cache, entries, NUM_OF_ENTRIES, hash_key);
+	result = test_1(&cache);
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES cache test #1 (miss and hit) failed.\n");
+		goto exitTest;
+	}
+
+	(void)tc_aes_cache_init(&cache, entries, NUM_OF_ENTRIES, hash_key);
+	result = test_2(&cache);
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES cache test #2 (CLOCK replacement) failed.\n");
+		goto exitTest;
+	}
+
+	result = test_3(&cache);
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES cache test #3 (eviction) failed.\n");
+		goto exitTest;
+	}
+
+	(void)tc_aes_cache_init(&set_cache, set_entries,
+				NUM_OF_SETS * TC_AES_CACHE_WAYS, hash_key);
+	result = test_4(&set_cache);
+	(void)tc_aes_cache_erase(&set_cache);
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES cache test #4 (CLOCK replacement within a set) "
+			 "failed.\n");
+		goto exitTest;
+	}
+
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES cache test #5 (geometry checks) failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All AES128 key schedule cache tests succeeded!\n");
+
+ exitTest:
+	(void)tc_aes_cache_erase(&cache);
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
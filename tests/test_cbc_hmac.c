@@ -0,0 +1,245 @@
+/* test_cbc_hmac.c - TinyCrypt implementation of some AES-CBC + HMAC-SHA256 tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following stitched AES-CBC + HMAC-SHA256 routines:
+ *
+ * Scenarios tested include:
+ * - CBC-HMAC seal of the SP 800-38a CBC vector (whole SHA-256 groups)
+ * - CBC-HMAC seal of a partial SHA-256 group
+ * - CBC-HMAC open of sealed messages
+ * - CBC-HMAC rejection of modified messages
+ */
+
+#include <tinycrypt/cbc_hmac.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/* SP 800-38a F.2.1 CBC-AES128.Encrypt */
+static const uint8_t key[16] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+	0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t iv[16] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+	0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static const uint8_t plaintext[64] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+	0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+	0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+	0xe6, 0x6c, 0x37, 0x10
+};
+
+/* iv || ciphertext */
+static const uint8_t ciphertext[80] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+	0x0c, 0x0d, 0x0e, 0x0f, 0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46,
+	0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d, 0x50, 0x86, 0xcb, 0x9b,
+	0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+	0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e,
+	0x22, 0x22, 0x95, 0x16, 0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09,
+	0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7
+};
+
+static const uint8_t mac_key[32] = {
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b,
+	0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+	0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f
+};
+
+/* HMAC-SHA256(mac_key, iv || ciphertext) */
+static const uint8_t tag_64[32] = {
+	0x01, 0xe1, 0x81, 0x13, 0xf9, 0xbd, 0x5a, 0xec, 0x12, 0x56, 0x57, 0xb2,
+	0xb4, 0x65, 0xda, 0xd8, 0x85, 0xf2, 0x03, 0xa4, 0x02, 0xd2, 0x72, 0x4e,
+	0xb8, 0x83, 0x70, 0x46, 0x59, 0x06, 0xc8, 0xc5
+};
+
+/* HMAC-SHA256(mac_key, iv || first three blocks of ciphertext) */
+static const uint8_t tag_48[32] = {
+	0x4a, 0x40, 0x65, 0x8a, 0x27, 0xaf, 0xe6, 0x3a, 0xd0, 0xf7, 0x51, 0x34,
+	0x70, 0x67, 0x06, 0x42, 0x2e, 0xc0, 0xb2, 0x44, 0x81, 0xe8, 0x24, 0xa3,
+	0x3f, 0x0e, 0xe8, 0x8f, 0x89, 0x8a, 0x25, 0x59
+};
+
+/*
+ * Seals the first len bytes of plaintext, checks the result against the
+ * reference ciphertext and tag, then opens it.
+ */
+static unsigned int do_test(unsigned int testnum, unsigned int len,
+			    const uint8_t *tag)
+{
+	struct tc_aes_key_sched_struct sched;
+	struct tc_hmac_state_struct mac;
+	uint8_t sealed[sizeof(plaintext) + TC_CBC_HMAC_OVERHEAD];
+	uint8_t opened[sizeof(plaintext)];
+	unsigned int slen = len + TC_CBC_HMAC_OVERHEAD;
+	unsigned int result = TC_PASS;
+
+	(void)tc_hmac_set_key(&mac, mac_key, sizeof(mac_key));
+	(void)tc_aes128_set_encrypt_key(&sched, key);
+	if (tc_cbc_hmac_seal(sealed, slen, plaintext, len, iv, &sched,
+			     &mac) == 0) {
+		TC_ERROR("CBC-HMAC seal failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	result = check_result(testnum, ciphertext, TC_AES_BLOCK_SIZE + len,
+			      sealed, TC_AES_BLOCK_SIZE + len);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+	result = check_result(testnum, tag, TC_CBC_HMAC_TAG_SIZE,
+			      &sealed[TC_AES_BLOCK_SIZE + len],
+			      TC_CBC_HMAC_TAG_SIZE);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	/* the keyed HMAC state is reused as is */
+	(void)tc_aes128_set_decrypt_key(&sched, key);
+	if (tc_cbc_hmac_open(opened, len, sealed, slen, &sched, &mac) == 0) {
+		TC_ERROR("CBC-HMAC open failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	result = check_result(testnum, plaintext, len, opened, len);
+
+ exitTest:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * CBC-HMAC test #1 (64 byte plaintext).
+ */
+unsigned int test_1(void)
+{
+	TC_PRINT("CBC-HMAC test #1 (64 byte plaintext):\n");
+	return do_test(1, sizeof(plaintext), tag_64);
+}
+
+/*
+ * CBC-HMAC test #2 (48 byte plaintext).
+ */
+unsigned int test_2(void)
+{
+	TC_PRINT("CBC-HMAC test #2 (48 byte plaintext):\n");
+	return do_test(2, 48, tag_48);
+}
+
+/*
+ * CBC-HMAC test #3 (forgery): flipping a bit of the IV, the ciphertext or the
+ * tag makes open fail without writing any plaintext.
+ */
+unsigned int test_3(void)
+{
+	const unsigned int flip[] = {0, TC_AES_BLOCK_SIZE, sizeof(ciphertext) - 1,
+				     sizeof(ciphertext) + TC_CBC_HMAC_TAG_SIZE - 1};
+	struct tc_aes_key_sched_struct sched;
+	struct tc_hmac_state_struct mac;
+	uint8_t sealed[sizeof(plaintext) + TC_CBC_HMAC_OVERHEAD];
+	uint8_t opened[sizeof(plaintext)];
+	uint8_t untouched[sizeof(plaintext)];
+	unsigned int result = TC_PASS;
+	unsigned int i;
+
+	TC_PRINT("CBC-HMAC test #3 (forgery):\n");
+
+	(void)tc_hmac_set_key(&mac, mac_key, sizeof(mac_key));
+	(void)tc_aes128_set_decrypt_key(&sched, key);
+	(void)memset(untouched, 0x5a, sizeof(untouched));
+
+	for (i = 0; i < sizeof(flip) / sizeof(flip[0]); ++i) {
+		(void)memcpy(sealed, ciphertext, sizeof(ciphertext));
+		(void)memcpy(&sealed[sizeof(ciphertext)], tag_64, sizeof(tag_64));
+		sealed[flip[i]] ^= 0x01;
+		(void)memset(opened, 0x5a, sizeof(opened));
+		if (tc_cbc_hmac_open(opened, sizeof(opened), sealed,
+				     sizeof(sealed), &sched, &mac) != 0) {
+			TC_ERROR("CBC-HMAC forgery accepted in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest3;
+		}
+		result = check_result(3, untouched, sizeof(untouched),
+				      opened, sizeof(opened));
+		if (result == TC_FAIL) {
+			goto exitTest3;
+		}
+	}
+
+ exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test CBC-HMAC
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing CBC-HMAC tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CBC-HMAC test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CBC-HMAC test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CBC-HMAC test #3 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All CBC-HMAC tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
@@ -149,6 +149,115 @@ exitTest1:
 	return result;
 }
 
+/*
+ * NIST SP 800-38a CBC Test with the plaintext and the ciphertext scattered in
+ * segments that straddle block boundaries.
+ */
+int test_3(void)
+{
+	struct tc_aes_key_sched_struct a;
+	const struct tc_iovec pt_iov[] = {
+		{&plaintext[0], 7}, {&plaintext[7], 0}, {&plaintext[7], 30},
+		{&plaintext[37], 27}
+	};
+	const struct tc_iovec ct_iov[] = {
+		{&ciphertext[16], 16}, {&ciphertext[32], 5}, {&ciphertext[37], 2},
+		{&ciphertext[39], 41}
+	};
+	uint8_t encrypted[80];
+	uint8_t decrypted[64];
+	int result = TC_PASS;
+
+	TC_PRINT("CBC test #3 (scatter-gather encryption and decryption):\n");
+
+	(void)tc_aes128_set_encrypt_key(&a, key);
+	if (tc_cbc_mode_encrypt_v(encrypted, sizeof(encrypted), pt_iov,
+				  sizeof(pt_iov) / sizeof(pt_iov[0]), iv,
+				  &a) == 0) {
+		TC_ERROR("CBC test #3 (scatter-gather encryption) failed in "
+			 "%s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+	result = check_result(3, ciphertext, sizeof(ciphertext), encrypted,
+			      sizeof(encrypted));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+
+	(void)tc_aes128_set_decrypt_key(&a, key);
+	if (tc_cbc_mode_decrypt_v(decrypted, sizeof(decrypted), ct_iov,
+				  sizeof(ct_iov) / sizeof(ct_iov[0]), iv,
+				  &a) == 0) {
+		TC_ERROR("CBC test #3 (scatter-gather decryption) failed in "
+			 "%s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+	result = check_result(3, plaintext, sizeof(plaintext), decrypted,
+			      sizeof(decrypted));
+
+exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * NIST SP 800-38a CBC Test with the stateful interface, in place and in
+ * chunks of different sizes.
+ */
+int test_4(void)
+{
+	struct tc_aes_key_sched_struct a;
+	struct tc_cbc_mode_struct c;
+	uint8_t buf[64];
+	int result = TC_PASS;
+
+	TC_PRINT("CBC test #4 (in-place chunked encryption and decryption):\n");
+
+	(void)memcpy(buf, plaintext, sizeof(buf));
+	(void)tc_aes128_set_encrypt_key(&a, key);
+	(void)tc_cbc_mode_init(&c, iv, &a);
+	if (tc_cbc_mode_encrypt_update(&c, buf, buf, 16) == 0 ||
+	    tc_cbc_mode_encrypt_update(&c, &buf[16], &buf[16], 0) == 0 ||
+	    tc_cbc_mode_encrypt_update(&c, &buf[16], &buf[16], 48) == 0) {
+		TC_ERROR("CBC test #4 (in-place encryption) failed in "
+			 "%s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	result = check_result(4, &ciphertext[TC_AES_BLOCK_SIZE], sizeof(buf),
+			      buf, sizeof(buf));
+	if (result == TC_FAIL) {
+		goto exitTest4;
+	}
+
+	/* a partial block is rejected */
+	if (tc_cbc_mode_encrypt_update(&c, buf, buf, 15) != 0) {
+		TC_ERROR("CBC test #4 accepted a partial block in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+
+	(void)tc_aes128_set_decrypt_key(&a, key);
+	(void)tc_cbc_mode_init(&c, iv, &a);
+	if (tc_cbc_mode_decrypt_update(&c, buf, buf, 32) == 0 ||
+	    tc_cbc_mode_decrypt_update(&c, &buf[32], &buf[32], 32) == 0) {
+		TC_ERROR("CBC test #4 (in-place decryption) failed in "
+			 "%s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	result = check_result(4, plaintext, sizeof(plaintext), buf,
+			      sizeof(buf));
+
+exitTest4:
+	(void)tc_cbc_mode_erase(&c);
+	TC_END_RESULT(result);
+	return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -165,6 +274,18 @@ int main(void)
 		TC_ERROR("CBC test #1 failed.\n");
 		goto exitTest;
 	}
+	result = test_3();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CBC test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CBC test #4 failed.\n");
+		goto exitTest;
+	}
 
 	TC_PRINT("All CBC tests succeeded!\n");
 
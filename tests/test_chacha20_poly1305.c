@@ -0,0 +1,393 @@
+/* test_chacha20_poly1305.c - TinyCrypt implementation of some ChaCha20-Poly1305 tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following ChaCha20-Poly1305 routines:
+ *
+ * Scenarios tested include:
+ * - ChaCha20-Poly1305 RFC 8439 AEAD test vector
+ * - ChaCha20-Poly1305 multi-block payload without associated data
+ * - ChaCha20-Poly1305 associated data without payload
+ * - ChaCha20-Poly1305 streaming interface over odd-sized segments
+ * - ChaCha20-Poly1305 rejection of modified messages
+ */
+
+#include <tinycrypt/chacha20_poly1305.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TAG_SIZE TC_CHACHA20_POLY1305_TAG_SIZE
+
+/* RFC 8439 section 2.8.2 */
+static const uint8_t rfc_key[32] = {
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b,
+	0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+	0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+static const uint8_t rfc_nonce[12] = {
+	0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+};
+static const uint8_t rfc_aad[12] = {
+	0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7
+};
+static const uint8_t rfc_plaintext[114] = {
+	0x4c, 0x61, 0x64, 0x69, 0x65, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x47,
+	0x65, 0x6e, 0x74, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x20, 0x6f, 0x66, 0x20,
+	0x74, 0x68, 0x65, 0x20, 0x63, 0x6c, 0x61, 0x73, 0x73, 0x20, 0x6f, 0x66,
+	0x20, 0x27, 0x39, 0x39, 0x3a, 0x20, 0x49, 0x66, 0x20, 0x49, 0x20, 0x63,
+	0x6f, 0x75, 0x6c, 0x64, 0x20, 0x6f, 0x66, 0x66, 0x65, 0x72, 0x20, 0x79,
+	0x6f, 0x75, 0x20, 0x6f, 0x6e, 0x6c, 0x79, 0x20, 0x6f, 0x6e, 0x65, 0x20,
+	0x74, 0x69, 0x70, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20,
+	0x66, 0x75, 0x74, 0x75, 0x72, 0x65, 0x2c, 0x20, 0x73, 0x75, 0x6e, 0x73,
+	0x63, 0x72, 0x65, 0x65, 0x6e, 0x20, 0x77, 0x6f, 0x75, 0x6c, 0x64, 0x20,
+	0x62, 0x65, 0x20, 0x69, 0x74, 0x2e
+};
+static const uint8_t rfc_sealed[114 + TAG_SIZE] = {
+	0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc,
+	0x53, 0xef, 0x7e, 0xc2, 0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+	0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6, 0x3d, 0xbe, 0xa4, 0x5e,
+	0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+	0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6,
+	0x7e, 0xcd, 0x3b, 0x36, 0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+	0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58, 0xfa, 0xb3, 0x24, 0xe4,
+	0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+	0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65,
+	0x86, 0xce, 0xc6, 0x4b, 0x61, 0x16, 0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09,
+	0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+};
+
+/*
+ * Seals plaintext and checks it against the expected ciphertext and tag, then
+ * opens the result.
+ */
+static unsigned int do_test(unsigned int testnum, const uint8_t *key,
+			    const uint8_t *nonce, const uint8_t *aad,
+			    unsigned int alen, const uint8_t *plaintext,
+			    unsigned int plen, const uint8_t *expected)
+{
+	struct tc_chacha20_poly1305_struct c;
+	uint8_t sealed[256];
+	uint8_t opened[256];
+	unsigned int result = TC_PASS;
+
+	(void)tc_chacha20_poly1305_config(&c, key, nonce,
+					  TC_CHACHA20_POLY1305_NONCE_SIZE);
+	if (tc_chacha20_poly1305_seal(sealed, plen + TAG_SIZE, aad, alen,
+				      plaintext, plen, &c) == 0) {
+		TC_ERROR("ChaCha20-Poly1305 seal failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	result = check_result(testnum, expected, plen + TAG_SIZE,
+			      sealed, plen + TAG_SIZE);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	if (tc_chacha20_poly1305_open(opened, plen, aad, alen, sealed,
+				      plen + TAG_SIZE, &c) == 0) {
+		TC_ERROR("ChaCha20-Poly1305 open failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	result = check_result(testnum, plaintext, plen, opened, plen);
+
+ exitTest:
+	(void)tc_chacha20_poly1305_erase(&c);
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * ChaCha20-Poly1305 test #1 (RFC 8439 section 2.8.2).
+ */
+unsigned int test_1(void)
+{
+	TC_PRINT("ChaCha20-Poly1305 test #1 (RFC 8439 section 2.8.2):\n");
+	return do_test(1, rfc_key, rfc_nonce, rfc_aad, sizeof(rfc_aad),
+		       rfc_plaintext, sizeof(rfc_plaintext), rfc_sealed);
+}
+
+/*
+ * ChaCha20-Poly1305 test #2 (130 byte payload, no associated data).
+ */
+unsigned int test_2(void)
+{
+	const uint8_t nonce[12] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t expected[130 + TAG_SIZE] = {
+		0x21, 0x45, 0x40, 0xeb, 0x5f, 0x3d, 0xf4, 0xd5, 0x14, 0x9c, 0x6e, 0x3f,
+		0xef, 0x3d, 0x78, 0x81, 0xff, 0x69, 0x9e, 0x0a, 0xb2, 0xba, 0x9b, 0x46,
+		0xd5, 0xfd, 0x73, 0x2c, 0x59, 0x3d, 0x1a, 0xa4, 0x69, 0xd1, 0xfb, 0x5b,
+		0x8d, 0x66, 0x07, 0x86, 0xae, 0x5b, 0x5d, 0xfd, 0xda, 0x15, 0xd6, 0x78,
+		0x2a, 0x16, 0xdb, 0x28, 0xa9, 0x48, 0x49, 0x49, 0x61, 0xb3, 0xb5, 0xec,
+		0x57, 0xd3, 0xf4, 0x0b, 0xaa, 0x6c, 0xa5, 0x47, 0xe0, 0x85, 0xe2, 0xb5,
+		0xd9, 0xc8, 0xf7, 0x38, 0xfb, 0x53, 0xe1, 0x52, 0x15, 0xee, 0x75, 0x25,
+		0x3f, 0xef, 0xd1, 0x17, 0x98, 0x9b, 0xbc, 0xba, 0x43, 0x82, 0xcc, 0xd9,
+		0x9a, 0x21, 0xdf, 0x62, 0xa5, 0x45, 0xe1, 0x5d, 0x1a, 0x85, 0x03, 0x3d,
+		0x67, 0xe3, 0x7b, 0x27, 0xe0, 0x79, 0x55, 0x2b, 0x5c, 0x16, 0x27, 0xe5,
+		0xc3, 0xa9, 0xe5, 0x88, 0x5e, 0xff, 0xb1, 0x91, 0x4b, 0x67, 0x74, 0xd0,
+		0x55, 0xe8, 0xc0, 0x33, 0xa9, 0xc7, 0x8a, 0xd9, 0x34, 0xb0, 0x97, 0xe7,
+		0xda, 0x3a
+	};
+	uint8_t key[32];
+	uint8_t plaintext[130];
+	unsigned int i;
+
+	TC_PRINT("ChaCha20-Poly1305 test #2 (130 byte payload, no associated data):\n");
+
+	for (i = 0; i < sizeof(key); ++i) {
+		key[i] = (uint8_t) i;
+	}
+	for (i = 0; i < sizeof(plaintext); ++i) {
+		plaintext[i] = (uint8_t)(7 * i + 3);
+	}
+	return do_test(2, key, nonce, (const uint8_t *) 0, 0,
+		       plaintext, sizeof(plaintext), expected);
+}
+
+/*
+ * ChaCha20-Poly1305 test #3 (associated data only).
+ */
+unsigned int test_3(void)
+{
+	const uint8_t nonce[12] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t expected[TAG_SIZE] = {
+		0xac, 0x30, 0xfb, 0xa7, 0x76, 0x3f, 0xcc, 0x2e, 0xbb, 0xf7, 0xd4, 0xed,
+		0x5f, 0x04, 0xf7, 0x29
+	};
+	uint8_t key[32];
+	uint8_t aad[20];
+	unsigned int i;
+
+	TC_PRINT("ChaCha20-Poly1305 test #3 (associated data only):\n");
+
+	for (i = 0; i < sizeof(key); ++i) {
+		key[i] = (uint8_t) i;
+	}
+	for (i = 0; i < sizeof(aad); ++i) {
+		aad[i] = (uint8_t)(0xa0 + i);
+	}
+	return do_test(3, key, nonce, aad, sizeof(aad),
+		       (const uint8_t *) 0, 0, expected);
+}
+
+/*
+ * ChaCha20-Poly1305 test #4 (streaming): feeding the RFC 8439 message in
+ * segments that straddle both Poly1305 and ChaCha20 block boundaries gives
+ * the one-shot result, and decrypts back in place.
+ */
+unsigned int test_4(void)
+{
+	const size_t aad_segments[] = {1, 11};
+	const size_t segments[] = {1, 63, 17, 0, 33};
+	struct tc_chacha20_poly1305_struct c;
+	struct tc_chacha20_poly1305_stream_struct s;
+	uint8_t buf[sizeof(rfc_sealed)];
+	unsigned int result = TC_PASS;
+	size_t offset;
+	unsigned int i;
+
+	TC_PRINT("ChaCha20-Poly1305 test #4 (streaming):\n");
+
+	(void)tc_chacha20_poly1305_config(&c, rfc_key, rfc_nonce,
+					  sizeof(rfc_nonce));
+	(void)tc_chacha20_poly1305_stream_init(&s, &c);
+	for (i = 0, offset = 0; i < sizeof(aad_segments) / sizeof(size_t); ++i) {
+		(void)tc_chacha20_poly1305_stream_aad(&s, &rfc_aad[offset],
+						      aad_segments[i]);
+		offset += aad_segments[i];
+	}
+	for (i = 0, offset = 0; i < sizeof(segments) / sizeof(size_t); ++i) {
+		if (tc_chacha20_poly1305_stream_encrypt(&s, &buf[offset],
+							&rfc_plaintext[offset],
+							segments[i]) == 0) {
+			TC_ERROR("ChaCha20-Poly1305 stream encryption failed "
+				 "in %s.\n", __func__);
+			result = TC_FAIL;
+			goto exitTest4;
+		}
+		offset += segments[i];
+	}
+	/* associated data must come before the payload: */
+	if (tc_chacha20_poly1305_stream_aad(&s, rfc_aad, 1) != 0) {
+		TC_ERROR("ChaCha20-Poly1305 late associated data accepted "
+			 "in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	(void)tc_chacha20_poly1305_stream_final(&buf[offset], &s);
+	result = check_result(4, rfc_sealed, sizeof(rfc_sealed),
+			      buf, sizeof(buf));
+	if (result == TC_FAIL) {
+		goto exitTest4;
+	}
+
+	(void)tc_chacha20_poly1305_stream_init(&s, &c);
+	(void)tc_chacha20_poly1305_stream_aad(&s, rfc_aad, sizeof(rfc_aad));
+	for (i = 0, offset = 0; i < sizeof(segments) / sizeof(size_t); ++i) {
+		(void)tc_chacha20_poly1305_stream_decrypt(&s, &buf[offset],
+							  &buf[offset],
+							  segments[i]);
+		offset += segments[i];
+	}
+	if (tc_chacha20_poly1305_stream_verify(&buf[offset], &s) == 0) {
+		TC_ERROR("ChaCha20-Poly1305 stream verification failed "
+			 "in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	result = check_result(4, rfc_plaintext, sizeof(rfc_plaintext),
+			      buf, offset);
+
+ exitTest4:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * ChaCha20-Poly1305 test #5 (forgery): a modified ciphertext, tag or
+ * associated data is rejected and no plaintext is released.
+ */
+unsigned int test_5(void)
+{
+	const uint8_t zeros[sizeof(rfc_plaintext)] = {0};
+	struct tc_chacha20_poly1305_struct c;
+	struct tc_chacha20_poly1305_stream_struct s;
+	uint8_t sealed[sizeof(rfc_sealed)];
+	uint8_t aad[sizeof(rfc_aad)];
+	uint8_t out[sizeof(rfc_plaintext)];
+	unsigned int result = TC_PASS;
+	const unsigned int flip[] = {0, sizeof(rfc_plaintext) - 1,
+				     sizeof(rfc_sealed) - 1};
+	unsigned int i;
+
+	TC_PRINT("ChaCha20-Poly1305 test #5 (forgery):\n");
+
+	(void)tc_chacha20_poly1305_config(&c, rfc_key, rfc_nonce,
+					  sizeof(rfc_nonce));
+	for (i = 0; i < sizeof(flip) / sizeof(flip[0]); ++i) {
+		memcpy(sealed, rfc_sealed, sizeof(sealed));
+		sealed[flip[i]] ^= 0x01;
+		memset(out, 0xaa, sizeof(out));
+		if (tc_chacha20_poly1305_open(out, sizeof(out), rfc_aad,
+					      sizeof(rfc_aad), sealed,
+					      sizeof(sealed), &c) != 0) {
+			TC_ERROR("ChaCha20-Poly1305 forgery accepted in %s.\n",
+				 __func__);
+			result = TC_FAIL;
+			goto exitTest5;
+		}
+		result = check_result(5, zeros, sizeof(zeros), out, sizeof(out));
+		if (result == TC_FAIL) {
+			goto exitTest5;
+		}
+	}
+
+	memcpy(aad, rfc_aad, sizeof(aad));
+	aad[sizeof(aad) - 1] ^= 0x80;
+	if (tc_chacha20_poly1305_open(out, sizeof(out), aad, sizeof(aad),
+				      rfc_sealed, sizeof(rfc_sealed), &c) != 0) {
+		TC_ERROR("ChaCha20-Poly1305 modified associated data accepted "
+			 "in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+
+	(void)tc_chacha20_poly1305_stream_init(&s, &c);
+	(void)tc_chacha20_poly1305_stream_aad(&s, rfc_aad, sizeof(rfc_aad));
+	(void)tc_chacha20_poly1305_stream_decrypt(&s, out, rfc_sealed,
+						  sizeof(rfc_plaintext));
+	memcpy(sealed, rfc_sealed, sizeof(sealed));
+	sealed[sizeof(rfc_plaintext)] ^= 0x01;
+	if (tc_chacha20_poly1305_stream_verify(&sealed[sizeof(rfc_plaintext)],
+					       &s) != 0) {
+		TC_ERROR("ChaCha20-Poly1305 stream forgery accepted in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+	}
+
+ exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test ChaCha20-Poly1305
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing ChaCha20-Poly1305 tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("ChaCha20-Poly1305 test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("ChaCha20-Poly1305 test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("ChaCha20-Poly1305 test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("ChaCha20-Poly1305 test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("ChaCha20-Poly1305 test #5 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All ChaCha20-Poly1305 tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
@@ -39,6 +39,8 @@
  *  - CMAC test #3 1 block msg (SP 800-38B test vector #2)
  *  - CMAC test #4 320 bit msg (SP 800-38B test vector #3)
  *  - CMAC test #5 512 bit msg (SP 800-38B test vector #4)
+ *  - CMAC test #6 several msgs under a single setup (SP 800-38B vectors)
+ *  - CMAC test #7 512 bit msg split in unaligned segments (SP 800-38B #4)
  */
 
 #include <tinycrypt/cmac_mode.h>
@@ -247,6 +249,207 @@ static int verify_cmac_512_bit_msg(TCCmacState_t s)
 	return result;
 }
 
+static int verify_cmac_reinit(TCCmacState_t s)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #6 (several msgs under a single setup)\n");
+
+	const uint8_t msg[40] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11
+	};
+	const size_t msglen[3] = { 0, 16, 40 };
+	const uint8_t tag[3][BUF_LEN] = {
+		{
+		0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28,
+		0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46
+		}, {
+		0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+		0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c
+		}, {
+		0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
+		0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27
+		}
+	};
+	uint8_t Tag[BUF_LEN];
+	unsigned int i, j;
+
+	/* run the messages twice, so every message follows another one: */
+	for (j = 0; j < 6; ++j) {
+		i = j % 3;
+		(void)tc_cmac_update(s, msg, msglen[i]);
+		(void)tc_cmac_final_reinit(Tag, s);
+
+		if (memcmp(Tag, tag[i], BUF_LEN) != 0) {
+			TC_ERROR("%s: aes_cmac failed with msg #%u\n", __func__, j);
+			show("expected Tag =", tag[i], sizeof(tag[i]));
+			show("computed Tag =", Tag, sizeof(Tag));
+			return TC_FAIL;
+		}
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+static int verify_cmac_segmented_msg(TCCmacState_t s)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #7 (512 bit msg in unaligned segments)\n");
+
+	const uint8_t msg[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+		0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+		0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+	};
+	const uint8_t tag[BUF_LEN] = {
+		0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+		0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+	};
+	const size_t segments[] = { 3, 13, 16, 1, 31 };
+	uint8_t Tag[BUF_LEN];
+	unsigned int i, offset;
+
+	(void)tc_cmac_init(s);
+	for (i = offset = 0; i < sizeof(segments) / sizeof(segments[0]); ++i) {
+		(void)tc_cmac_update(s, &msg[offset], segments[i]);
+		offset += segments[i];
+	}
+	(void)tc_cmac_final(Tag, s);
+
+	if (memcmp(Tag, tag, BUF_LEN) != 0) {
+		TC_ERROR("%s: aes_cmac failed with segmented 512 bit msg\n", __func__);
+		show("expected Tag =", tag, sizeof(tag));
+		show("computed Tag =", Tag, sizeof(Tag));
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Same as test #7, with the segments passed to a single tc_cmac_update_v,
+ * which counts as a single call to tc_cmac_update.
+ */
+static int verify_cmac_iovec_msg(TCCmacState_t s)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #8 (512 bit msg in scatter-gather segments)\n");
+
+	const uint8_t msg[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+		0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+		0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+	};
+	const uint8_t tag[BUF_LEN] = {
+		0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+		0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+	};
+	const struct tc_iovec iov[] = {
+		{&msg[0], 3}, {&msg[3], 13}, {&msg[16], 0}, {&msg[16], 16},
+		{&msg[32], 1}, {&msg[33], 31}
+	};
+	uint8_t Tag[BUF_LEN];
+	uint64_t countdown;
+
+	(void)tc_cmac_init(s);
+	countdown = s->countdown;
+	if (tc_cmac_update_v(s, iov, sizeof(iov) / sizeof(iov[0])) == 0) {
+		TC_ERROR("%s: tc_cmac_update_v failed\n", __func__);
+		return TC_FAIL;
+	}
+	if (s->countdown != countdown - 1) {
+		TC_ERROR("%s: tc_cmac_update_v must count as one call\n",
+			 __func__);
+		return TC_FAIL;
+	}
+	(void)tc_cmac_final(Tag, s);
+
+	if (memcmp(Tag, tag, BUF_LEN) != 0) {
+		TC_ERROR("%s: aes_cmac failed with scatter-gather 512 bit msg\n", __func__);
+		show("expected Tag =", tag, sizeof(tag));
+		show("computed Tag =", Tag, sizeof(Tag));
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Block-aligned messages split into a header and a payload whose last
+ * segment completes the final block: the tag must be the one of the
+ * contiguous message (the final block is mixed with K1, not K2).
+ */
+static int verify_cmac_header_payload_msg(TCCmacState_t s)
+{
+	int result = TC_PASS;
+
+	TC_PRINT("Performing CMAC test #9 (block-aligned msgs as header and payload)\n");
+
+	const uint8_t msg[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+		0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+		0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+	};
+	/* SP 800-38B tags of the first 16 and of all 64 bytes of msg */
+	const uint8_t tag_16[BUF_LEN] = {
+		0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+		0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c
+	};
+	const uint8_t tag_64[BUF_LEN] = {
+		0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+		0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+	};
+	const struct tc_iovec iov_16[] = { {&msg[0], 8}, {&msg[8], 8} };
+	const struct tc_iovec iov_64[] = { {&msg[0], 56}, {&msg[56], 8} };
+	uint8_t Tag[BUF_LEN];
+
+	(void)tc_cmac_init(s);
+	(void)tc_cmac_update_v(s, iov_16, 2);
+	(void)tc_cmac_final_reinit(Tag, s);
+	if (memcmp(Tag, tag_16, BUF_LEN) != 0) {
+		TC_ERROR("%s: aes_cmac failed with an 8 + 8 byte msg\n", __func__);
+		show("expected Tag =", tag_16, sizeof(tag_16));
+		show("computed Tag =", Tag, sizeof(Tag));
+		return TC_FAIL;
+	}
+
+	(void)tc_cmac_update_v(s, iov_64, 2);
+	(void)tc_cmac_final(Tag, s);
+	if (memcmp(Tag, tag_64, BUF_LEN) != 0) {
+		TC_ERROR("%s: aes_cmac failed with a 56 + 8 byte msg\n", __func__);
+		show("expected Tag =", tag_64, sizeof(tag_64));
+		show("computed Tag =", Tag, sizeof(Tag));
+		return TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
 /*
  * Main task to test CMAC
  * effects:    returns 1 if all tests pass
@@ -303,6 +506,35 @@ int main(void)
 		TC_ERROR("CMAC test #5  (512 bit msg)failed.\n");
 		goto exitTest;
 	}
+	(void) tc_cmac_setup(&state, key, &sched);
+	result = verify_cmac_reinit(&state);
+	(void) tc_cmac_erase(&state);
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #6 (several msgs) failed.\n");
+		goto exitTest;
+	}
+	(void) tc_cmac_setup(&state, key, &sched);
+	result = verify_cmac_segmented_msg(&state);
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #7 (segmented msg) failed.\n");
+		goto exitTest;
+	}
+	(void) tc_cmac_setup(&state, key, &sched);
+	result = verify_cmac_iovec_msg(&state);
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #8 (scatter-gather msg) failed.\n");
+		goto exitTest;
+	}
+	(void) tc_cmac_setup(&state, key, &sched);
+	result = verify_cmac_header_payload_msg(&state);
+	if (result == TC_FAIL) {
+		/* terminate test */
+		TC_ERROR("CMAC test #9 (header and payload msg) failed.\n");
+		goto exitTest;
+	}
 
 	TC_PRINT("All CMAC tests succeeded!\n");
 
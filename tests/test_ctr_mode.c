@@ -36,6 +36,10 @@
 
   Scenarios tested include:
   - AES128 CTR mode encryption SP 800-38a tests
+  - AES128 CTR stream encryption over odd-sized chunks
+  - AES128 CTR encryption split into independently processed chunks
+  - AES128 CTR scatter-gather encryption
+  - AES128 CTR stream refusing to exceed TC_CTR_MAX_BYTES
 */
 
 #include <tinycrypt/ctr_mode.h>
@@ -113,6 +117,256 @@ unsigned int test_1_and_2(void)
         return result;
 }
 
+/*
+ * NIST SP 800-38a CTR Test, with the plaintext split into odd-sized chunks.
+ */
+unsigned int test_3(void)
+{
+        const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+        };
+        const uint8_t ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xfe, 0xff
+        };
+        const uint8_t next_ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xff, 0x03
+        };
+        const uint8_t plaintext[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+		0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+		0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+		0xe6, 0x6c, 0x37, 0x10
+        };
+        const uint8_t ciphertext[64] = {
+		0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64,
+		0x99, 0x0d, 0xb6, 0xce, 0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+		0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff, 0x5a, 0xe4, 0xdf, 0x3e,
+		0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+		0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0,
+		0xf3, 0x00, 0x9c, 0xee
+        };
+        const unsigned int chunks[] = { 1, 7, 16, 5, 0, 35 };
+        struct tc_aes_key_sched_struct sched;
+        struct tc_ctr_stream_struct s;
+        uint8_t out[64];
+        unsigned int i, offset;
+        unsigned int result = TC_PASS;
+
+        TC_PRINT("CTR test #3 (stream encryption over odd-sized chunks):\n");
+        (void)tc_aes128_set_encrypt_key(&sched, key);
+        (void)tc_ctr_stream_init(&s, ctr, &sched);
+
+        for (i = offset = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+                if (tc_ctr_stream_xor(&s, &out[offset], &plaintext[offset],
+                                      chunks[i]) == 0) {
+                        TC_ERROR("CTR test #3 (stream encryption) failed in %s.\n", __func__);
+                        result = TC_FAIL;
+                        goto exitTest3;
+                }
+                offset += chunks[i];
+        }
+
+        result = check_result(3, ciphertext, sizeof(ciphertext),
+			      out, sizeof(out));
+        if (result == TC_PASS) {
+                result = check_result(3, next_ctr, sizeof(next_ctr),
+				      s.ctr, sizeof(s.ctr));
+        }
+
+ exitTest3:
+        (void)tc_ctr_stream_erase(&s);
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * NIST SP 800-38a CTR Test, with the plaintext split into two block-aligned
+ * chunks processed independently, as a parallel caller would do.
+ */
+unsigned int test_4(void)
+{
+        const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+        };
+        const uint8_t ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xfe, 0xff
+        };
+        const uint8_t wrap_ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0x00, 0x00, 0x00, 0x01
+        };
+        const uint8_t plaintext[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+		0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+		0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+		0xe6, 0x6c, 0x37, 0x10
+        };
+        const uint8_t ciphertext[64] = {
+		0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64,
+		0x99, 0x0d, 0xb6, 0xce, 0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+		0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff, 0x5a, 0xe4, 0xdf, 0x3e,
+		0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+		0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0,
+		0xf3, 0x00, 0x9c, 0xee
+        };
+        struct tc_aes_key_sched_struct sched;
+        uint8_t ctr0[16];
+        uint8_t ctr1[16];
+        uint8_t out[64];
+        unsigned int result = TC_PASS;
+
+        TC_PRINT("CTR test #4 (encryption split into independent chunks):\n");
+        (void)tc_aes128_set_encrypt_key(&sched, key);
+
+        /* the second chunk starts 2 blocks after the first one: */
+        (void)memcpy(ctr0, ctr, sizeof(ctr0));
+        (void)memcpy(ctr1, ctr, sizeof(ctr1));
+        (void)tc_ctr_advance(ctr1, 2);
+
+        /* tc_ctr_mode_large is tc_ctr_mode with size_t lengths: */
+        if (tc_ctr_mode_large(&out[32], 32, &plaintext[32], 32, ctr1,
+                              &sched) == 0 ||
+            tc_ctr_mode(out, 32, plaintext, 32, ctr0, &sched) == 0) {
+                TC_ERROR("CTR test #4 (split encryption) failed in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest4;
+        }
+
+        result = check_result(4, ciphertext, sizeof(ciphertext),
+			      out, sizeof(out));
+        if (result != TC_PASS) {
+                goto exitTest4;
+        }
+
+        /* only the last 4 bytes of the counter are advanced, modulo 2^32: */
+        (void)memcpy(ctr0, ctr, sizeof(ctr0));
+        (void)tc_ctr_advance(ctr0, 0x03020102);
+        result = check_result(4, wrap_ctr, sizeof(wrap_ctr),
+			      ctr0, sizeof(ctr0));
+
+ exitTest4:
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * CTR test #5: SP 800-38a F.5.1 with the plaintext scattered in segments that
+ * straddle block boundaries.
+ */
+unsigned int test_5(void)
+{
+        const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+        };
+        const uint8_t next_ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xff, 0x03
+        };
+        const uint8_t plaintext[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+		0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+		0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+		0xe6, 0x6c, 0x37, 0x10
+        };
+        const uint8_t ciphertext[64] = {
+		0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64,
+		0x99, 0x0d, 0xb6, 0xce, 0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+		0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff, 0x5a, 0xe4, 0xdf, 0x3e,
+		0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+		0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0,
+		0xf3, 0x00, 0x9c, 0xee
+        };
+        const struct tc_iovec iov[] = {
+                {&plaintext[0], 5}, {&plaintext[5], 0}, {&plaintext[5], 20},
+                {&plaintext[25], 39}
+        };
+        struct tc_aes_key_sched_struct sched;
+        uint8_t ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xfe, 0xff
+        };
+        uint8_t out[64];
+        unsigned int result = TC_PASS;
+
+        TC_PRINT("CTR test #5 (scatter-gather encryption):\n");
+        (void)tc_aes128_set_encrypt_key(&sched, key);
+
+        if (tc_ctr_mode_v(out, sizeof(out), iov, sizeof(iov) / sizeof(iov[0]),
+                          ctr, &sched) == 0) {
+                TC_ERROR("CTR test #5 (scatter-gather) failed in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest5;
+        }
+
+        result = check_result(5, ciphertext, sizeof(ciphertext),
+			      out, sizeof(out));
+        if (result != TC_PASS) {
+                goto exitTest5;
+        }
+        result = check_result(5, next_ctr, sizeof(next_ctr),
+			      ctr, sizeof(ctr));
+
+ exitTest5:
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * CTR test #6: a stream refuses, without producing output, a call that would
+ * take it past TC_CTR_MAX_BYTES (the position is set near the limit instead
+ * of encrypting 64 GiB).
+ */
+unsigned int test_6(void)
+{
+        const uint8_t key[16] = { 0 };
+        const uint8_t ctr[16] = { 0 };
+        const uint8_t in[32] = { 0 };
+        struct tc_aes_key_sched_struct sched;
+        struct tc_ctr_stream_struct s;
+        uint8_t out[32];
+        unsigned int result = TC_PASS;
+
+        TC_PRINT("CTR test #6 (stream limited to TC_CTR_MAX_BYTES):\n");
+        (void)tc_aes128_set_encrypt_key(&sched, key);
+        (void)tc_ctr_stream_init(&s, ctr, &sched);
+        s.bytes = TC_CTR_MAX_BYTES - 20;
+
+        memset(out, 0xa5, sizeof(out));
+        if (tc_ctr_stream_xor(&s, out, in, 21) != TC_CRYPTO_FAIL ||
+            out[0] != 0xa5 || s.bytes != TC_CTR_MAX_BYTES - 20) {
+                TC_ERROR("CTR test #6: the stream went past its limit.\n");
+                result = TC_FAIL;
+                goto exitTest6;
+        }
+        if (tc_ctr_stream_xor(&s, out, in, 20) != TC_CRYPTO_SUCCESS ||
+            tc_ctr_stream_xor(&s, out, in, 0) != TC_CRYPTO_SUCCESS) {
+                TC_ERROR("CTR test #6: the last bytes were refused.\n");
+                result = TC_FAIL;
+                goto exitTest6;
+        }
+        if (tc_ctr_stream_xor(&s, out, in, 1) != TC_CRYPTO_FAIL) {
+                TC_ERROR("CTR test #6: the stream went past its limit.\n");
+                result = TC_FAIL;
+        }
+
+ exitTest6:
+        (void)tc_ctr_stream_erase(&s);
+        TC_END_RESULT(result);
+        return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -130,6 +384,28 @@ int main(void)
                 goto exitTest;
         }
 
+        result = test_3();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #3 failed.\n");
+                goto exitTest;
+        }
+
+        result = test_4();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #4 failed.\n");
+                goto exitTest;
+        }
+        result = test_5();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #5 failed.\n");
+                goto exitTest;
+        }
+        result = test_6();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #6 failed.\n");
+                goto exitTest;
+        }
+
         TC_PRINT("All CTR tests succeeded!\n");
 
  exitTest:
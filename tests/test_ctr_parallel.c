@@ -0,0 +1,321 @@
+/* test_ctr_parallel.c - TinyCrypt implementation of some multi-threaded CTR mode tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following multi-threaded CTR mode routines:
+ *
+ * Scenarios tested include:
+ * - Output and final counter identical to tc_ctr_mode_large for several
+ *   lengths and thread counts, with a counter wrapping modulo 2^32
+ * - In-place encryption
+ * - Concurrent callers sharing the worker pool
+ * - Use of the worker pool in a forked child
+ * - Input checks
+ */
+
+#include <tinycrypt/ctr_parallel.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_CALLERS 3
+
+static const uint8_t key[TC_AES_KEY_SIZE] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+	0x09, 0xcf, 0x4f, 0x3c
+};
+
+/* the last 4 bytes wrap around after 16 blocks */
+static const uint8_t initial_ctr[TC_AES_BLOCK_SIZE] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+	0xff, 0xff, 0xff, 0xf0
+};
+
+static struct tc_aes_key_sched_struct sched;
+
+static void fill(uint8_t *data, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; ++i) {
+		data[i] = (uint8_t) (i * 7 + (i >> 11));
+	}
+}
+
+/*
+ * Encrypts len bytes with nthreads threads and compares the output and the
+ * final counter to tc_ctr_mode_large; in place if in_place is set.
+ */
+static int compare(size_t len, unsigned int nthreads, int in_place)
+{
+	uint8_t ctr1[TC_AES_BLOCK_SIZE], ctr2[TC_AES_BLOCK_SIZE];
+	uint8_t *in = malloc(len), *out1 = malloc(len), *out2 = malloc(len);
+	int ok = 0;
+
+	if (!in || !out1 || !out2) {
+		goto done;
+	}
+	fill(in, len);
+	memcpy(ctr1, initial_ctr, sizeof(ctr1));
+	memcpy(ctr2, initial_ctr, sizeof(ctr2));
+	if (!tc_ctr_mode_large(out1, len, in, len, ctr1, &sched)) {
+		goto done;
+	}
+	if (in_place) {
+		memcpy(out2, in, len);
+		ok = tc_ctr_mode_parallel(out2, out2, len, ctr2, &sched,
+					  nthreads);
+	} else {
+		ok = tc_ctr_mode_parallel(out2, in, len, ctr2, &sched,
+					  nthreads);
+	}
+	ok = ok && memcmp(out1, out2, len) == 0 &&
+	     memcmp(ctr1, ctr2, sizeof(ctr1)) == 0;
+
+done:
+	free(in);
+	free(out1);
+	free(out2);
+	return ok;
+}
+
+/*
+ * Output and final counter identical to tc_ctr_mode_large.
+ */
+unsigned int test_1(void)
+{
+	const size_t lengths[] = {
+		1, 15, 16, 17, TC_CTR_PARALLEL_MIN_CHUNK + 1,
+		3 * TC_CTR_PARALLEL_MIN_CHUNK + 5, 8 * TC_CTR_PARALLEL_MIN_CHUNK,
+		(1 << 20) + 7
+	};
+	const unsigned int threads[] = { 1, 2, 3, 4, 8 };
+	unsigned int result = TC_PASS;
+	unsigned int i, j;
+
+	TC_PRINT("CTR parallel %s:\n", __func__);
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		for (j = 0; j < sizeof(threads) / sizeof(threads[0]); ++j) {
+			if (!compare(lengths[i], threads[j], 0)) {
+				TC_ERROR("%u bytes on %u threads differ from "
+					 "tc_ctr_mode_large.\n",
+					 (unsigned int) lengths[i], threads[j]);
+				result = TC_FAIL;
+				goto exitTest1;
+			}
+		}
+	}
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * In-place encryption.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("CTR parallel %s:\n", __func__);
+
+	if (!compare(5 * TC_CTR_PARALLEL_MIN_CHUNK + 3, 4, 1)) {
+		TC_ERROR("in-place encryption differs from tc_ctr_mode_large.\n");
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+static void *caller(void *arg)
+{
+	unsigned int i;
+
+	for (i = 0; i < 4; ++i) {
+		if (!compare(4 * TC_CTR_PARALLEL_MIN_CHUNK + 9, 4, 0)) {
+			*(int *) arg = 0;
+			break;
+		}
+	}
+	return (void *) 0;
+}
+
+/*
+ * Concurrent callers share the worker pool.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	pthread_t threads[NUM_CALLERS];
+	int ok[NUM_CALLERS];
+	unsigned int i;
+
+	TC_PRINT("CTR parallel %s:\n", __func__);
+
+	for (i = 0; i < NUM_CALLERS; ++i) {
+		ok[i] = 1;
+		if (pthread_create(&threads[i], (const pthread_attr_t *) 0,
+				   &caller, &ok[i]) != 0) {
+			TC_ERROR("pthread_create failed.\n");
+			result = TC_FAIL;
+			goto exitTest3;
+		}
+	}
+	for (i = 0; i < NUM_CALLERS; ++i) {
+		(void)pthread_join(threads[i], (void **) 0);
+		if (!ok[i]) {
+			TC_ERROR("a concurrent call differs from "
+				 "tc_ctr_mode_large.\n");
+			result = TC_FAIL;
+		}
+	}
+
+exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * A forked child starts with an empty pool and refills it.
+ */
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+	int status = 0;
+	pid_t pid;
+
+	TC_PRINT("CTR parallel %s:\n", __func__);
+
+	pid = fork();
+	if (pid == 0) {
+		_exit(compare(4 * TC_CTR_PARALLEL_MIN_CHUNK, 4, 0) ? 0 : 1);
+	}
+	if (pid < 0 ||
+	    waitpid(pid, &status, 0) != pid ||
+	    !WIFEXITED(status) ||
+	    WEXITSTATUS(status) != 0) {
+		TC_ERROR("tc_ctr_mode_parallel failed in a forked child.\n");
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Input checks.
+ */
+unsigned int test_5(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t ctr[TC_AES_BLOCK_SIZE] = { 0 };
+	uint8_t data[TC_AES_BLOCK_SIZE] = { 0 };
+
+	TC_PRINT("CTR parallel %s:\n", __func__);
+
+	if (tc_ctr_mode_parallel((uint8_t *) 0, data, sizeof(data), ctr,
+				 &sched, 2) != TC_CRYPTO_FAIL ||
+	    tc_ctr_mode_parallel(data, (const uint8_t *) 0, sizeof(data), ctr,
+				 &sched, 2) != TC_CRYPTO_FAIL ||
+	    tc_ctr_mode_parallel(data, data, sizeof(data), (uint8_t *) 0,
+				 &sched, 2) != TC_CRYPTO_FAIL ||
+	    tc_ctr_mode_parallel(data, data, sizeof(data), ctr,
+				 (TCAesKeySched_t) 0, 2) != TC_CRYPTO_FAIL ||
+	    tc_ctr_mode_parallel(data, data, 0, ctr, &sched, 2) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_ctr_mode_parallel(data, data, sizeof(data), ctr, &sched, 0) !=
+	    TC_CRYPTO_FAIL) {
+		TC_ERROR("tc_ctr_mode_parallel input checks failed.\n");
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test the multi-threaded CTR mode
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing multi-threaded AES128-CTR mode tests:");
+
+	(void)tc_aes128_set_encrypt_key(&sched, key);
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CTR parallel test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CTR parallel test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CTR parallel test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CTR parallel test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CTR parallel test #5 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All multi-threaded CTR mode tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
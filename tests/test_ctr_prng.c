@@ -529,6 +529,60 @@ static int test_robustness(void)
 	return result;
 }
 
+static int test_counter_carry(void)
+{
+	unsigned int i;
+	int result = TC_PASS;
+	uint8_t entropy[32U] = {0U}; /* value not important */
+	uint8_t ctr[TC_AES_BLOCK_SIZE];
+	uint8_t expected[3U * TC_AES_BLOCK_SIZE];
+	uint8_t output[3U * TC_AES_BLOCK_SIZE];
+	TCCtrPrng_t ctx;
+
+	(void)tc_ctr_prng_init(&ctx, entropy, sizeof entropy, 0, 0U);
+
+	/*
+	 * V is one 128-bit counter, kept as two 64-bit words while generating:
+	 * show that the low word carries into the high word, and that V wraps
+	 * around to zero
+	 */
+	memset(ctx.V, 0x00U, 8U);
+	memset(&ctx.V[8], 0xffU, 8U);
+	ctx.V[7] = 0xffU;
+	ctx.V[15] = 0xfeU;
+
+	memcpy(ctr, ctx.V, sizeof ctr);
+	for (i = 0U; i < 3U; i++) {
+		unsigned int j;
+		for (j = sizeof ctr; j > 0U; j--) {
+			if (++ctr[j - 1U] != 0U) {
+				break;
+			}
+		}
+		(void)tc_aes_encrypt(&expected[i * TC_AES_BLOCK_SIZE], ctr,
+				     &ctx.key);
+	}
+
+	(void)tc_ctr_prng_generate(&ctx, 0, 0U, output, sizeof output);
+	if (0 != memcmp(expected, output, sizeof output)) {
+		result = TC_FAIL;
+	}
+
+	memset(ctx.V, 0xffU, sizeof ctx.V);
+	memset(ctr, 0x00U, sizeof ctr);
+	(void)tc_aes_encrypt(expected, ctr, &ctx.key);
+	(void)tc_ctr_prng_generate(&ctx, 0, 0U, output, 5U);
+	if (0 != memcmp(expected, output, 5U)) {
+		result = TC_FAIL;
+	}
+
+	if (TC_FAIL == result) {
+		TC_ERROR("CTR PRNG counter carry tests failed\n");
+	}
+
+	return result;
+}
+
 /*
  * Main task to test CTR PRNG
  */
@@ -544,15 +598,23 @@ int main(void)
 		}
 	}
 
-	if (TC_PASS != test_reseed()) {
+	result = test_reseed();
+	if (TC_PASS != result) {
+		goto exitTest;
+	}
+
+	result = test_uninstantiate();
+	if (TC_PASS != result) {
 		goto exitTest;
 	}
 
-	if (TC_PASS != test_uninstantiate()) {
+	result = test_robustness();
+	if (TC_PASS != result) {
 		goto exitTest;
 	}
 
-	if (TC_PASS != test_robustness()) {
+	result = test_counter_carry();
+	if (TC_PASS != result) {
 		goto exitTest;
 	}
 
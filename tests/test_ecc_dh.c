@@ -58,6 +58,7 @@
 #include <tinycrypt/ecc.h>
 #include <tinycrypt/ecc_dh.h>
 #include <tinycrypt/ecc_platform_specific.h>
+#include <tinycrypt/random.h>
 #include <test_ecc_utils.h>
 #include <test_utils.h>
 #include <tinycrypt/constants.h>
@@ -67,6 +68,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/wait.h>
 
 int ecdh_vectors(char **qx_vec, char **qy_vec, char **d_vec, char **z_vec,
 		  int tests, int verbose)
@@ -477,6 +479,54 @@ int montecarlo_ecdh(int num_tests, bool verbose)
         return result;
 }
 
+/*
+ * buffered_CSPRNG must not hand out the same bytes in a forked child as in
+ * its parent, even though the child inherits the buffer.
+ */
+int buffered_csprng_fork(void)
+{
+	uint8_t parent[32];
+	uint8_t child[32];
+	int fds[2];
+	pid_t pid;
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("Test #5: buffered_CSPRNG across fork()\n");
+
+	/* fill the buffer of this thread */
+	if (!buffered_CSPRNG(parent, 1) || pipe(fds) != 0) {
+		TC_ERROR("buffered_CSPRNG setup failed\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	pid = fork();
+	if (pid == 0) {
+		int ok = buffered_CSPRNG(child, sizeof(child)) &&
+			 write(fds[1], child, sizeof(child)) ==
+			 (ssize_t) sizeof(child);
+		_exit(ok ? 0 : 1);
+	}
+	close(fds[1]);
+	if (pid < 0 ||
+	    !buffered_CSPRNG(parent, sizeof(parent)) ||
+	    read(fds[0], child, sizeof(child)) != (ssize_t) sizeof(child)) {
+		TC_ERROR("buffered_CSPRNG failed\n");
+		result = TC_FAIL;
+	} else if (memcmp(parent, child, sizeof(parent)) == 0) {
+		TC_ERROR("buffered_CSPRNG repeated its output in a child\n");
+		result = TC_FAIL;
+	}
+	close(fds[0]);
+	if (pid > 0) {
+		(void)waitpid(pid, (int *) 0, 0);
+	}
+
+ exitTest1:
+        TC_END_RESULT(result);
+        return result;
+}
+
 int main()
 {
         unsigned int result = TC_PASS;
@@ -512,6 +562,19 @@ int main()
                 TC_ERROR("montecarlo_ecdh test failed.\n");
                 goto exitTest;
         }
+	TC_PRINT("Performing buffered_csprng_fork test:\n");
+	result = buffered_csprng_fork();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("buffered_csprng_fork test failed.\n");
+                goto exitTest;
+        }
+	TC_PRINT("Performing montecarlo_ecdh test with buffered_CSPRNG:\n");
+	uECC_set_rng(&buffered_CSPRNG);
+	result = montecarlo_ecdh(10, verbose);
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("montecarlo_ecdh test failed.\n");
+                goto exitTest;
+        }
 
         TC_PRINT("All EC-DH tests succeeded!\n");
 
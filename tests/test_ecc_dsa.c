@@ -61,6 +61,7 @@
 #include <tinycrypt/ecc_dh.h>
 #include <tinycrypt/constants.h>
 #include <tinycrypt/sha256.h>
+#include <tinycrypt/ctr_prng.h>
 #include <test_utils.h>
 #include <test_ecc_utils.h>
 
@@ -632,6 +633,159 @@ int montecarlo_signverify(int num_tests, bool verbose)
 	return TC_PASS;
 }
 
+/* uECC_RNG_Function_ex drawing from the TCCtrPrng_t given as context */
+static int ctr_prng_rng(void *ctx, uint8_t *dest, unsigned int size)
+{
+	return tc_ctr_prng_generate((TCCtrPrng_t *) ctx, 0, 0, dest, size) ==
+	       TC_CRYPTO_SUCCESS;
+}
+
+int montecarlo_signverify_ex(int num_tests, bool verbose)
+{
+	printf("Test #4: Monte Carlo (%d EC-DSA signatures with per-context "
+	       "RNGs) NIST-p256\n  ", num_tests);
+	int i;
+	uint8_t entropy[32];
+	TCCtrPrng_t prng1, prng2;
+	uint8_t private1[NUM_ECC_BYTES], private2[NUM_ECC_BYTES];
+	uint8_t public1[2*NUM_ECC_BYTES], public2[2*NUM_ECC_BYTES];
+	uint8_t hash[NUM_ECC_BYTES];
+	uint8_t sig[2*NUM_ECC_BYTES];
+	unsigned int result = TC_PASS;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+	uECC_RNG_Function global_rng = uECC_get_rng();
+
+	/* the *_ex procedures must not need the global RNG */
+	uECC_set_rng(0);
+
+	for (i = 0; i < num_tests; ++i) {
+		if (verbose) {
+			TC_PRINT(".");
+			fflush(stdout);
+		}
+
+		/* equally seeded contexts must give the same key pair */
+		memset(entropy, i, sizeof(entropy));
+		(void)tc_ctr_prng_init(&prng1, entropy, sizeof(entropy), 0, 0);
+		(void)tc_ctr_prng_init(&prng2, entropy, sizeof(entropy), 0, 0);
+		if (!uECC_make_key_ex(public1, private1, curve, &ctr_prng_rng,
+				      &prng1) ||
+		    !uECC_make_key_ex(public2, private2, curve, &ctr_prng_rng,
+				      &prng2)) {
+			TC_ERROR("uECC_make_key_ex() failed\n");
+			result = TC_FAIL;
+			break;
+		}
+		if (memcmp(private1, private2, sizeof(private1)) != 0 ||
+		    memcmp(public1, public2, sizeof(public1)) != 0) {
+			TC_ERROR("uECC_make_key_ex() ignored its context\n");
+			result = TC_FAIL;
+			break;
+		}
+
+		memset(hash, 0xa5 ^ i, sizeof(hash));
+		if (!uECC_sign_ex(private1, hash, sizeof(hash), sig, curve,
+				  &ctr_prng_rng, &prng1)) {
+			TC_ERROR("uECC_sign_ex() failed\n");
+			result = TC_FAIL;
+			break;
+		}
+		if (!uECC_verify(public1, hash, sizeof(hash), sig, curve)) {
+			TC_ERROR("uECC_verify() failed\n");
+			result = TC_FAIL;
+			break;
+		}
+	}
+	TC_PRINT("\n");
+
+	uECC_set_rng(global_rng);
+	return result;
+}
+
+/* RFC 6979 A.2.5: NIST P-256 key pair and SHA-256 signatures */
+static const uint8_t rfc6979_private[NUM_ECC_BYTES] = {
+	0xc9, 0xaf, 0xa9, 0xd8, 0x45, 0xba, 0x75, 0x16, 0x6b, 0x5c, 0x21, 0x57,
+	0x67, 0xb1, 0xd6, 0x93, 0x4e, 0x50, 0xc3, 0xdb, 0x36, 0xe8, 0x9b, 0x12,
+	0x7b, 0x8a, 0x62, 0x2b, 0x12, 0x0f, 0x67, 0x21
+};
+static const uint8_t rfc6979_public[2*NUM_ECC_BYTES] = {
+	0x60, 0xfe, 0xd4, 0xba, 0x25, 0x5a, 0x9d, 0x31, 0xc9, 0x61, 0xeb, 0x74,
+	0xc6, 0x35, 0x6d, 0x68, 0xc0, 0x49, 0xb8, 0x92, 0x3b, 0x61, 0xfa, 0x6c,
+	0xe6, 0x69, 0x62, 0x2e, 0x60, 0xf2, 0x9f, 0xb6, 0x79, 0x03, 0xfe, 0x10,
+	0x08, 0xb8, 0xbc, 0x99, 0xa4, 0x1a, 0xe9, 0xe9, 0x56, 0x28, 0xbc, 0x64,
+	0xf2, 0xf1, 0xb2, 0x0c, 0x2d, 0x7e, 0x9f, 0x51, 0x77, 0xa3, 0xc2, 0x94,
+	0xd4, 0x46, 0x22, 0x99
+};
+static const char *rfc6979_msg[2] = { "sample", "test" };
+static const uint8_t rfc6979_sig[2][2*NUM_ECC_BYTES] = {
+	{
+		0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd, 0x11, 0x40, 0xdd, 0x9c,
+		0xd4, 0x5e, 0x81, 0xd6, 0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa, 0xf9, 0x91,
+		0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16, 0xf7, 0xcb, 0x1c, 0x94,
+		0x2d, 0x65, 0x7c, 0x41, 0xd4, 0x36, 0xc7, 0xa1, 0xb6, 0xe2, 0x9f, 0x65,
+		0xf3, 0xe9, 0x00, 0xdb, 0xb9, 0xaf, 0xf4, 0x06, 0x4d, 0xc4, 0xab, 0x2f,
+		0x84, 0x3a, 0xcd, 0xa8
+	}, {
+		0xf1, 0xab, 0xb0, 0x23, 0x51, 0x83, 0x51, 0xcd, 0x71, 0xd8, 0x81, 0x56,
+		0x7b, 0x1e, 0xa6, 0x63, 0xed, 0x3e, 0xfc, 0xf6, 0xc5, 0x13, 0x2b, 0x35,
+		0x4f, 0x28, 0xd3, 0xb0, 0xb7, 0xd3, 0x83, 0x67, 0x01, 0x9f, 0x41, 0x13,
+		0x74, 0x2a, 0x2b, 0x14, 0xbd, 0x25, 0x92, 0x6b, 0x49, 0xc6, 0x49, 0x15,
+		0x5f, 0x26, 0x7e, 0x60, 0xd3, 0x81, 0x4b, 0x4c, 0x0c, 0xc8, 0x42, 0x50,
+		0xe4, 0x6f, 0x00, 0x83
+	}
+};
+
+int rfc6979_sign(bool verbose)
+{
+	printf("Test #5: RFC 6979 deterministic EC-DSA signatures "
+	       "NIST-p256, SHA2-256\n");
+	struct tc_sha256_state_struct sha256_ctx;
+	uint8_t hash[TC_SHA256_DIGEST_SIZE];
+	uint8_t sig[2*NUM_ECC_BYTES];
+	unsigned int result = TC_PASS;
+	int i;
+
+	const struct uECC_Curve_t * curve = uECC_secp256r1();
+	uECC_RNG_Function global_rng = uECC_get_rng();
+
+	/* deterministic signatures must not need the global RNG */
+	uECC_set_rng(0);
+
+	for (i = 0; i < 2; ++i) {
+		(void)tc_sha256_init(&sha256_ctx);
+		(void)tc_sha256_update(&sha256_ctx,
+				       (const uint8_t *) rfc6979_msg[i],
+				       strlen(rfc6979_msg[i]));
+		(void)tc_sha256_final(hash, &sha256_ctx);
+
+		if (!uECC_sign_deterministic(rfc6979_private, hash,
+					     sizeof(hash), sig, curve)) {
+			TC_ERROR("uECC_sign_deterministic() failed\n");
+			result = TC_FAIL;
+			break;
+		}
+		if (memcmp(sig, rfc6979_sig[i], sizeof(sig)) != 0) {
+			TC_ERROR("signature of \"%s\" differs from RFC 6979\n",
+				 rfc6979_msg[i]);
+			if (verbose) {
+				show_str("r||s", sig, sizeof(sig));
+			}
+			result = TC_FAIL;
+			break;
+		}
+		if (!uECC_verify(rfc6979_public, hash, sizeof(hash), sig,
+				 curve)) {
+			TC_ERROR("uECC_verify() failed\n");
+			result = TC_FAIL;
+			break;
+		}
+	}
+
+	uECC_set_rng(global_rng);
+	return result;
+}
+
 int main()
 {
 	unsigned int result = TC_PASS;
@@ -660,6 +814,18 @@ int main()
 		TC_ERROR("montecarlo_signverify test failed.\n");
 	goto exitTest;
 	}
+	TC_PRINT("Performing montecarlo_signverify_ex test:\n");
+	result = montecarlo_signverify_ex(10, verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("montecarlo_signverify_ex test failed.\n");
+		goto exitTest;
+	}
+	TC_PRINT("Performing rfc6979_sign test:\n");
+	result = rfc6979_sign(verbose);
+	if (result == TC_FAIL) {
+		TC_ERROR("rfc6979_sign test failed.\n");
+		goto exitTest;
+	}
 
 	TC_PRINT("\nAll ECC-DSA tests succeeded.\n");
 
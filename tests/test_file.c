@@ -0,0 +1,593 @@
+/* test_file.c - TinyCrypt implementation of some file helper tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following file helper routines:
+ *
+ * Scenarios tested include:
+ * - SHA-256 of small and empty regular files (FIPS 180-2 vectors)
+ * - SHA-256 of a regular file and of a pipe against the in-memory digest
+ * - HMAC-SHA256 of a regular file against the in-memory tag
+ * - AES-CTR of a regular file against tc_ctr_mode
+ * - SHA-256 of a pseudo file reporting a size of zero (/proc)
+ * - SHA-256 of a pipe much larger than the pipe buffer, fed by a thread
+ * - AES-CTR failing to write its output while the input pipe is idle
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <tinycrypt/file.h>
+#include <tinycrypt/sha256.h>
+#include <tinycrypt/hmac.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* straddles several read buffers and ends with a partial block */
+#define DATA_SIZE (3 * TC_FILE_BUFFER_SIZE + 17)
+
+static uint8_t data[DATA_SIZE];
+
+/* bytes written to the pipe of test_6 */
+#define PIPE_DATA_SIZE ((size_t) 1 << 20)
+
+/* returns an anonymous temporary file holding len bytes of buf, or -1 */
+static int make_file(const uint8_t *buf, size_t len)
+{
+	char name[] = "/tmp/tc_file_XXXXXX";
+	int fd;
+
+	fd = mkstemp(name);
+	if (fd < 0) {
+		return -1;
+	}
+	(void)unlink(name);
+	if (len > 0 && write(fd, buf, len) != (ssize_t) len) {
+		(void)close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void fill_data(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < DATA_SIZE; ++i) {
+		data[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+}
+
+/*
+ * SHA-256 of "abc" and of the empty string, read from regular files.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t abc[] = { 'a', 'b', 'c' };
+	const uint8_t expected_abc[32] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde,
+		0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+		0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+	};
+	const uint8_t expected_empty[32] = {
+		0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8,
+		0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+		0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55
+	};
+	struct tc_sha256_state_struct s;
+	uint8_t digest[32];
+	uint64_t nbytes;
+	int ok;
+	int fd;
+
+	TC_PRINT("%s: SHA-256 of small regular files\n", __func__);
+
+	fd = make_file(abc, sizeof(abc));
+	if (fd < 0) {
+		TC_ERROR("cannot create a temporary file.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	(void)tc_sha256_init(&s);
+	ok = tc_sha256_file(&s, fd, &nbytes);
+	(void)close(fd);
+	if (!ok || nbytes != sizeof(abc)) {
+		TC_ERROR("tc_sha256_file failed.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	(void)tc_sha256_final(digest, &s);
+	result = check_result(1, expected_abc, sizeof(expected_abc),
+			      digest, sizeof(digest));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+
+	fd = make_file(abc, 0);
+	if (fd < 0) {
+		TC_ERROR("cannot create a temporary file.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	(void)tc_sha256_init(&s);
+	ok = tc_sha256_file(&s, fd, &nbytes);
+	(void)close(fd);
+	if (!ok || nbytes != 0) {
+		TC_ERROR("tc_sha256_file failed on an empty file.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	(void)tc_sha256_final(digest, &s);
+	result = check_result(1, expected_empty, sizeof(expected_empty),
+			      digest, sizeof(digest));
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * SHA-256 of a regular file and of a pipe must match the digest computed
+ * over the same bytes in memory.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_sha256_state_struct s;
+	uint8_t expected[32];
+	uint8_t digest[32];
+	uint64_t nbytes;
+	int ok;
+	int fds[2];
+	int fd;
+
+	TC_PRINT("%s: SHA-256 of a regular file and of a pipe\n", __func__);
+
+	(void)tc_sha256_init(&s);
+	(void)tc_sha256_update(&s, data, sizeof(data));
+	(void)tc_sha256_final(expected, &s);
+
+	fd = make_file(data, sizeof(data));
+	if (fd < 0) {
+		TC_ERROR("cannot create a temporary file.\n");
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+	(void)tc_sha256_init(&s);
+	ok = tc_sha256_file(&s, fd, &nbytes);
+	(void)close(fd);
+	if (!ok || nbytes != sizeof(data)) {
+		TC_ERROR("tc_sha256_file failed on a regular file.\n");
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+	(void)tc_sha256_final(digest, &s);
+	result = check_result(2, expected, sizeof(expected),
+			      digest, sizeof(digest));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+
+	/* DATA_SIZE fits in the pipe buffer, so it can be written up front */
+	if (pipe(fds) != 0) {
+		TC_ERROR("cannot create a pipe.\n");
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+	if (write(fds[1], data, sizeof(data)) != (ssize_t) sizeof(data)) {
+		TC_ERROR("cannot fill the pipe.\n");
+		(void)close(fds[0]);
+		(void)close(fds[1]);
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+	(void)close(fds[1]);
+	(void)tc_sha256_init(&s);
+	ok = tc_sha256_file(&s, fds[0], &nbytes);
+	(void)close(fds[0]);
+	if (!ok || nbytes != sizeof(data)) {
+		TC_ERROR("tc_sha256_file failed on a pipe.\n");
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+	(void)tc_sha256_final(digest, &s);
+	result = check_result(2, expected, sizeof(expected),
+			      digest, sizeof(digest));
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * HMAC-SHA256 of a regular file must match the tag computed in memory.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t key[20] = {
+		0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+		0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+	};
+	struct tc_hmac_state_struct h;
+	uint8_t expected[32];
+	uint8_t tag[32];
+	uint64_t nbytes;
+	int ok;
+	int fd;
+
+	TC_PRINT("%s: HMAC-SHA256 of a regular file\n", __func__);
+
+	(void)tc_hmac_set_key(&h, key, sizeof(key));
+	(void)tc_hmac_init(&h);
+	(void)tc_hmac_update(&h, data, sizeof(data));
+	(void)tc_hmac_final(expected, sizeof(expected), &h);
+
+	fd = make_file(data, sizeof(data));
+	if (fd < 0) {
+		TC_ERROR("cannot create a temporary file.\n");
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+	(void)tc_hmac_set_key(&h, key, sizeof(key));
+	(void)tc_hmac_init(&h);
+	ok = tc_hmac_file(&h, fd, &nbytes);
+	(void)close(fd);
+	if (!ok || nbytes != sizeof(data)) {
+		TC_ERROR("tc_hmac_file failed.\n");
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+	(void)tc_hmac_final(tag, sizeof(tag), &h);
+	result = check_result(3, expected, sizeof(expected), tag, sizeof(tag));
+
+ exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * AES-CTR of a regular file into another file must match tc_ctr_mode over
+ * the same bytes in memory.
+ */
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+	};
+	const uint8_t ctr[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xfc, 0xfd, 0xfe, 0xff
+	};
+	static uint8_t expected[DATA_SIZE];
+	static uint8_t out[DATA_SIZE];
+	struct tc_aes_key_sched_struct sched;
+	struct tc_ctr_stream_struct s;
+	uint8_t counter[16];
+	uint64_t nbytes;
+	int ok;
+	int in_fd = -1;
+	int out_fd = -1;
+
+	TC_PRINT("%s: AES-CTR of a regular file\n", __func__);
+
+	(void)tc_aes128_set_encrypt_key(&sched, key);
+	memcpy(counter, ctr, sizeof(counter));
+	(void)tc_ctr_mode(expected, sizeof(expected), data, sizeof(data),
+			  counter, &sched);
+
+	in_fd = make_file(data, sizeof(data));
+	out_fd = make_file(data, 0);
+	if (in_fd < 0 || out_fd < 0) {
+		TC_ERROR("cannot create a temporary file.\n");
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	(void)tc_ctr_stream_init(&s, ctr, &sched);
+	ok = tc_ctr_file(&s, in_fd, out_fd, &nbytes);
+	(void)tc_ctr_stream_erase(&s);
+	if (!ok || nbytes != sizeof(data)) {
+		TC_ERROR("tc_ctr_file failed.\n");
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	if (pread(out_fd, out, sizeof(out), 0) != (ssize_t) sizeof(out)) {
+		TC_ERROR("cannot read back the output file.\n");
+		result = TC_FAIL;
+		goto exitTest4;
+	}
+	result = check_result(4, expected, sizeof(expected), out, sizeof(out));
+
+ exitTest4:
+	if (in_fd >= 0) {
+		(void)close(in_fd);
+	}
+	if (out_fd >= 0) {
+		(void)close(out_fd);
+	}
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * SHA-256 of a regular file whose size is reported as zero must cover its
+ * contents, as read with read until end of file.
+ */
+unsigned int test_5(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_sha256_state_struct s;
+	uint8_t buffer[TC_FILE_BUFFER_SIZE];
+	uint8_t expected[32];
+	uint8_t digest[32];
+	uint64_t nbytes;
+	uint64_t len = 0;
+	struct stat st;
+	ssize_t n;
+	int ok;
+	int fd;
+
+	TC_PRINT("%s: SHA-256 of a pseudo file of size zero\n", __func__);
+
+	fd = open("/proc/self/cmdline", O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) != 0 ||
+	    !S_ISREG(st.st_mode) || st.st_size != 0) {
+		TC_PRINT("%s: no suitable pseudo file, skipped\n", __func__);
+		goto exitTest5;
+	}
+	(void)tc_sha256_init(&s);
+	while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+		(void)tc_sha256_update(&s, buffer, (size_t) n);
+		len += (uint64_t) n;
+	}
+	(void)tc_sha256_final(expected, &s);
+	if (n < 0 || len == 0 || lseek(fd, 0, SEEK_SET) != 0) {
+		TC_ERROR("cannot read the pseudo file.\n");
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+
+	(void)tc_sha256_init(&s);
+	ok = tc_sha256_file(&s, fd, &nbytes);
+	if (!ok || nbytes != len) {
+		TC_ERROR("tc_sha256_file failed on a pseudo file.\n");
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+	(void)tc_sha256_final(digest, &s);
+	result = check_result(5, expected, sizeof(expected),
+			      digest, sizeof(digest));
+
+ exitTest5:
+	if (fd >= 0) {
+		(void)close(fd);
+	}
+	TC_END_RESULT(result);
+	return result;
+}
+
+/* writes PIPE_DATA_SIZE bytes of the data pattern to the fd in arg */
+static void *pipe_writer(void *arg)
+{
+	int fd = *(int *) arg;
+	size_t off, n;
+
+	for (off = 0; off < PIPE_DATA_SIZE; off += n) {
+		n = PIPE_DATA_SIZE - off;
+		if (n > sizeof(data)) {
+			n = sizeof(data);
+		}
+		if (write(fd, data, n) != (ssize_t) n) {
+			break;
+		}
+	}
+	(void)close(fd);
+
+	return (void *) 0;
+}
+
+/*
+ * SHA-256 of a pipe written concurrently, through many read buffers, must
+ * match the digest computed in memory.
+ */
+unsigned int test_6(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_sha256_state_struct s;
+	uint8_t expected[32];
+	uint8_t digest[32];
+	uint64_t nbytes;
+	pthread_t writer;
+	size_t off, n;
+	int ok;
+	int fds[2];
+
+	TC_PRINT("%s: SHA-256 of a large pipe\n", __func__);
+
+	(void)tc_sha256_init(&s);
+	for (off = 0; off < PIPE_DATA_SIZE; off += n) {
+		n = PIPE_DATA_SIZE - off;
+		if (n > sizeof(data)) {
+			n = sizeof(data);
+		}
+		(void)tc_sha256_update(&s, data, n);
+	}
+	(void)tc_sha256_final(expected, &s);
+
+	if (pipe(fds) != 0) {
+		TC_ERROR("cannot create a pipe.\n");
+		result = TC_FAIL;
+		goto exitTest6;
+	}
+	if (pthread_create(&writer, (pthread_attr_t *) 0, &pipe_writer,
+			   &fds[1]) != 0) {
+		TC_ERROR("cannot create the writer thread.\n");
+		(void)close(fds[0]);
+		(void)close(fds[1]);
+		result = TC_FAIL;
+		goto exitTest6;
+	}
+	(void)tc_sha256_init(&s);
+	ok = tc_sha256_file(&s, fds[0], &nbytes);
+	(void)pthread_join(writer, (void **) 0);
+	(void)close(fds[0]);
+	if (!ok || nbytes != PIPE_DATA_SIZE) {
+		TC_ERROR("tc_sha256_file failed on a large pipe.\n");
+		result = TC_FAIL;
+		goto exitTest6;
+	}
+	(void)tc_sha256_final(digest, &s);
+	result = check_result(6, expected, sizeof(expected),
+			      digest, sizeof(digest));
+
+ exitTest6:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * tc_ctr_file must fail, rather than wait for more input, when its output
+ * cannot be written while the input pipe stays open but idle.
+ */
+unsigned int test_7(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t key[16] = { 0 };
+	const uint8_t ctr[16] = { 0 };
+	struct tc_aes_key_sched_struct sched;
+	struct tc_ctr_stream_struct s;
+	int ok;
+	int fds[2];
+	int out_fd;
+
+	TC_PRINT("%s: AES-CTR with an unwritable output\n", __func__);
+
+	/* a read-only descriptor: every write fails with EBADF */
+	out_fd = open("/dev/null", O_RDONLY);
+	if (out_fd < 0 || pipe(fds) != 0) {
+		TC_ERROR("cannot create the descriptors.\n");
+		result = TC_FAIL;
+		goto exitTest7;
+	}
+	if (write(fds[1], data, 100) != 100) {
+		TC_ERROR("cannot fill the pipe.\n");
+		result = TC_FAIL;
+	} else {
+		(void)tc_aes128_set_encrypt_key(&sched, key);
+		(void)tc_ctr_stream_init(&s, ctr, &sched);
+		ok = tc_ctr_file(&s, fds[0], out_fd, (uint64_t *) 0);
+		(void)tc_ctr_stream_erase(&s);
+		if (ok) {
+			TC_ERROR("tc_ctr_file ignored a write error.\n");
+			result = TC_FAIL;
+		}
+	}
+	(void)close(fds[0]);
+	(void)close(fds[1]);
+
+ exitTest7:
+	if (out_fd >= 0) {
+		(void)close(out_fd);
+	}
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test the file helpers
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing file helper tests:");
+
+	fill_data();
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #5 failed.\n");
+		goto exitTest;
+	}
+	result = test_6();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #6 failed.\n");
+		goto exitTest;
+	}
+	result = test_7();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("File test #7 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All file helper tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
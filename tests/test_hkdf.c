@@ -0,0 +1,286 @@
+/* test_hkdf.c - TinyCrypt implementation of some HKDF tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following HKDF-SHA256 routines:
+ *
+ * Scenarios tested include:
+ * - RFC 5869 test cases 1 to 3 (extract, expand and one-shot)
+ * - Several keys expanded from the same PRK midstates
+ */
+
+#include <tinycrypt/hkdf.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+struct hkdf_vector {
+	const uint8_t *ikm;
+	size_t ikmlen;
+	const uint8_t *salt;
+	unsigned int saltlen;
+	const uint8_t *info;
+	size_t infolen;
+	const uint8_t *prk;
+	const uint8_t *okm;
+	size_t okmlen;
+};
+
+/* runs extract, expand and the one-shot call on v */
+static unsigned int do_test(unsigned int testnum, const struct hkdf_vector *v)
+{
+	uint8_t prk[TC_SHA256_DIGEST_SIZE];
+	uint8_t okm[82];
+	unsigned int result;
+
+	if (tc_hkdf_extract(prk, v->salt, v->saltlen, v->ikm, v->ikmlen) == 0) {
+		TC_ERROR("tc_hkdf_extract failed.\n");
+		return TC_FAIL;
+	}
+	result = check_result(testnum, v->prk, sizeof(prk), prk, sizeof(prk));
+	if (result == TC_FAIL) {
+		return result;
+	}
+
+	if (tc_hkdf_expand(okm, v->okmlen, prk, sizeof(prk),
+			   v->info, v->infolen) == 0) {
+		TC_ERROR("tc_hkdf_expand failed.\n");
+		return TC_FAIL;
+	}
+	result = check_result(testnum, v->okm, v->okmlen, okm, v->okmlen);
+	if (result == TC_FAIL) {
+		return result;
+	}
+
+	memset(okm, 0, sizeof(okm));
+	if (tc_hkdf(okm, v->okmlen, v->salt, v->saltlen, v->ikm, v->ikmlen,
+		    v->info, v->infolen) == 0) {
+		TC_ERROR("tc_hkdf failed.\n");
+		return TC_FAIL;
+	}
+	return check_result(testnum, v->okm, v->okmlen, okm, v->okmlen);
+}
+
+/* RFC 5869 A.1 and A.3 input keying material */
+static const uint8_t ikm_1[22] = {
+	0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+	0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+};
+
+/*
+ * RFC 5869 test case 1: basic test case.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t salt[13] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+		0x0c
+	};
+	const uint8_t info[10] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9
+	};
+	const uint8_t prk[32] = {
+		0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf, 0x0d, 0xdc, 0x3f, 0x0d,
+		0xc4, 0x7b, 0xba, 0x63, 0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f, 0x9c, 0x31,
+		0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5
+	};
+	const uint8_t okm[42] = {
+		0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64,
+		0xd0, 0x36, 0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c,
+		0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf, 0x34, 0x00, 0x72, 0x08,
+		0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65
+	};
+	const struct hkdf_vector v = {
+		ikm_1, sizeof(ikm_1), salt, sizeof(salt), info, sizeof(info),
+		prk, okm, sizeof(okm)
+	};
+
+	TC_PRINT("HKDF %s:\n", __func__);
+
+	result = do_test(1, &v);
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * RFC 5869 test case 2: longer inputs and outputs.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t ikm[80], salt[80], info[80];
+	const uint8_t prk[32] = {
+		0x06, 0xa6, 0xb8, 0x8c, 0x58, 0x53, 0x36, 0x1a, 0x06, 0x10, 0x4c, 0x9c,
+		0xeb, 0x35, 0xb4, 0x5c, 0xef, 0x76, 0x00, 0x14, 0x90, 0x46, 0x71, 0x01,
+		0x4a, 0x19, 0x3f, 0x40, 0xc1, 0x5f, 0xc2, 0x44
+	};
+	const uint8_t okm[82] = {
+		0xb1, 0x1e, 0x39, 0x8d, 0xc8, 0x03, 0x27, 0xa1, 0xc8, 0xe7, 0xf7, 0x8c,
+		0x59, 0x6a, 0x49, 0x34, 0x4f, 0x01, 0x2e, 0xda, 0x2d, 0x4e, 0xfa, 0xd8,
+		0xa0, 0x50, 0xcc, 0x4c, 0x19, 0xaf, 0xa9, 0x7c, 0x59, 0x04, 0x5a, 0x99,
+		0xca, 0xc7, 0x82, 0x72, 0x71, 0xcb, 0x41, 0xc6, 0x5e, 0x59, 0x0e, 0x09,
+		0xda, 0x32, 0x75, 0x60, 0x0c, 0x2f, 0x09, 0xb8, 0x36, 0x77, 0x93, 0xa9,
+		0xac, 0xa3, 0xdb, 0x71, 0xcc, 0x30, 0xc5, 0x81, 0x79, 0xec, 0x3e, 0x87,
+		0xc1, 0x4c, 0x01, 0xd5, 0xc1, 0xf3, 0x43, 0x4f, 0x1d, 0x87
+	};
+	const struct hkdf_vector v = {
+		ikm, sizeof(ikm), salt, sizeof(salt), info, sizeof(info),
+		prk, okm, sizeof(okm)
+	};
+	unsigned int i;
+
+	TC_PRINT("HKDF %s:\n", __func__);
+
+	/* 0x00..0x4f, 0x60..0xaf and 0xb0..0xff */
+	for (i = 0; i < 80; ++i) {
+		ikm[i] = (uint8_t) i;
+		salt[i] = (uint8_t)(0x60 + i);
+		info[i] = (uint8_t)(0xb0 + i);
+	}
+
+	result = do_test(2, &v);
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * RFC 5869 test case 3: zero-length salt and info.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t prk[32] = {
+		0x19, 0xef, 0x24, 0xa3, 0x2c, 0x71, 0x7b, 0x16, 0x7f, 0x33, 0xa9, 0x1d,
+		0x6f, 0x64, 0x8b, 0xdf, 0x96, 0x59, 0x67, 0x76, 0xaf, 0xdb, 0x63, 0x77,
+		0xac, 0x43, 0x4c, 0x1c, 0x29, 0x3c, 0xcb, 0x04
+	};
+	const uint8_t okm[42] = {
+		0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80, 0x2a,
+		0x06, 0x3c, 0x5a, 0x31, 0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1, 0x87, 0x9e,
+		0xc3, 0x45, 0x4e, 0x5f, 0x3c, 0x73, 0x8d, 0x2d, 0x9d, 0x20, 0x13, 0x95,
+		0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8
+	};
+	const struct hkdf_vector v = {
+		ikm_1, sizeof(ikm_1), (const uint8_t *) 0, 0,
+		(const uint8_t *) 0, 0, prk, okm, sizeof(okm)
+	};
+
+	TC_PRINT("HKDF %s:\n", __func__);
+
+	result = do_test(3, &v);
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Keys for two purposes expanded from the same PRK midstates must match
+ * tc_hkdf_expand.
+ */
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+	const char *labels[2] = { "client key", "server key" };
+	struct tc_hmac_midstates_struct m;
+	uint8_t prk[TC_SHA256_DIGEST_SIZE];
+	uint8_t expected[48];
+	uint8_t okm[48];
+	unsigned int i;
+
+	TC_PRINT("HKDF %s:\n", __func__);
+
+	(void)tc_hkdf_extract(prk, (const uint8_t *) 0, 0,
+			      ikm_1, sizeof(ikm_1));
+	(void)tc_hmac_set_midstates(&m, prk, sizeof(prk));
+	for (i = 0; i < 2; ++i) {
+		(void)tc_hkdf_expand(expected, sizeof(expected), prk,
+				     sizeof(prk), (const uint8_t *) labels[i],
+				     strlen(labels[i]));
+		(void)tc_hkdf_expand_midstates(okm, sizeof(okm), &m,
+					       (const uint8_t *) labels[i],
+					       strlen(labels[i]));
+		result = check_result(4, expected, sizeof(expected),
+				      okm, sizeof(okm));
+		if (result == TC_FAIL) {
+			break;
+		}
+	}
+	(void)tc_hmac_midstates_erase(&m);
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test HKDF
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing HKDF-SHA256 tests (RFC5869 test vectors):");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("HKDF test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("HKDF test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("HKDF test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("HKDF test #4 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All HKDF tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
@@ -302,6 +302,96 @@ unsigned int test_7(void)
         return result;
 }
 
+/*
+ * RFC 4231 test case 2, with the data scattered in segments.
+ */
+unsigned int test_8(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("HMAC %s (scatter-gather):\n", __func__);
+        const uint8_t key[4] = {
+                0x4a, 0x65, 0x66, 0x65
+        };
+        const char *data = "what do ya want for nothing?";
+        const struct tc_iovec iov[] = {
+                {data, 5}, {data + 5, 0}, {data + 5, 22}, {data + 27, 1}
+        };
+        const uint8_t expected[32] = {
+		0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26,
+		0x08, 0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83,
+		0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+        };
+        uint8_t digest[32];
+        struct tc_hmac_state_struct h;
+
+        (void)memset(&h, 0x00, sizeof(h));
+        (void)tc_hmac_set_key(&h, key, sizeof(key));
+        (void)tc_hmac_init(&h);
+        if (tc_hmac_update_v(&h, iov, sizeof(iov) / sizeof(iov[0])) == 0) {
+                TC_ERROR("tc_hmac_update_v failed in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest8;
+        }
+        (void)tc_hmac_final(digest, TC_SHA256_DIGEST_SIZE, &h);
+        result = check_result(8, expected, sizeof(expected),
+			      digest, sizeof(digest));
+exitTest8:
+        TC_END_RESULT(result);
+        return result;
+}
+
+unsigned int test_9(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("HMAC %s (midstates):\n", __func__);
+        const uint8_t key[4] = {
+                0x4a, 0x65, 0x66, 0x65
+        };
+        const char *data = "what do ya want for nothing?";
+        const struct tc_iovec iov[] = {
+                {data, 13}, {data + 13, 15}
+        };
+        const uint8_t expected[32] = {
+		0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26,
+		0x08, 0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83,
+		0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+        };
+        /* HMAC-SHA256 with an empty key */
+        const uint8_t expected_empty[32] = {
+		0x76, 0xd9, 0xe7, 0x19, 0x4e, 0x7d, 0xbc, 0x3a, 0xa0, 0x0b, 0xbe, 0x8f,
+		0xfb, 0x9f, 0x6f, 0xcb, 0x5a, 0x93, 0x21, 0x70, 0xf9, 0x71, 0xf9, 0x48,
+		0xbb, 0x2a, 0xb6, 0x16, 0x07, 0xd2, 0xb9, 0xd6
+        };
+        uint8_t digest[32];
+        struct tc_hmac_midstates_struct m;
+        unsigned int i;
+
+        (void)tc_hmac_set_midstates(&m, key, sizeof(key));
+        /* the midstates are left unchanged: compute the tag twice */
+        for (i = 0; i < 2; ++i) {
+                if (tc_hmac_midstates_v(digest, &m, iov, 2) == 0) {
+                        TC_ERROR("tc_hmac_midstates_v failed in %s.\n",
+                                 __func__);
+                        result = TC_FAIL;
+                        goto exitTest9;
+                }
+                result = check_result(9, expected, sizeof(expected),
+				      digest, sizeof(digest));
+                if (result == TC_FAIL) {
+                        goto exitTest9;
+                }
+        }
+
+        (void)tc_hmac_set_midstates(&m, (const uint8_t *) 0, 0);
+        (void)tc_hmac_midstates_v(digest, &m, iov, 2);
+        result = check_result(9, expected_empty, sizeof(expected_empty),
+			      digest, sizeof(digest));
+exitTest9:
+        (void)tc_hmac_midstates_erase(&m);
+        TC_END_RESULT(result);
+        return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -353,6 +443,18 @@ int main(void)
                 TC_ERROR("HMAC test #7 failed.\n");
                 goto exitTest;
         }
+        result = test_8();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("HMAC test #8 failed.\n");
+                goto exitTest;
+        }
+        result = test_9();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("HMAC test #9 failed.\n");
+                goto exitTest;
+        }
 
         TC_PRINT("All HMAC tests succeeded!\n");
 
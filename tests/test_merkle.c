@@ -0,0 +1,402 @@
+/* test_merkle.c - TinyCrypt implementation of some Merkle tree tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following SHA-256 Merkle tree routines:
+ *
+ * Scenarios tested include:
+ * - RFC 6962 trees of 0 to 8 leaves (Certificate Transparency vectors)
+ * - Streaming input split at arbitrary points
+ * - Recomputing the root after replacing one leaf
+ * - Stored trees of 1 to 40 leaves updated one leaf at a time
+ */
+
+#include <tinycrypt/merkle.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/* Certificate Transparency reference leaves */
+static const uint8_t leaf_0[1] = { 0 };
+static const uint8_t leaf_1[1] = { 0x00 };
+static const uint8_t leaf_2[1] = { 0x10 };
+static const uint8_t leaf_3[2] = { 0x20, 0x21 };
+static const uint8_t leaf_4[2] = { 0x30, 0x31 };
+static const uint8_t leaf_5[4] = { 0x40, 0x41, 0x42, 0x43 };
+static const uint8_t leaf_6[8] = {
+	0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57
+};
+static const uint8_t leaf_7[16] = {
+	0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b,
+	0x6c, 0x6d, 0x6e, 0x6f
+};
+
+static const uint8_t *const ct_leaves[8] = {
+	leaf_0, leaf_1, leaf_2, leaf_3, leaf_4, leaf_5, leaf_6, leaf_7
+};
+static const size_t ct_leaf_lens[8] = { 0, 1, 1, 2, 2, 4, 8, 16 };
+
+/* roots of the trees holding the first 1 to 8 reference leaves */
+static const uint8_t ct_roots[8][32] = {
+	{
+		0x6e, 0x34, 0x0b, 0x9c, 0xff, 0xb3, 0x7a, 0x98, 0x9c, 0xa5, 0x44, 0xe6,
+		0xbb, 0x78, 0x0a, 0x2c, 0x78, 0x90, 0x1d, 0x3f, 0xb3, 0x37, 0x38, 0x76,
+		0x85, 0x11, 0xa3, 0x06, 0x17, 0xaf, 0xa0, 0x1d
+	},
+	{
+		0xfa, 0xc5, 0x42, 0x03, 0xe7, 0xcc, 0x69, 0x6c, 0xf0, 0xdf, 0xcb, 0x42,
+		0xc9, 0x2a, 0x1d, 0x9d, 0xba, 0xf7, 0x0a, 0xd9, 0xe6, 0x21, 0xf4, 0xbd,
+		0x8d, 0x98, 0x66, 0x2f, 0x00, 0xe3, 0xc1, 0x25
+	},
+	{
+		0xae, 0xb6, 0xbc, 0xfe, 0x27, 0x4b, 0x70, 0xa1, 0x4f, 0xb0, 0x67, 0xa5,
+		0xe5, 0x57, 0x82, 0x64, 0xdb, 0x0f, 0xa9, 0xb5, 0x1a, 0xf5, 0xe0, 0xba,
+		0x15, 0x91, 0x58, 0xf3, 0x29, 0xe0, 0x6e, 0x77
+	},
+	{
+		0xd3, 0x7e, 0xe4, 0x18, 0x97, 0x6d, 0xd9, 0x57, 0x53, 0xc1, 0xc7, 0x38,
+		0x62, 0xb9, 0x39, 0x8f, 0xa2, 0xa2, 0xcf, 0x9b, 0x4f, 0xf0, 0xfd, 0xfe,
+		0x8b, 0x30, 0xcd, 0x95, 0x20, 0x96, 0x14, 0xb7
+	},
+	{
+		0x4e, 0x3b, 0xbb, 0x1f, 0x7b, 0x47, 0x8d, 0xcf, 0xe7, 0x1f, 0xb6, 0x31,
+		0x63, 0x15, 0x19, 0xa3, 0xbc, 0xa1, 0x2c, 0x9a, 0xef, 0xca, 0x16, 0x12,
+		0xbf, 0xce, 0x4c, 0x13, 0xa8, 0x62, 0x64, 0xd4
+	},
+	{
+		0x76, 0xe6, 0x7d, 0xad, 0xbc, 0xdf, 0x1e, 0x10, 0xe1, 0xb7, 0x4d, 0xdc,
+		0x60, 0x8a, 0xbd, 0x2f, 0x98, 0xdf, 0xb1, 0x6f, 0xbc, 0xe7, 0x52, 0x77,
+		0xb5, 0x23, 0x2a, 0x12, 0x7f, 0x20, 0x87, 0xef
+	},
+	{
+		0xdd, 0xb8, 0x9b, 0xe4, 0x03, 0x80, 0x9e, 0x32, 0x57, 0x50, 0xd3, 0xd2,
+		0x63, 0xcd, 0x78, 0x92, 0x9c, 0x29, 0x42, 0xb7, 0x94, 0x2a, 0x34, 0xb7,
+		0x7e, 0x12, 0x2c, 0x95, 0x94, 0xa7, 0x4c, 0x8c
+	},
+	{
+		0x5d, 0xc9, 0xda, 0x79, 0xa7, 0x06, 0x59, 0xa9, 0xad, 0x55, 0x9c, 0xb7,
+		0x01, 0xde, 0xd9, 0xa2, 0xab, 0x9d, 0x82, 0x3a, 0xad, 0x2f, 0x49, 0x60,
+		0xcf, 0xe3, 0x70, 0xef, 0xf4, 0x60, 0x43, 0x28
+	}
+};
+
+/* five full leaves and a partial one */
+#define DATA_SIZE (5 * TC_MERKLE_LEAF_SIZE + 100)
+#define NUM_LEAVES 6
+
+/* root of the tree over data */
+static const uint8_t data_root[32] = {
+	0xba, 0x1f, 0x87, 0x50, 0x63, 0x75, 0x0b, 0x6b, 0x92, 0xc9, 0xb4, 0xb6,
+	0x39, 0x1c, 0x85, 0x55, 0x06, 0x02, 0x53, 0x65, 0x1c, 0x72, 0x51, 0xb0,
+	0x6c, 0x61, 0x9f, 0x23, 0xb2, 0xdd, 0x26, 0x78
+};
+
+/* root of the tree over the first four leaves of data */
+static const uint8_t data_root_4[32] = {
+	0x81, 0x32, 0x72, 0x38, 0x2f, 0x95, 0x95, 0xc7, 0xff, 0x64, 0xd4, 0x3c,
+	0xd4, 0xde, 0x15, 0x94, 0xd8, 0xbb, 0xdb, 0x40, 0xf4, 0xfa, 0x4a, 0xc1,
+	0x6c, 0x49, 0xab, 0xbd, 0x9f, 0xe9, 0x79, 0x6a
+};
+
+/* root of the tree over data with byte 2 * TC_MERKLE_LEAF_SIZE + 5 flipped */
+static const uint8_t modified_root[32] = {
+	0xe0, 0xd1, 0x4e, 0x6a, 0xd0, 0xfc, 0x3f, 0xa8, 0xd9, 0xf9, 0xbc, 0x86,
+	0xa9, 0x60, 0x54, 0x43, 0x26, 0x1e, 0x2f, 0x7e, 0x2d, 0xce, 0x53, 0x42,
+	0x86, 0x9b, 0x52, 0x35, 0x96, 0xe2, 0x07, 0x2e
+};
+
+static uint8_t data[DATA_SIZE];
+
+static void fill_data(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < DATA_SIZE; ++i) {
+		data[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+}
+
+/*
+ * RFC 6962 trees built from precomputed leaf hashes.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t empty_root[32] = {
+		0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8,
+		0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+		0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55
+	};
+	struct tc_merkle_struct t;
+	uint8_t hashes[8][32];
+	uint8_t root[32];
+	unsigned int i, n;
+
+	TC_PRINT("%s: RFC 6962 reference trees\n", __func__);
+
+	(void)tc_merkle_init(&t);
+	(void)tc_merkle_final(root, &t);
+	result = check_result(1, empty_root, sizeof(empty_root),
+			      root, sizeof(root));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+
+	for (i = 0; i < 8; ++i) {
+		(void)tc_merkle_leaf(hashes[i], ct_leaves[i], ct_leaf_lens[i]);
+	}
+
+	for (n = 1; n <= 8; ++n) {
+		(void)tc_merkle_init(&t);
+		for (i = 0; i < n; ++i) {
+			if (tc_merkle_add_leaf(&t, hashes[i]) == 0) {
+				TC_ERROR("tc_merkle_add_leaf failed.\n");
+				result = TC_FAIL;
+				goto exitTest1;
+			}
+		}
+		(void)tc_merkle_final(root, &t);
+		result = check_result(1, ct_roots[n - 1], sizeof(ct_roots[n - 1]),
+				      root, sizeof(root));
+		if (result == TC_FAIL) {
+			goto exitTest1;
+		}
+
+		(void)tc_merkle_root(root, &hashes[0][0], n);
+		result = check_result(1, ct_roots[n - 1], sizeof(ct_roots[n - 1]),
+				      root, sizeof(root));
+		if (result == TC_FAIL) {
+			goto exitTest1;
+		}
+	}
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Streaming input must give the same root however it is split.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	const size_t chunks[] = { 1, 1000, TC_MERKLE_LEAF_SIZE, 4095, 3 };
+	struct tc_merkle_struct t;
+	uint8_t root[32];
+	size_t off, n;
+	unsigned int i;
+
+	TC_PRINT("%s: streaming input\n", __func__);
+
+	(void)tc_merkle_init(&t);
+	(void)tc_merkle_update(&t, data, 4 * TC_MERKLE_LEAF_SIZE);
+	(void)tc_merkle_final(root, &t);
+	result = check_result(2, data_root_4, sizeof(data_root_4),
+			      root, sizeof(root));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+
+	(void)tc_merkle_init(&t);
+	(void)tc_merkle_update(&t, data, sizeof(data));
+	(void)tc_merkle_final(root, &t);
+	result = check_result(2, data_root, sizeof(data_root),
+			      root, sizeof(root));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+
+	(void)tc_merkle_init(&t);
+	for (off = 0, i = 0; off < sizeof(data); off += n, ++i) {
+		n = chunks[i % (sizeof(chunks) / sizeof(chunks[0]))];
+		if (n > sizeof(data) - off) {
+			n = sizeof(data) - off;
+		}
+		(void)tc_merkle_update(&t, &data[off], n);
+	}
+	/* leaves cannot be appended while a leaf is incomplete */
+	if (tc_merkle_add_leaf(&t, data_root) != 0) {
+		TC_ERROR("tc_merkle_add_leaf accepted a leaf mid-leaf.\n");
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+	(void)tc_merkle_final(root, &t);
+	result = check_result(2, data_root, sizeof(data_root),
+			      root, sizeof(root));
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Leaves hashed independently, then one leaf replaced: only that leaf is
+ * rehashed before recomputing the root.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t hashes[NUM_LEAVES][32];
+	uint8_t root[32];
+	size_t off, n;
+	unsigned int i;
+
+	TC_PRINT("%s: replacing one leaf\n", __func__);
+
+	for (i = 0, off = 0; i < NUM_LEAVES; ++i, off += n) {
+		n = sizeof(data) - off;
+		if (n > TC_MERKLE_LEAF_SIZE) {
+			n = TC_MERKLE_LEAF_SIZE;
+		}
+		(void)tc_merkle_leaf(hashes[i], &data[off], n);
+	}
+	(void)tc_merkle_root(root, &hashes[0][0], NUM_LEAVES);
+	result = check_result(3, data_root, sizeof(data_root),
+			      root, sizeof(root));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+
+	data[2 * TC_MERKLE_LEAF_SIZE + 5] ^= 0xff;
+	(void)tc_merkle_leaf(hashes[2], &data[2 * TC_MERKLE_LEAF_SIZE],
+			     TC_MERKLE_LEAF_SIZE);
+	data[2 * TC_MERKLE_LEAF_SIZE + 5] ^= 0xff;
+	(void)tc_merkle_root(root, &hashes[0][0], NUM_LEAVES);
+	result = check_result(3, modified_root, sizeof(modified_root),
+			      root, sizeof(root));
+
+ exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Trees kept with tc_merkle_tree_build: replacing any one leaf with
+ * tc_merkle_tree_update gives the same root as tc_merkle_root.
+ */
+#define MAX_TREE_LEAVES 40
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t hashes[MAX_TREE_LEAVES][32];
+	uint8_t nodes[TC_MERKLE_TREE_SIZE(MAX_TREE_LEAVES)];
+	uint8_t expected[32];
+	uint8_t root[32];
+	size_t n, i;
+
+	TC_PRINT("%s: updating stored trees\n", __func__);
+
+	for (n = 1; n <= MAX_TREE_LEAVES; ++n) {
+		for (i = 0; i < n; ++i) {
+			(void)tc_merkle_leaf(hashes[i], &data[i], 1);
+		}
+		(void)tc_merkle_tree_build(root, nodes, &hashes[0][0], n);
+		(void)tc_merkle_root(expected, &hashes[0][0], n);
+		if (memcmp(root, expected, sizeof(root)) != 0) {
+			TC_ERROR("%s: %u leaves: build differs from "
+				 "tc_merkle_root.\n", __func__, (unsigned int) n);
+			result = TC_FAIL;
+			goto exitTest4;
+		}
+
+		for (i = 0; i < n; ++i) {
+			(void)tc_merkle_leaf(hashes[i], &data[i + 100], 1);
+			(void)tc_merkle_tree_update(root, nodes, n, i, hashes[i]);
+			(void)tc_merkle_root(expected, &hashes[0][0], n);
+			if (memcmp(root, expected, sizeof(root)) != 0) {
+				TC_ERROR("%s: %u leaves: update of leaf %u "
+					 "differs from tc_merkle_root.\n",
+					 __func__, (unsigned int) n,
+					 (unsigned int) i);
+				result = TC_FAIL;
+				goto exitTest4;
+			}
+		}
+	}
+
+	if (tc_merkle_tree_build(root, nodes, &hashes[0][0], 0) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_merkle_tree_update(root, nodes, 4, 4, hashes[0]) !=
+	    TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: invalid arguments accepted.\n", __func__);
+		result = TC_FAIL;
+	}
+
+ exitTest4:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test the Merkle tree hash
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing Merkle tree tests:");
+
+	fill_data();
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle tree test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle tree test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle tree test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle tree test #4 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All Merkle tree tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
@@ -0,0 +1,220 @@
+/* test_merkle_parallel.c - TinyCrypt implementation of some multi-threaded Merkle tree tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following multi-threaded Merkle tree routines:
+ *
+ * Scenarios tested include:
+ * - Root identical to tc_merkle_update and tc_merkle_final for several
+ *   lengths and thread counts
+ * - Leaf hashes identical to tc_merkle_leaf
+ * - Input checks
+ */
+
+#include <tinycrypt/merkle_parallel.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_LEAVES (1001)
+#define DATA_SIZE (MAX_LEAVES * TC_MERKLE_LEAF_SIZE)
+
+static uint8_t data[DATA_SIZE];
+static uint8_t hashes[MAX_LEAVES][TC_SHA256_DIGEST_SIZE];
+
+static const size_t lengths[] = {
+	0, 1, TC_MERKLE_LEAF_SIZE,
+	TC_MERKLE_PARALLEL_MIN_LEAVES * TC_MERKLE_LEAF_SIZE,
+	TC_MERKLE_PARALLEL_MIN_LEAVES * TC_MERKLE_LEAF_SIZE + 1,
+	3 * TC_MERKLE_PARALLEL_MIN_LEAVES * TC_MERKLE_LEAF_SIZE + 5,
+	(MAX_LEAVES - 1) * TC_MERKLE_LEAF_SIZE + 7
+};
+static const unsigned int thread_counts[] = { 1, 2, 3, 4, 8 };
+
+static void fill(void)
+{
+	size_t i;
+
+	for (i = 0; i < DATA_SIZE; ++i) {
+		data[i] = (uint8_t) (i * 7 + (i >> 11));
+	}
+}
+
+/*
+ * Roots computed on several threads match the single-threaded ones.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_merkle_struct t;
+	uint8_t expected[TC_SHA256_DIGEST_SIZE];
+	uint8_t root[TC_SHA256_DIGEST_SIZE];
+	unsigned int i, j;
+
+	TC_PRINT("%s: roots on several threads\n", __func__);
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		(void)tc_merkle_init(&t);
+		(void)tc_merkle_update(&t, data, lengths[i]);
+		(void)tc_merkle_final(expected, &t);
+
+		for (j = 0; j < sizeof(thread_counts) / sizeof(thread_counts[0]);
+		     ++j) {
+			if (tc_merkle_root_parallel(root, data, lengths[i],
+						    thread_counts[j]) !=
+			    TC_CRYPTO_SUCCESS ||
+			    memcmp(root, expected, sizeof(root)) != 0) {
+				TC_ERROR("%s: %u bytes on %u threads differ "
+					 "from tc_merkle_final.\n", __func__,
+					 (unsigned int) lengths[i],
+					 thread_counts[j]);
+				result = TC_FAIL;
+				goto exitTest1;
+			}
+		}
+	}
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Leaf hashes computed on several threads match tc_merkle_leaf.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t expected[TC_SHA256_DIGEST_SIZE];
+	size_t len = (MAX_LEAVES - 1) * TC_MERKLE_LEAF_SIZE + 7;
+	size_t k, n;
+	unsigned int j;
+
+	TC_PRINT("%s: leaf hashes on several threads\n", __func__);
+
+	for (j = 0; j < sizeof(thread_counts) / sizeof(thread_counts[0]); ++j) {
+		memset(hashes, 0, sizeof(hashes));
+		if (tc_merkle_leaves_parallel(&hashes[0][0], data, len,
+					      thread_counts[j]) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("%s: tc_merkle_leaves_parallel failed.\n",
+				 __func__);
+			result = TC_FAIL;
+			goto exitTest2;
+		}
+		for (k = 0; k < MAX_LEAVES; ++k) {
+			n = len - k * TC_MERKLE_LEAF_SIZE;
+			if (n > TC_MERKLE_LEAF_SIZE) {
+				n = TC_MERKLE_LEAF_SIZE;
+			}
+			(void)tc_merkle_leaf(expected,
+					     &data[k * TC_MERKLE_LEAF_SIZE], n);
+			if (memcmp(hashes[k], expected, sizeof(expected)) != 0) {
+				TC_ERROR("%s: leaf %u on %u threads differs "
+					 "from tc_merkle_leaf.\n", __func__,
+					 (unsigned int) k, thread_counts[j]);
+				result = TC_FAIL;
+				goto exitTest2;
+			}
+		}
+	}
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Invalid arguments are rejected.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t root[TC_SHA256_DIGEST_SIZE];
+
+	TC_PRINT("%s: input checks\n", __func__);
+
+	if (tc_merkle_root_parallel((uint8_t *) 0, data, 1, 2) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_merkle_root_parallel(root, (const uint8_t *) 0, 1, 2) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_merkle_root_parallel(root, data, 1, 0) != TC_CRYPTO_FAIL ||
+	    tc_merkle_leaves_parallel((uint8_t *) 0, data, 1, 2) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_merkle_leaves_parallel(&hashes[0][0], data, 0, 2) !=
+	    TC_CRYPTO_FAIL) {
+		TC_ERROR("%s: invalid arguments accepted.\n", __func__);
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test the multi-threaded Merkle tree hash
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing multi-threaded Merkle tree tests:");
+
+	fill();
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle parallel test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle parallel test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Merkle parallel test #3 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All multi-threaded Merkle tree tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
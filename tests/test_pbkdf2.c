@@ -0,0 +1,192 @@
+/* test_pbkdf2.c - TinyCrypt implementation of some PBKDF2 tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following PBKDF2-HMAC-SHA256 routines:
+ *
+ * Scenarios tested include:
+ * - RFC 7914 section 11 vectors (two output blocks)
+ * - A partial output block and a single block derived on its own
+ * - The empty password
+ */
+
+#include <tinycrypt/pbkdf2.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/* derives expectedlen bytes and checks them against expected */
+static unsigned int do_test(unsigned int testnum, const char *password,
+			    const char *salt, unsigned int iterations,
+			    const uint8_t *expected, size_t expectedlen)
+{
+	uint8_t out[64];
+
+	if (tc_pbkdf2_sha256(out, expectedlen, (const uint8_t *) password,
+			     strlen(password), (const uint8_t *) salt,
+			     strlen(salt), iterations) == 0) {
+		TC_ERROR("tc_pbkdf2_sha256 failed.\n");
+		return TC_FAIL;
+	}
+
+	return check_result(testnum, expected, expectedlen, out, expectedlen);
+}
+
+/*
+ * RFC 7914 section 11 PBKDF2-HMAC-SHA256 vectors.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t expected_1[64] = {
+		0x55, 0xac, 0x04, 0x6e, 0x56, 0xe3, 0x08, 0x9f, 0xec, 0x16, 0x91, 0xc2,
+		0x25, 0x44, 0xb6, 0x05, 0xf9, 0x41, 0x85, 0x21, 0x6d, 0xde, 0x04, 0x65,
+		0xe6, 0x8b, 0x9d, 0x57, 0xc2, 0x0d, 0xac, 0xbc, 0x49, 0xca, 0x9c, 0xcc,
+		0xf1, 0x79, 0xb6, 0x45, 0x99, 0x16, 0x64, 0xb3, 0x9d, 0x77, 0xef, 0x31,
+		0x7c, 0x71, 0xb8, 0x45, 0xb1, 0xe3, 0x0b, 0xd5, 0x09, 0x11, 0x20, 0x41,
+		0xd3, 0xa1, 0x97, 0x83
+	};
+	const uint8_t expected_80000[64] = {
+		0x4d, 0xdc, 0xd8, 0xf6, 0x0b, 0x98, 0xbe, 0x21, 0x83, 0x0c, 0xee, 0x5e,
+		0xf2, 0x27, 0x01, 0xf9, 0x64, 0x1a, 0x44, 0x18, 0xd0, 0x4c, 0x04, 0x14,
+		0xae, 0xff, 0x08, 0x87, 0x6b, 0x34, 0xab, 0x56, 0xa1, 0xd4, 0x25, 0xa1,
+		0x22, 0x58, 0x33, 0x54, 0x9a, 0xdb, 0x84, 0x1b, 0x51, 0xc9, 0xb3, 0x17,
+		0x6a, 0x27, 0x2b, 0xde, 0xbb, 0xa1, 0xd0, 0x78, 0x47, 0x8f, 0x62, 0xb3,
+		0x97, 0xf3, 0x3c, 0x8d
+	};
+
+	TC_PRINT("PBKDF2 %s:\n", __func__);
+
+	result = do_test(1, "passwd", "salt", 1,
+			 expected_1, sizeof(expected_1));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+	result = do_test(1, "Password", "NaCl", 80000,
+			 expected_80000, sizeof(expected_80000));
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * A partial output block, and the second block of the RFC 7914 vector
+ * derived on its own.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t expected_4096[20] = {
+		0xc5, 0xe4, 0x78, 0xd5, 0x92, 0x88, 0xc8, 0x41, 0xaa, 0x53, 0x0d, 0xb6,
+		0x84, 0x5c, 0x4c, 0x8d, 0x96, 0x28, 0x93, 0xa0
+	};
+	const uint8_t expected_block_2[32] = {
+		0x49, 0xca, 0x9c, 0xcc, 0xf1, 0x79, 0xb6, 0x45, 0x99, 0x16, 0x64, 0xb3,
+		0x9d, 0x77, 0xef, 0x31, 0x7c, 0x71, 0xb8, 0x45, 0xb1, 0xe3, 0x0b, 0xd5,
+		0x09, 0x11, 0x20, 0x41, 0xd3, 0xa1, 0x97, 0x83
+	};
+	uint8_t block[32];
+
+	TC_PRINT("PBKDF2 %s:\n", __func__);
+
+	result = do_test(2, "password", "salt", 4096,
+			 expected_4096, sizeof(expected_4096));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+
+	(void)tc_pbkdf2_sha256_block(block, (const uint8_t *) "passwd", 6,
+				     (const uint8_t *) "salt", 4, 1, 2);
+	result = check_result(2, expected_block_2, sizeof(expected_block_2),
+			      block, sizeof(block));
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * The empty password, which tc_hmac_set_key alone would reject.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t expected[20] = {
+		0x62, 0x38, 0x44, 0x66, 0x26, 0x4d, 0xaa, 0xdc, 0x41, 0x44, 0x01, 0x8c,
+		0x6b, 0xd8, 0x64, 0x64, 0x82, 0x72, 0xb3, 0x4d
+	};
+
+	TC_PRINT("PBKDF2 %s:\n", __func__);
+
+	result = do_test(3, "", "salt", 2, expected, sizeof(expected));
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test PBKDF2
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing PBKDF2-HMAC-SHA256 tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("PBKDF2 test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("PBKDF2 test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("PBKDF2 test #3 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All PBKDF2 tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
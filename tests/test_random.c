@@ -0,0 +1,277 @@
+/* test_random.c - TinyCrypt implementation of some PRNG pool tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following per-thread PRNG pool routines:
+ *
+ * Scenarios tested include:
+ * - Input checks, consecutive outputs and requests of several chunks
+ * - Distinct outputs in concurrent threads
+ * - Distinct outputs in a parent and its forked child
+ * - Re-instantiation after tc_random_erase
+ */
+
+#include <tinycrypt/random.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+
+/*
+ * Input checks, two consecutive outputs and a request larger than a
+ * generate call can serve.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	const size_t large_size = (1U << 20) + 1;
+	uint8_t out1[32], out2[32];
+	uint8_t *large;
+	uint8_t zero = 0;
+	size_t i;
+
+	TC_PRINT("Random %s:\n", __func__);
+
+	if (tc_random_bytes((uint8_t *) 0, 0) != TC_CRYPTO_SUCCESS ||
+	    tc_random_bytes((uint8_t *) 0, 1) != TC_CRYPTO_FAIL) {
+		TC_ERROR("tc_random_bytes input checks failed.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	if (tc_random_bytes(out1, sizeof(out1)) != TC_CRYPTO_SUCCESS ||
+	    tc_random_bytes(out2, sizeof(out2)) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out1, out2, sizeof(out1)) == 0) {
+		TC_ERROR("tc_random_bytes repeated its output.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	large = malloc(large_size);
+	if (large == (uint8_t *) 0) {
+		TC_ERROR("malloc failed.\n");
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+	if (tc_random_bytes(large, large_size) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_random_bytes failed on %zu bytes.\n", large_size);
+		result = TC_FAIL;
+	} else {
+		/* the tail, filled by the last generate call, must be set */
+		for (i = large_size - 32; i < large_size; ++i) {
+			zero |= large[i];
+		}
+		if (zero == 0) {
+			TC_ERROR("tc_random_bytes left the tail unset.\n");
+			result = TC_FAIL;
+		}
+	}
+	free(large);
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+static void *draw(void *out)
+{
+	uintptr_t ok = tc_random_bytes((uint8_t *) out, 32) ==
+		       TC_CRYPTO_SUCCESS;
+
+	return (void *) ok;
+}
+
+/*
+ * Each thread gets its own instance: the outputs of concurrent threads and
+ * of the main thread must all differ.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t out[NUM_THREADS + 1][32];
+	pthread_t threads[NUM_THREADS];
+	void *ok;
+	unsigned int i, j;
+
+	TC_PRINT("Random %s:\n", __func__);
+
+	for (i = 0; i < NUM_THREADS; ++i) {
+		if (pthread_create(&threads[i], (const pthread_attr_t *) 0,
+				   &draw, out[i]) != 0) {
+			TC_ERROR("pthread_create failed.\n");
+			result = TC_FAIL;
+			goto exitTest2;
+		}
+	}
+	for (i = 0; i < NUM_THREADS; ++i) {
+		if (pthread_join(threads[i], &ok) != 0 || ok == (void *) 0) {
+			result = TC_FAIL;
+		}
+	}
+	if (result == TC_FAIL ||
+	    tc_random_bytes(out[NUM_THREADS], 32) != TC_CRYPTO_SUCCESS) {
+		TC_ERROR("tc_random_bytes failed in a thread.\n");
+		result = TC_FAIL;
+		goto exitTest2;
+	}
+
+	for (i = 0; i <= NUM_THREADS; ++i) {
+		for (j = i + 1; j <= NUM_THREADS; ++j) {
+			if (memcmp(out[i], out[j], 32) == 0) {
+				TC_ERROR("threads %u and %u got the same "
+					 "bytes.\n", i, j);
+				result = TC_FAIL;
+				goto exitTest2;
+			}
+		}
+	}
+
+exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * A forked child inherits the instance of its parent, but must not repeat
+ * the output of its parent.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t parent[32], child[32];
+	int fds[2];
+	pid_t pid;
+
+	TC_PRINT("Random %s:\n", __func__);
+
+	if (tc_random_bytes(parent, 1) != TC_CRYPTO_SUCCESS || pipe(fds) != 0) {
+		TC_ERROR("test setup failed.\n");
+		result = TC_FAIL;
+		goto exitTest3;
+	}
+
+	pid = fork();
+	if (pid == 0) {
+		int ok = tc_random_bytes(child, sizeof(child)) &&
+			 write(fds[1], child, sizeof(child)) ==
+			 (ssize_t) sizeof(child);
+		_exit(ok ? 0 : 1);
+	}
+	close(fds[1]);
+	if (pid < 0 ||
+	    tc_random_bytes(parent, sizeof(parent)) != TC_CRYPTO_SUCCESS ||
+	    read(fds[0], child, sizeof(child)) != (ssize_t) sizeof(child)) {
+		TC_ERROR("tc_random_bytes failed across fork().\n");
+		result = TC_FAIL;
+	} else if (memcmp(parent, child, sizeof(parent)) == 0) {
+		TC_ERROR("the child repeated the output of its parent.\n");
+		result = TC_FAIL;
+	}
+	close(fds[0]);
+	if (pid > 0) {
+		(void)waitpid(pid, (int *) 0, 0);
+	}
+
+exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * After tc_random_erase, the next call creates a new instance.
+ */
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+	uint8_t out1[32], out2[32];
+
+	TC_PRINT("Random %s:\n", __func__);
+
+	(void)tc_random_bytes(out1, sizeof(out1));
+	(void)tc_random_erase();
+	if (tc_random_bytes(out2, sizeof(out2)) != TC_CRYPTO_SUCCESS ||
+	    memcmp(out1, out2, sizeof(out1)) == 0) {
+		TC_ERROR("tc_random_bytes failed after tc_random_erase.\n");
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test the PRNG pool
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing per-thread PRNG pool tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Random test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Random test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Random test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Random test #4 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All PRNG pool tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
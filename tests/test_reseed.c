@@ -0,0 +1,429 @@
+/* test_reseed.c - TinyCrypt implementation of some reseed manager tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following reseed manager routines:
+ *
+ * Scenarios tested include:
+ * - Periodic reseeds of an HMAC-PRNG with prefetched entropy
+ * - Prediction resistance (a synchronous reseed before every generate call)
+ * - Reseeds of a CTR-PRNG
+ * - Generate calls not waiting for a slow entropy source
+ * - Registration limits, unregistration and input checks
+ * - Stopping the manager while a failing fetch is in progress
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <tinycrypt/reseed.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* delay of the test entropy source, in milliseconds */
+static volatile unsigned int entropy_delay_ms;
+
+static void sleep_ms(unsigned int ms)
+{
+	struct timespec t;
+
+	t.tv_sec = ms / 1000;
+	t.tv_nsec = (long)(ms % 1000) * 1000000L;
+	(void)nanosleep(&t, (struct timespec *) 0);
+}
+
+/* a fake entropy source: a counter, possibly slow */
+static int test_entropy(uint8_t *dest, unsigned int size)
+{
+	static volatile uint8_t counter;
+	unsigned int i;
+
+	if (entropy_delay_ms) {
+		sleep_ms(entropy_delay_ms);
+	}
+	for (i = 0; i < size; ++i) {
+		dest[i] = counter++;
+	}
+	return 1;
+}
+
+/* a failing entropy source, slow enough to be stopped while fetching */
+static int failing_entropy(uint8_t *dest, unsigned int size)
+{
+	(void)dest;
+	(void)size;
+	sleep_ms(200);
+	return 0;
+}
+
+/* waits up to 2 seconds for the background thread to prefetch entropy */
+static int wait_ready(TCReseedManager_t m, TCReseedEntry_t e)
+{
+	unsigned int i;
+	int ready = 0;
+
+	for (i = 0; i < 2000 && !ready; ++i) {
+		(void)pthread_mutex_lock(&m->lock);
+		ready = e->ready;
+		(void)pthread_mutex_unlock(&m->lock);
+		if (!ready) {
+			sleep_ms(1);
+		}
+	}
+	return ready;
+}
+
+/*
+ * An HMAC-PRNG registered right after tc_hmac_prng_init (so it cannot
+ * generate yet) with an interval of 4 is reseeded on calls 1, 5, 9, 13 and
+ * 17, always with prefetched entropy when the test waits for it.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_reseed_manager_struct m;
+	struct tc_reseed_entry_struct entries[2];
+	struct tc_hmac_prng_struct prng;
+	const uint8_t personalization[] = "test_1";
+	uint8_t out[32];
+	TCReseedEntry_t e;
+	unsigned int i;
+
+	TC_PRINT("Reseed %s:\n", __func__);
+
+	entropy_delay_ms = 0;
+	(void)tc_reseed_manager_start(&m, entries, 2, &test_entropy);
+	(void)tc_hmac_prng_init(&prng, personalization,
+				sizeof(personalization));
+	e = tc_reseed_register_hmac_prng(&m, &prng, 4);
+
+	for (i = 0; i < 17; ++i) {
+		if (!wait_ready(&m, e) ||
+		    tc_reseed_hmac_prng_generate(&m, e, out, sizeof(out)) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("generate call %u failed.\n", i + 1);
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+	if (e->reseeds != 5 || e->sync_reseeds != 0) {
+		TC_ERROR("expected 5 prefetched reseeds, got %u and %u "
+			 "synchronous ones.\n", (unsigned int) e->reseeds,
+			 (unsigned int) e->sync_reseeds);
+		result = TC_FAIL;
+	}
+
+exitTest1:
+	(void)tc_reseed_manager_stop(&m);
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * With an interval of 1 (prediction resistance), every generate call
+ * reseeds with entropy fetched during the call, never with prefetched
+ * entropy.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_reseed_manager_struct m;
+	struct tc_reseed_entry_struct entries[1];
+	struct tc_hmac_prng_struct prng;
+	const uint8_t personalization[] = "test_2";
+	uint8_t out[32];
+	TCReseedEntry_t e;
+	unsigned int i;
+
+	TC_PRINT("Reseed %s:\n", __func__);
+
+	entropy_delay_ms = 0;
+	(void)tc_reseed_manager_start(&m, entries, 1, &test_entropy);
+	(void)tc_hmac_prng_init(&prng, personalization,
+				sizeof(personalization));
+	e = tc_reseed_register_hmac_prng(&m, &prng, 1);
+
+	for (i = 0; i < 10; ++i) {
+		/* give the background thread time to (wrongly) prefetch */
+		sleep_ms(5);
+		if (tc_reseed_hmac_prng_generate(&m, e, out, sizeof(out)) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("generate call %u failed.\n", i + 1);
+			result = TC_FAIL;
+			goto exitTest2;
+		}
+	}
+	if (e->sync_reseeds != 10 || e->reseeds != 0 || e->ready) {
+		TC_ERROR("expected 10 synchronous reseeds, got %u and %u "
+			 "prefetched ones.\n", (unsigned int) e->sync_reseeds,
+			 (unsigned int) e->reseeds);
+		result = TC_FAIL;
+	}
+
+exitTest2:
+	(void)tc_reseed_manager_stop(&m);
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * A CTR-PRNG with an interval of 2 is reseeded on every second call.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_reseed_manager_struct m;
+	struct tc_reseed_entry_struct entries[1];
+	TCCtrPrng_t prng;
+	uint8_t seed[32] = { 0 };
+	uint8_t out[32];
+	TCReseedEntry_t e;
+	unsigned int i;
+
+	TC_PRINT("Reseed %s:\n", __func__);
+
+	entropy_delay_ms = 0;
+	(void)tc_reseed_manager_start(&m, entries, 1, &test_entropy);
+	(void)tc_ctr_prng_init(&prng, seed, sizeof(seed), 0, 0);
+	e = tc_reseed_register_ctr_prng(&m, &prng, 2);
+
+	for (i = 0; i < 10; ++i) {
+		if (!wait_ready(&m, e) ||
+		    tc_reseed_ctr_prng_generate(&m, e, 0, 0, out, sizeof(out)) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("generate call %u failed.\n", i + 1);
+			result = TC_FAIL;
+			goto exitTest3;
+		}
+	}
+	if (e->reseeds != 5 || e->sync_reseeds != 0) {
+		TC_ERROR("expected 5 prefetched reseeds, got %u and %u "
+			 "synchronous ones.\n", (unsigned int) e->reseeds,
+			 (unsigned int) e->sync_reseeds);
+		result = TC_FAIL;
+	}
+
+exitTest3:
+	(void)tc_reseed_manager_stop(&m);
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * With a slow entropy source, due reseeds are postponed instead of making
+ * the generate calls wait.
+ */
+unsigned int test_4(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_reseed_manager_struct m;
+	struct tc_reseed_entry_struct entries[1];
+	struct tc_hmac_prng_struct prng;
+	const uint8_t personalization[] = "test_4";
+	uint8_t seed[TC_RESEED_ENTROPY_SIZE] = { 0 };
+	uint8_t out[32];
+	TCReseedEntry_t e;
+	unsigned int i;
+
+	TC_PRINT("Reseed %s:\n", __func__);
+
+	entropy_delay_ms = 500;
+	(void)tc_reseed_manager_start(&m, entries, 1, &test_entropy);
+	(void)tc_hmac_prng_init(&prng, personalization,
+				sizeof(personalization));
+	(void)tc_hmac_prng_reseed(&prng, seed, sizeof(seed), 0, 0);
+	e = tc_reseed_register_hmac_prng(&m, &prng, 2);
+	/* let the background thread start its slow fetch */
+	sleep_ms(50);
+
+	for (i = 0; i < 10; ++i) {
+		if (tc_reseed_hmac_prng_generate(&m, e, out, sizeof(out)) !=
+		    TC_CRYPTO_SUCCESS) {
+			TC_ERROR("generate call %u failed.\n", i + 1);
+			result = TC_FAIL;
+			goto exitTest4;
+		}
+	}
+	if (e->sync_reseeds != 0 || e->reseeds != 0) {
+		TC_ERROR("a generate call waited for the entropy source.\n");
+		result = TC_FAIL;
+	}
+
+exitTest4:
+	(void)tc_reseed_manager_stop(&m);
+	entropy_delay_ms = 0;
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Registration limits, unregistration and input checks.
+ */
+unsigned int test_5(void)
+{
+	unsigned int result = TC_PASS;
+	struct tc_reseed_manager_struct m;
+	struct tc_reseed_entry_struct entries[1];
+	struct tc_hmac_prng_struct prng;
+	TCCtrPrng_t ctr_prng;
+	uint8_t out[32];
+	TCReseedEntry_t e;
+
+	TC_PRINT("Reseed %s:\n", __func__);
+
+	if (tc_reseed_manager_start(&m, entries, 0, &test_entropy) !=
+	    TC_CRYPTO_FAIL ||
+	    tc_reseed_manager_start(&m, entries, 1, (TCReseedEntropy_t) 0) !=
+	    TC_CRYPTO_FAIL) {
+		TC_ERROR("tc_reseed_manager_start input checks failed.\n");
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+
+	(void)tc_reseed_manager_start(&m, entries, 1, &test_entropy);
+	e = tc_reseed_register_hmac_prng(&m, &prng, 1);
+	if (e == (TCReseedEntry_t) 0 ||
+	    tc_reseed_register_ctr_prng(&m, &ctr_prng, 1) !=
+	    (TCReseedEntry_t) 0 ||
+	    tc_reseed_register_hmac_prng(&m, &prng, 0) != (TCReseedEntry_t) 0) {
+		TC_ERROR("registration checks failed.\n");
+		result = TC_FAIL;
+	} else if (tc_reseed_ctr_prng_generate(&m, e, 0, 0, out,
+					       sizeof(out)) != TC_CRYPTO_FAIL) {
+		TC_ERROR("generate accepted a PRNG of the wrong type.\n");
+		result = TC_FAIL;
+	} else if (tc_reseed_unregister(&m, e) != TC_CRYPTO_SUCCESS ||
+		   tc_reseed_register_ctr_prng(&m, &ctr_prng, 1) != e) {
+		TC_ERROR("unregistration did not free the entry.\n");
+		result = TC_FAIL;
+	}
+	(void)tc_reseed_manager_stop(&m);
+
+exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * tc_reseed_manager_stop called while the background thread is fetching
+ * from a failing entropy source must return: the thread must not wait for
+ * a wakeup that was signalled during the fetch. The manager runs in a child
+ * process killed after 5 seconds, so that a hang fails the test.
+ */
+unsigned int test_6(void)
+{
+	unsigned int result = TC_PASS;
+	int status = 0;
+	pid_t pid;
+
+	TC_PRINT("Reseed %s:\n", __func__);
+
+	pid = fork();
+	if (pid == 0) {
+		struct tc_reseed_manager_struct m;
+		struct tc_reseed_entry_struct entries[1];
+		struct tc_hmac_prng_struct prng;
+
+		(void)alarm(5);
+		(void)tc_reseed_manager_start(&m, entries, 1,
+					      &failing_entropy);
+		(void)tc_reseed_register_hmac_prng(&m, &prng, 2);
+		/* let the background thread start its failing fetch */
+		sleep_ms(50);
+		(void)tc_reseed_manager_stop(&m);
+		_exit(0);
+	}
+	if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+	    !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		TC_ERROR("tc_reseed_manager_stop hung after a failed fetch.\n");
+		result = TC_FAIL;
+	}
+
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test the reseed manager
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing reseed manager tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Reseed test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Reseed test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Reseed test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Reseed test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Reseed test #5 failed.\n");
+		goto exitTest;
+	}
+	result = test_6();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("Reseed test #6 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All reseed manager tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
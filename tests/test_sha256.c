@@ -407,6 +407,240 @@ unsigned int test_14(void)
         return result;
 }
 
+/*
+ * NIST SHA256 test vector 2, with the message scattered in segments.
+ */
+unsigned int test_15(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #15 (scatter-gather):\n");
+        const uint8_t expected[32] = {
+		0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93,
+		0x0c, 0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+		0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+        };
+        const char *m = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+        const struct tc_iovec iov[] = {
+                {m, 3}, {(const void *) 0, 0}, {m + 3, 50}, {m + 53, 3}
+        };
+        uint8_t digest[32];
+        struct tc_sha256_state_struct s;
+
+        (void)tc_sha256_init(&s);
+        if (tc_sha256_update_v(&s, iov, sizeof(iov) / sizeof(iov[0])) == 0) {
+                TC_ERROR("tc_sha256_update_v failed in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest15;
+        }
+        (void)tc_sha256_final(digest, &s);
+
+        result = check_result(15, expected, sizeof(expected),
+			      digest, sizeof(digest));
+exitTest15:
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * Fixed-size and double SHA-256 (reference digests from the generic code).
+ */
+unsigned int test_16(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #16 (fixed-size inputs):\n");
+        const uint8_t expected_32[32] = {
+		0x63, 0x0d, 0xcd, 0x29, 0x66, 0xc4, 0x33, 0x66, 0x91, 0x12, 0x54, 0x48,
+		0xbb, 0xb2, 0x5b, 0x4f, 0xf4, 0x12, 0xa4, 0x9c, 0x73, 0x2d, 0xb2, 0xc8,
+		0xab, 0xc1, 0xb8, 0x58, 0x1b, 0xd7, 0x10, 0xdd
+        };
+        const uint8_t expected_64[32] = {
+		0xfd, 0xea, 0xb9, 0xac, 0xf3, 0x71, 0x03, 0x62, 0xbd, 0x26, 0x58, 0xcd,
+		0xc9, 0xa2, 0x9e, 0x8f, 0x9c, 0x75, 0x7f, 0xcf, 0x98, 0x11, 0x60, 0x3a,
+		0x8c, 0x44, 0x7c, 0xd1, 0xd9, 0x15, 0x11, 0x08
+        };
+        const uint8_t expected_d[32] = {
+		0x4f, 0x8b, 0x42, 0xc2, 0x2d, 0xd3, 0x72, 0x9b, 0x51, 0x9b, 0xa6, 0xf6,
+		0x8d, 0x2d, 0xa7, 0xcc, 0x5b, 0x2d, 0x60, 0x6d, 0x05, 0xda, 0xed, 0x5a,
+		0xd5, 0x12, 0x8c, 0xc0, 0x3e, 0x6c, 0x63, 0x58
+        };
+        const char *m = "abc";
+        uint8_t data[64];
+        uint8_t digest[32];
+        unsigned int i;
+
+        for (i = 0; i < sizeof(data); ++i) {
+                data[i] = (uint8_t) i;
+        }
+
+        (void)tc_sha256_32(digest, data);
+        result = check_result(16, expected_32, sizeof(expected_32),
+			      digest, sizeof(digest));
+        if (result == TC_FAIL) {
+                goto exitTest16;
+        }
+
+        (void)tc_sha256_64(digest, data);
+        result = check_result(16, expected_64, sizeof(expected_64),
+			      digest, sizeof(digest));
+        if (result == TC_FAIL) {
+                goto exitTest16;
+        }
+
+        /* in place, as when walking up a tree of digests */
+        (void)tc_sha256_64(data, data);
+        result = check_result(16, expected_64, sizeof(expected_64),
+			      data, sizeof(digest));
+        if (result == TC_FAIL) {
+                goto exitTest16;
+        }
+
+        (void)tc_sha256d(digest, (const uint8_t *) m, strlen(m));
+        result = check_result(16, expected_d, sizeof(expected_d),
+			      digest, sizeof(digest));
+exitTest16:
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * Clone, export and import of a state that has hashed a common prefix.
+ */
+unsigned int test_17(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #17 (midstate export/import):\n");
+        const char *suffix[2] = { "first message", "second message" };
+        uint8_t prefix[100];
+        uint8_t blob[TC_SHA256_EXPORT_SIZE];
+        uint8_t blob2[TC_SHA256_EXPORT_SIZE];
+        uint8_t expected[32];
+        uint8_t digest[32];
+        struct tc_sha256_state_struct s, c;
+        unsigned int i;
+
+        for (i = 0; i < sizeof(prefix); ++i) {
+                prefix[i] = (uint8_t)(0xa5 ^ i);
+        }
+
+        (void)tc_sha256_init(&s);
+        (void)tc_sha256_update(&s, prefix, sizeof(prefix));
+        (void)tc_sha256_export(blob, sizeof(blob), &s);
+
+        /* version, one block counted in bits, 36 bytes buffered */
+        if (blob[0] != TC_SHA256_EXPORT_VERSION ||
+            blob[1 + 32 + 6] != 0x02 || blob[1 + 32 + 7] != 0x00 ||
+            blob[1 + 32 + 8] != 36) {
+                TC_ERROR("unexpected export layout in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest17;
+        }
+
+        for (i = 0; i < 2; ++i) {
+                /* reference: the whole message through one state */
+                (void)tc_sha256_init(&c);
+                (void)tc_sha256_update(&c, prefix, sizeof(prefix));
+                (void)tc_sha256_update(&c, (const uint8_t *) suffix[i],
+                                       strlen(suffix[i]));
+                (void)tc_sha256_final(expected, &c);
+
+                (void)tc_sha256_clone(&c, &s);
+                (void)tc_sha256_update(&c, (const uint8_t *) suffix[i],
+                                       strlen(suffix[i]));
+                (void)tc_sha256_final(digest, &c);
+                result = check_result(17, expected, sizeof(expected),
+				      digest, sizeof(digest));
+                if (result == TC_FAIL) {
+                        goto exitTest17;
+                }
+
+                if (tc_sha256_import(&c, blob, sizeof(blob)) == 0) {
+                        TC_ERROR("tc_sha256_import failed in %s.\n", __func__);
+                        result = TC_FAIL;
+                        goto exitTest17;
+                }
+                (void)tc_sha256_export(blob2, sizeof(blob2), &c);
+                result = check_result(17, blob, sizeof(blob),
+				      blob2, sizeof(blob2));
+                if (result == TC_FAIL) {
+                        goto exitTest17;
+                }
+                (void)tc_sha256_update(&c, (const uint8_t *) suffix[i],
+                                       strlen(suffix[i]));
+                (void)tc_sha256_final(digest, &c);
+                result = check_result(17, expected, sizeof(expected),
+				      digest, sizeof(digest));
+                if (result == TC_FAIL) {
+                        goto exitTest17;
+                }
+        }
+
+        /* unknown version and overlong buffer must be rejected */
+        memcpy(blob2, blob, sizeof(blob));
+        blob2[0] = TC_SHA256_EXPORT_VERSION + 1;
+        if (tc_sha256_import(&c, blob2, sizeof(blob2)) != 0) {
+                TC_ERROR("bad version accepted in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest17;
+        }
+        memcpy(blob2, blob, sizeof(blob));
+        blob2[1 + 32 + 8] = TC_SHA256_BLOCK_SIZE;
+        if (tc_sha256_import(&c, blob2, sizeof(blob2)) != 0) {
+                TC_ERROR("bad leftover accepted in %s.\n", __func__);
+                result = TC_FAIL;
+        }
+exitTest17:
+        TC_END_RESULT(result);
+        return result;
+}
+
+/*
+ * Completing a block-aligned midstate with 32 bytes.
+ */
+unsigned int test_18(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #18 (32-byte midstate completion):\n");
+        uint8_t data[128 + 32];
+        uint8_t expected[32];
+        uint8_t digest[32];
+        struct tc_sha256_state_struct s, mid;
+        unsigned int i;
+
+        for (i = 0; i < sizeof(data); ++i) {
+                data[i] = (uint8_t)(3 * i + 1);
+        }
+
+        (void)tc_sha256_init(&s);
+        (void)tc_sha256_update(&s, data, sizeof(data));
+        (void)tc_sha256_final(expected, &s);
+
+        (void)tc_sha256_init(&mid);
+        (void)tc_sha256_update(&mid, data, 128);
+        (void)tc_sha256_midstate_32(digest, &mid, &data[128]);
+        result = check_result(18, expected, sizeof(expected),
+			      digest, sizeof(digest));
+        if (result == TC_FAIL) {
+                goto exitTest18;
+        }
+
+        /* mid is unchanged and can be completed again */
+        (void)tc_sha256_midstate_32(digest, &mid, &data[128]);
+        result = check_result(18, expected, sizeof(expected),
+			      digest, sizeof(digest));
+        if (result == TC_FAIL) {
+                goto exitTest18;
+        }
+
+        (void)tc_sha256_update(&mid, data, 1);
+        if (tc_sha256_midstate_32(digest, &mid, &data[128]) != 0) {
+                TC_ERROR("unaligned midstate accepted in %s.\n", __func__);
+                result = TC_FAIL;
+        }
+exitTest18:
+        TC_END_RESULT(result);
+        return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -501,6 +735,30 @@ int main(void)
                 TC_ERROR("SHA256 test #14 failed.\n");
                 goto exitTest;
         }
+        result = test_15();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #15 failed.\n");
+                goto exitTest;
+        }
+        result = test_16();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #16 failed.\n");
+                goto exitTest;
+        }
+        result = test_17();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #17 failed.\n");
+                goto exitTest;
+        }
+        result = test_18();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #18 failed.\n");
+                goto exitTest;
+        }
 
         TC_PRINT("All SHA256 tests succeeded!\n");
 
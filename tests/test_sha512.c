@@ -0,0 +1,259 @@
+/* test_sha512.c - TinyCrypt implementation of some SHA-512 tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following SHA-512 routines:
+ *
+ * Scenarios tested include:
+ * - SHA-512, SHA-384 and SHA-512/256 FIPS 180 example vectors
+ * - SHA-512 of the empty string and of one million 'a'
+ * - Updates split across block boundaries
+ */
+
+#include <tinycrypt/sha512.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/* FIPS 180 two-block example message (896 bits) */
+static const char *m896 = "abcdefghbcdefghicdefghijdefghijkefghijkl"
+	"fghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrst"
+	"nopqrstu";
+
+typedef int (*init_t)(TCSha512State_t s);
+
+/* hashes datalen bytes of data and checks the digest against expected */
+static unsigned int do_test(unsigned int testnum, init_t init,
+			    const char *data, size_t datalen,
+			    const uint8_t *expected, size_t expectedlen)
+{
+	struct tc_sha512_state_struct s;
+	uint8_t digest[TC_SHA512_DIGEST_SIZE];
+
+	(void)init(&s);
+	(void)tc_sha512_update(&s, (const uint8_t *) data, datalen);
+	(void)tc_sha512_final(digest, &s);
+
+	return check_result(testnum, expected, expectedlen, digest, expectedlen);
+}
+
+/*
+ * SHA-512 of "abc", of the 896-bit message and of the empty string.
+ */
+unsigned int test_1(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t expected_abc[64] = {
+		0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49,
+		0xae, 0x20, 0x41, 0x31, 0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+		0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a, 0x21, 0x92, 0x99, 0x2a,
+		0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+		0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f,
+		0xa5, 0x4c, 0xa4, 0x9f
+	};
+	const uint8_t expected_896[64] = {
+		0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda, 0x8c, 0xf4, 0xf7, 0x28,
+		0x14, 0xfc, 0x14, 0x3f, 0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1,
+		0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18, 0x50, 0x1d, 0x28, 0x9e,
+		0x49, 0x00, 0xf7, 0xe4, 0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+		0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54, 0x5e, 0x96, 0xe5, 0x5b,
+		0x87, 0x4b, 0xe9, 0x09
+	};
+	const uint8_t expected_empty[64] = {
+		0xcf, 0x83, 0xe1, 0x35, 0x7e, 0xef, 0xb8, 0xbd, 0xf1, 0x54, 0x28, 0x50,
+		0xd6, 0x6d, 0x80, 0x07, 0xd6, 0x20, 0xe4, 0x05, 0x0b, 0x57, 0x15, 0xdc,
+		0x83, 0xf4, 0xa9, 0x21, 0xd3, 0x6c, 0xe9, 0xce, 0x47, 0xd0, 0xd1, 0x3c,
+		0x5d, 0x85, 0xf2, 0xb0, 0xff, 0x83, 0x18, 0xd2, 0x87, 0x7e, 0xec, 0x2f,
+		0x63, 0xb9, 0x31, 0xbd, 0x47, 0x41, 0x7a, 0x81, 0xa5, 0x38, 0x32, 0x7a,
+		0xf9, 0x27, 0xda, 0x3e
+	};
+
+	TC_PRINT("SHA512 %s:\n", __func__);
+
+	result = do_test(1, tc_sha512_init, "abc", 3,
+			 expected_abc, sizeof(expected_abc));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+	result = do_test(1, tc_sha512_init, m896, strlen(m896),
+			 expected_896, sizeof(expected_896));
+	if (result == TC_FAIL) {
+		goto exitTest1;
+	}
+	result = do_test(1, tc_sha512_init, "", 0,
+			 expected_empty, sizeof(expected_empty));
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * SHA-384 and SHA-512/256 of "abc" and of the 896-bit message.
+ */
+unsigned int test_2(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t expected_384_abc[48] = {
+		0xcb, 0x00, 0x75, 0x3f, 0x45, 0xa3, 0x5e, 0x8b, 0xb5, 0xa0, 0x3d, 0x69,
+		0x9a, 0xc6, 0x50, 0x07, 0x27, 0x2c, 0x32, 0xab, 0x0e, 0xde, 0xd1, 0x63,
+		0x1a, 0x8b, 0x60, 0x5a, 0x43, 0xff, 0x5b, 0xed, 0x80, 0x86, 0x07, 0x2b,
+		0xa1, 0xe7, 0xcc, 0x23, 0x58, 0xba, 0xec, 0xa1, 0x34, 0xc8, 0x25, 0xa7
+	};
+	const uint8_t expected_384_896[48] = {
+		0x09, 0x33, 0x0c, 0x33, 0xf7, 0x11, 0x47, 0xe8, 0x3d, 0x19, 0x2f, 0xc7,
+		0x82, 0xcd, 0x1b, 0x47, 0x53, 0x11, 0x1b, 0x17, 0x3b, 0x3b, 0x05, 0xd2,
+		0x2f, 0xa0, 0x80, 0x86, 0xe3, 0xb0, 0xf7, 0x12, 0xfc, 0xc7, 0xc7, 0x1a,
+		0x55, 0x7e, 0x2d, 0xb9, 0x66, 0xc3, 0xe9, 0xfa, 0x91, 0x74, 0x60, 0x39
+	};
+	const uint8_t expected_256_abc[32] = {
+		0x53, 0x04, 0x8e, 0x26, 0x81, 0x94, 0x1e, 0xf9, 0x9b, 0x2e, 0x29, 0xb7,
+		0x6b, 0x4c, 0x7d, 0xab, 0xe4, 0xc2, 0xd0, 0xc6, 0x34, 0xfc, 0x6d, 0x46,
+		0xe0, 0xe2, 0xf1, 0x31, 0x07, 0xe7, 0xaf, 0x23
+	};
+	const uint8_t expected_256_896[32] = {
+		0x39, 0x28, 0xe1, 0x84, 0xfb, 0x86, 0x90, 0xf8, 0x40, 0xda, 0x39, 0x88,
+		0x12, 0x1d, 0x31, 0xbe, 0x65, 0xcb, 0x9d, 0x3e, 0xf8, 0x3e, 0xe6, 0x14,
+		0x6f, 0xea, 0xc8, 0x61, 0xe1, 0x9b, 0x56, 0x3a
+	};
+
+	TC_PRINT("SHA512 %s:\n", __func__);
+
+	result = do_test(2, tc_sha384_init, "abc", 3,
+			 expected_384_abc, sizeof(expected_384_abc));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+	result = do_test(2, tc_sha384_init, m896, strlen(m896),
+			 expected_384_896, sizeof(expected_384_896));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+	result = do_test(2, tc_sha512_256_init, "abc", 3,
+			 expected_256_abc, sizeof(expected_256_abc));
+	if (result == TC_FAIL) {
+		goto exitTest2;
+	}
+	result = do_test(2, tc_sha512_256_init, m896, strlen(m896),
+			 expected_256_896, sizeof(expected_256_896));
+
+ exitTest2:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * SHA-512 of one million 'a', fed in chunks that straddle block boundaries.
+ */
+unsigned int test_3(void)
+{
+	unsigned int result = TC_PASS;
+	const uint8_t expected[64] = {
+		0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7,
+		0xbc, 0x15, 0xb4, 0x63, 0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28,
+		0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb, 0xde, 0x0f, 0xf2, 0x44,
+		0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+		0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17,
+		0xad, 0x8c, 0xc0, 0x9b
+	};
+	struct tc_sha512_state_struct s;
+	uint8_t digest[TC_SHA512_DIGEST_SIZE];
+	uint8_t chunk[1000];
+	size_t left, n;
+
+	TC_PRINT("SHA512 %s:\n", __func__);
+
+	memset(chunk, 'a', sizeof(chunk));
+	(void)tc_sha512_init(&s);
+	/* 1, then 999-byte chunks: the buffer is never empty at a chunk start */
+	(void)tc_sha512_update(&s, chunk, 1);
+	for (left = 1000000 - 1; left > 0; left -= n) {
+		n = left < 999 ? left : 999;
+		(void)tc_sha512_update(&s, chunk, n);
+	}
+	(void)tc_sha512_final(digest, &s);
+	result = check_result(3, expected, sizeof(expected),
+			      digest, sizeof(digest));
+	if (result == TC_FAIL) {
+		goto exitTest3;
+	}
+
+	/* whole chunks: most blocks are hashed straight from the input */
+	(void)tc_sha512_init(&s);
+	for (left = 1000000; left > 0; left -= sizeof(chunk)) {
+		(void)tc_sha512_update(&s, chunk, sizeof(chunk));
+	}
+	(void)tc_sha512_final(digest, &s);
+	result = check_result(3, expected, sizeof(expected),
+			      digest, sizeof(digest));
+
+ exitTest3:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test SHA-512
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing SHA512 tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("SHA512 test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("SHA512 test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("SHA512 test #3 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All SHA512 tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}
@@ -0,0 +1,375 @@
+/* test_xts_mode.c - TinyCrypt implementation of some XTS-AES-128 tests */
+
+/*
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DESCRIPTION
+ * This module tests the following XTS-AES-128 routines:
+ *
+ * Scenarios tested include:
+ * - XTS-AES-128 rejection of identical key1 and key2
+ * - XTS-AES-128 IEEE Std 1619 vectors (full blocks)
+ * - XTS-AES-128 ciphertext stealing
+ * - XTS-AES-128 multi-sector batches
+ */
+
+#include <tinycrypt/xts_mode.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/constants.h>
+#include <test_utils.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define SECTOR_SIZE 512
+#define NUM_SECTORS 3
+
+/*
+ * Encrypts plaintext and checks it against ciphertext, then decrypts it back
+ * in place.
+ */
+static unsigned int do_test(unsigned int testnum, const uint8_t *key1,
+			    const uint8_t *key2, const uint8_t *tweak,
+			    const uint8_t *plaintext, const uint8_t *ciphertext,
+			    unsigned int len, uint8_t *out,
+			    TCAesKeySched_t data_sched,
+			    TCAesKeySched_t tweak_sched)
+{
+	unsigned int result = TC_PASS;
+
+	(void)tc_aes128_set_encrypt_key(tweak_sched, key2);
+	(void)tc_aes128_set_encrypt_key(data_sched, key1);
+	if (tc_xts_mode_encrypt(out, plaintext, len, tweak, data_sched,
+				tweak_sched) == 0) {
+		TC_ERROR("XTS encryption failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	result = check_result(testnum, ciphertext, len, out, len);
+	if (result == TC_FAIL) {
+		goto exitTest;
+	}
+
+	(void)tc_aes128_set_decrypt_key(data_sched, key1);
+	if (tc_xts_mode_decrypt(out, out, len, tweak, data_sched,
+				tweak_sched) == 0) {
+		TC_ERROR("XTS decryption failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest;
+	}
+	result = check_result(testnum, plaintext, len, out, len);
+
+ exitTest:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * XTS-AES-128 test #1 (identical keys): IEEE Std 1619 vector 1 uses the same
+ * key as key1 and key2, which every XTS procedure refuses without output.
+ */
+unsigned int test_1(void)
+{
+	const uint8_t key[16] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t tweak[16] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t plaintext[32] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	uint8_t untouched[sizeof(plaintext)];
+	struct tc_aes_key_sched_struct data_sched;
+	struct tc_aes_key_sched_struct tweak_sched;
+	uint8_t out[sizeof(plaintext)];
+	unsigned int result = TC_PASS;
+
+	TC_PRINT("XTS test #1 (identical keys):\n");
+
+	(void)memset(untouched, 0xa5, sizeof(untouched));
+	(void)memcpy(out, untouched, sizeof(out));
+	(void)tc_aes128_set_encrypt_key(&tweak_sched, key);
+	(void)tc_aes128_set_encrypt_key(&data_sched, key);
+	if (tc_xts_mode_encrypt(out, plaintext, sizeof(plaintext), tweak,
+				&data_sched, &tweak_sched) != TC_CRYPTO_FAIL ||
+	    tc_xts_mode_encrypt_sectors(out, plaintext, sizeof(plaintext),
+					sizeof(plaintext), 0, &data_sched,
+					&tweak_sched) != TC_CRYPTO_FAIL) {
+		TC_ERROR("XTS encryption accepted key1 == key2 in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	(void)tc_aes128_set_decrypt_key(&data_sched, key);
+	if (tc_xts_mode_decrypt(out, plaintext, sizeof(plaintext), tweak,
+				&data_sched, &tweak_sched) != TC_CRYPTO_FAIL ||
+	    tc_xts_mode_decrypt_sectors(out, plaintext, sizeof(plaintext),
+					sizeof(plaintext), 0, &data_sched,
+					&tweak_sched) != TC_CRYPTO_FAIL) {
+		TC_ERROR("XTS decryption accepted key1 == key2 in %s.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	result = check_result(1, untouched, sizeof(untouched), out, sizeof(out));
+
+ exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * XTS-AES-128 test #2 (IEEE Std 1619 vector 2).
+ */
+unsigned int test_2(void)
+{
+	const uint8_t key1[16] = {
+		0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+		0x11, 0x11, 0x11, 0x11
+	};
+	const uint8_t key2[16] = {
+		0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+		0x22, 0x22, 0x22, 0x22
+	};
+	const uint8_t tweak[16] = {
+		0x33, 0x33, 0x33, 0x33, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t plaintext[32] = {
+		0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44,
+		0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44,
+		0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44
+	};
+	const uint8_t ciphertext[32] = {
+		0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e, 0x39, 0x33, 0x40, 0x38,
+		0xac, 0xef, 0x83, 0x8b, 0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80, 0xad, 0xc4,
+		0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0
+	};
+	struct tc_aes_key_sched_struct data_sched;
+	struct tc_aes_key_sched_struct tweak_sched;
+	uint8_t out[sizeof(plaintext)];
+
+	TC_PRINT("XTS test #2 (IEEE Std 1619 vector 2):\n");
+	return do_test(2, key1, key2, tweak, plaintext, ciphertext,
+		       sizeof(plaintext), out, &data_sched, &tweak_sched);
+}
+
+/*
+ * XTS-AES-128 test #3 (IEEE Std 1619 vector 15, ciphertext stealing).
+ */
+unsigned int test_3(void)
+{
+	const uint8_t key1[16] = {
+		0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4,
+		0xf3, 0xf2, 0xf1, 0xf0
+	};
+	const uint8_t key2[16] = {
+		0xbf, 0xbe, 0xbd, 0xbc, 0xbb, 0xba, 0xb9, 0xb8, 0xb7, 0xb6, 0xb5, 0xb4,
+		0xb3, 0xb2, 0xb1, 0xb0
+	};
+	const uint8_t tweak[16] = {
+		0x9a, 0x78, 0x56, 0x34, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t plaintext[17] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+		0x0c, 0x0d, 0x0e, 0x0f, 0x10
+	};
+	const uint8_t ciphertext[17] = {
+		0x6c, 0x16, 0x25, 0xdb, 0x46, 0x71, 0x52, 0x2d, 0x3d, 0x75, 0x99, 0x60,
+		0x1d, 0xe7, 0xca, 0x09, 0xed
+	};
+	struct tc_aes_key_sched_struct data_sched;
+	struct tc_aes_key_sched_struct tweak_sched;
+	uint8_t out[sizeof(plaintext)];
+
+	TC_PRINT("XTS test #3 (IEEE Std 1619 vector 15, ciphertext stealing):\n");
+	return do_test(3, key1, key2, tweak, plaintext, ciphertext,
+		       sizeof(plaintext), out, &data_sched, &tweak_sched);
+}
+
+/*
+ * XTS-AES-128 test #4 (31 byte data unit, ciphertext stealing).
+ */
+unsigned int test_4(void)
+{
+	const uint8_t key1[16] = {
+		0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4,
+		0xf3, 0xf2, 0xf1, 0xf0
+	};
+	const uint8_t key2[16] = {
+		0xbf, 0xbe, 0xbd, 0xbc, 0xbb, 0xba, 0xb9, 0xb8, 0xb7, 0xb6, 0xb5, 0xb4,
+		0xb3, 0xb2, 0xb1, 0xb0
+	};
+	const uint8_t tweak[16] = {
+		0x9a, 0x78, 0x56, 0x34, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	};
+	const uint8_t plaintext[31] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+		0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+		0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e
+	};
+	const uint8_t ciphertext[31] = {
+		0xd0, 0x5b, 0xc0, 0x90, 0xa8, 0xe0, 0x4f, 0x1b, 0x3d, 0x3e, 0xcd, 0xd5,
+		0xba, 0xec, 0x0f, 0xd4, 0xed, 0xbf, 0x9d, 0xac, 0xe4, 0x5d, 0x6f, 0x6a,
+		0x73, 0x06, 0xe6, 0x4b, 0xe5, 0xdd, 0x82
+	};
+	struct tc_aes_key_sched_struct data_sched;
+	struct tc_aes_key_sched_struct tweak_sched;
+	uint8_t out[sizeof(plaintext)];
+
+	TC_PRINT("XTS test #4 (31 byte data unit, ciphertext stealing):\n");
+	return do_test(4, key1, key2, tweak, plaintext, ciphertext,
+		       sizeof(plaintext), out, &data_sched, &tweak_sched);
+}
+
+/*
+ * XTS-AES-128 test #5 (multi-sector batch): a batch of sectors matches the
+ * sectors encrypted one at a time, and decrypts back in place.
+ */
+unsigned int test_5(void)
+{
+	const uint8_t key1[16] = {
+		0x27, 0x18, 0x28, 0x18, 0x28, 0x45, 0x90, 0x45, 0x23, 0x53, 0x60, 0x28,
+		0x74, 0x71, 0x35, 0x26
+	};
+	const uint8_t key2[16] = {
+		0x31, 0x41, 0x59, 0x26, 0x53, 0x58, 0x97, 0x93, 0x23, 0x84, 0x62, 0x64,
+		0x33, 0x83, 0x27, 0x95
+	};
+	const uint64_t first_sector = 0x1fffffffeULL;
+	struct tc_aes_key_sched_struct data_sched;
+	struct tc_aes_key_sched_struct tweak_sched;
+	uint8_t plaintext[NUM_SECTORS * SECTOR_SIZE];
+	uint8_t batch[NUM_SECTORS * SECTOR_SIZE];
+	uint8_t single[NUM_SECTORS * SECTOR_SIZE];
+	uint8_t tweak[TC_AES_BLOCK_SIZE];
+	unsigned int result = TC_PASS;
+	unsigned int i, j;
+
+	TC_PRINT("XTS test #5 (multi-sector batch):\n");
+
+	for (i = 0; i < sizeof(plaintext); ++i) {
+		plaintext[i] = (uint8_t) i;
+	}
+
+	(void)tc_aes128_set_encrypt_key(&tweak_sched, key2);
+	(void)tc_aes128_set_encrypt_key(&data_sched, key1);
+	if (tc_xts_mode_encrypt_sectors(batch, plaintext, sizeof(plaintext),
+					SECTOR_SIZE, first_sector, &data_sched,
+					&tweak_sched) == 0) {
+		TC_ERROR("XTS batch encryption failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+
+	for (i = 0; i < NUM_SECTORS; ++i) {
+		(void)memset(tweak, 0, sizeof(tweak));
+		for (j = 0; j < 8; ++j) {
+			tweak[j] = (uint8_t)((first_sector + i) >> (8 * j));
+		}
+		(void)tc_xts_mode_encrypt(&single[i * SECTOR_SIZE],
+					  &plaintext[i * SECTOR_SIZE],
+					  SECTOR_SIZE, tweak, &data_sched,
+					  &tweak_sched);
+	}
+	result = check_result(5, single, sizeof(single), batch, sizeof(batch));
+	if (result == TC_FAIL) {
+		goto exitTest5;
+	}
+
+	(void)tc_aes128_set_decrypt_key(&data_sched, key1);
+	if (tc_xts_mode_decrypt_sectors(batch, batch, sizeof(batch),
+					SECTOR_SIZE, first_sector, &data_sched,
+					&tweak_sched) == 0) {
+		TC_ERROR("XTS batch decryption failed in %s.\n", __func__);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+	result = check_result(5, plaintext, sizeof(plaintext),
+			      batch, sizeof(batch));
+
+ exitTest5:
+	TC_END_RESULT(result);
+	return result;
+}
+
+/*
+ * Main task to test XTS
+ */
+int main(void)
+{
+	unsigned int result = TC_PASS;
+
+	TC_START("Performing XTS-AES-128 tests:");
+
+	result = test_1();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("XTS test #1 failed.\n");
+		goto exitTest;
+	}
+	result = test_2();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("XTS test #2 failed.\n");
+		goto exitTest;
+	}
+	result = test_3();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("XTS test #3 failed.\n");
+		goto exitTest;
+	}
+	result = test_4();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("XTS test #4 failed.\n");
+		goto exitTest;
+	}
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("XTS test #5 failed.\n");
+		goto exitTest;
+	}
+
+	TC_PRINT("All XTS tests succeeded!\n");
+
+ exitTest:
+	TC_END_RESULT(result);
+	TC_END_REPORT(result);
+
+	return result;
+}